@@ -6,6 +6,7 @@ string(APPEND CMAKE_C_FLAGS_RELEASE_INIT " -DNDEBUG")
 string(APPEND CMAKE_C_FLAGS_RELWITHDEBINFO_INIT " -DNDEBUG")
 
 set(CMAKE_DEPFILE_FLAGS_C "-MD -MT <OBJECT> -MF <DEPFILE>")
+set(CMAKE_C_DEPFILE_FORMAT gcc)
 
 if("x${CMAKE_C_SIMULATE_ID}" STREQUAL "xMSVC")
 
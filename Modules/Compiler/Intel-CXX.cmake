@@ -6,6 +6,7 @@ string(APPEND CMAKE_CXX_FLAGS_RELEASE_INIT " -DNDEBUG")
 string(APPEND CMAKE_CXX_FLAGS_RELWITHDEBINFO_INIT " -DNDEBUG")
 
 set(CMAKE_DEPFILE_FLAGS_CXX "-MD -MT <OBJECT> -MF <DEPFILE>")
+set(CMAKE_CXX_DEPFILE_FORMAT gcc)
 
 if("x${CMAKE_CXX_SIMULATE_ID}" STREQUAL "xMSVC")
 
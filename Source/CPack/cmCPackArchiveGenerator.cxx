@@ -47,6 +47,20 @@ std::string cmCPackArchiveGenerator::GetArchiveComponentFileName(
   return packageFileName;
 }
 
+int cmCPackArchiveGenerator::GetThreadCount() const
+{
+  const char* threads = this->GetOption("CPACK_ARCHIVE_THREADS");
+  long n = 1;
+  if (threads && *threads &&
+      (!cmSystemTools::StringToLong(threads, &n) || n < 0 || n > 1024)) {
+    cmCPackLogger(cmCPackLog::LOG_WARNING,
+                  "CPACK_ARCHIVE_THREADS is not a number of threads: "
+                    << threads << ".  Using 1." << std::endl);
+    n = 1;
+  }
+  return static_cast<int>(n);
+}
+
 int cmCPackArchiveGenerator::InitializeInternal()
 {
   this->SetOptionIfNotSet("CPACK_INCLUDE_TOPLEVEL_DIRECTORY", "1");
@@ -110,7 +124,8 @@ int cmCPackArchiveGenerator::addOneComponentToArchive(
                     << (filename) << ">." << std::endl);                      \
     return 0;                                                                 \
   }                                                                           \
-  cmArchiveWrite archive(gf, this->Compress, this->ArchiveFormat);            \
+  cmArchiveWrite archive(gf, this->Compress, this->ArchiveFormat,             \
+                         this->GetThreadCount());                             \
   if (!(archive)) {                                                           \
     cmCPackLogger(cmCPackLog::LOG_ERROR,                                      \
                   "Problem to create archive <"                               \
@@ -39,6 +39,9 @@ private:
   std::string GetArchiveComponentFileName(const std::string& component,
                                           bool isGroupName);
 
+  // get the number of threads compressing the archive
+  int GetThreadCount() const;
+
 protected:
   int InitializeInternal() override;
   /**
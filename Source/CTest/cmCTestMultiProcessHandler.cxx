@@ -20,7 +20,6 @@
 #include <chrono>
 #include <cstring>
 #include <iomanip>
-#include <list>
 #include <math.h>
 #include <sstream>
 #include <stack>
@@ -75,6 +74,9 @@ void cmCTestMultiProcessHandler::SetTests(TestMap& tests,
   for (auto const& t : this->Tests) {
     this->TestRunningMap[t.first] = false;
     this->TestFinishMap[t.first] = false;
+    for (int d : t.second) {
+      this->Dependents[d].insert(t.first);
+    }
   }
   if (!this->CTest->GetShowOnly()) {
     this->ReadCostData();
@@ -117,6 +119,7 @@ void cmCTestMultiProcessHandler::RunTests()
   cmUVSignalHackRAII hackRAII;
 #endif
   this->TestHandler->SetMaxIndex(this->FindMaxIndex());
+  this->InitializeReadyTests();
 
   uv_loop_init(&this->Loop);
   this->StartNextTests();
@@ -235,8 +238,32 @@ void cmCTestMultiProcessHandler::UnlockResources(int index)
 void cmCTestMultiProcessHandler::EraseTest(int test)
 {
   this->Tests.erase(test);
-  this->SortedTests.erase(
-    std::find(this->SortedTests.begin(), this->SortedTests.end(), test));
+  std::map<int, size_t>::const_iterator rank = this->TestRanks.find(test);
+  if (rank != this->TestRanks.end()) {
+    this->ReadyTests.erase(std::make_pair(rank->second, test));
+  }
+}
+
+void cmCTestMultiProcessHandler::InitializeReadyTests()
+{
+  this->TestRanks.clear();
+  this->ReadyTests.clear();
+  for (size_t i = 0; i < this->SortedTests.size(); ++i) {
+    this->TestRanks[this->SortedTests[i]] = i;
+  }
+  for (auto const& t : this->Tests) {
+    if (t.second.empty()) {
+      this->QueueReadyTest(t.first);
+    }
+  }
+}
+
+void cmCTestMultiProcessHandler::QueueReadyTest(int test)
+{
+  std::map<int, size_t>::const_iterator rank = this->TestRanks.find(test);
+  if (rank != this->TestRanks.end()) {
+    this->ReadyTests.insert(std::make_pair(rank->second, test));
+  }
 }
 
 inline size_t cmCTestMultiProcessHandler::GetProcessorsUsed(int test)
@@ -343,8 +370,15 @@ void cmCTestMultiProcessHandler::StartNextTests()
     }
   }
 
-  TestList copy = this->SortedTests;
-  for (auto const& test : copy) {
+  // Walk the tests that are ready to run in order of priority.  Starting
+  // a test removes it from the queue, and a test that finishes without
+  // starting may queue its dependents, so look up the next entry after
+  // each one instead of keeping an iterator.
+  std::pair<size_t, int> current;
+  for (auto ready = this->ReadyTests.begin(); ready != this->ReadyTests.end();
+       ready = this->ReadyTests.upper_bound(current)) {
+    current = *ready;
+    int const test = current.second;
     // Take a nap if we're currently performing a RUN_SERIAL test.
     if (this->SerialTestRunning) {
       break;
@@ -384,8 +418,8 @@ void cmCTestMultiProcessHandler::StartNextTests()
     // Find out whether there are any non RUN_SERIAL tests left, so that the
     // correct warning may be displayed.
     bool onlyRunSerialTestsLeft = true;
-    for (auto const& test : copy) {
-      if (!this->Properties[test]->RunSerial) {
+    for (auto const& test : this->Tests) {
+      if (!this->Properties[test.first]->RunSerial) {
         onlyRunSerialTestsLeft = false;
       }
     }
@@ -452,8 +486,12 @@ void cmCTestMultiProcessHandler::FinishTestProcess(cmCTestRunTest* runner,
     this->Failed->push_back(properties->Name);
   }
 
-  for (auto& t : this->Tests) {
-    t.second.erase(test);
+  for (int d : this->Dependents[test]) {
+    TestMap::iterator dependent = this->Tests.find(d);
+    if (dependent != this->Tests.end() && dependent->second.erase(test) &&
+        dependent->second.empty()) {
+      this->QueueReadyTest(d);
+    }
   }
 
   this->TestFinishMap[test] = true;
@@ -476,13 +514,22 @@ void cmCTestMultiProcessHandler::FinishTestProcess(cmCTestRunTest* runner,
 void cmCTestMultiProcessHandler::UpdateCostData()
 {
   std::string fname = this->CTest->GetCostDataFile();
+  bool const shard = this->CTest->GetShardCount() > 0;
+  if (shard) {
+    // A shard records only its own measurements, next to the cost data
+    // file, so that concurrently running shards keep partitioning the
+    // tests by the same data.  "ctest --merge-results" folds them in.
+    fname = cmSystemTools::GetFilenamePath(fname) + "/CTestCostData_" +
+      std::to_string(this->CTest->GetShardIndex()) + ".txt";
+  }
   std::string tmpout = fname + ".tmp";
   cmsys::ofstream fout;
   fout.open(tmpout.c_str());
 
   PropertiesMap temp = this->Properties;
+  std::map<std::string, int> const indexByName = this->GetTestIndexByName();
 
-  if (cmSystemTools::FileExists(fname)) {
+  if (!shard && cmSystemTools::FileExists(fname)) {
     cmsys::ifstream fin;
     fin.open(fname.c_str());
 
@@ -501,11 +548,13 @@ void cmCTestMultiProcessHandler::UpdateCostData()
       int prev = atoi(parts[1].c_str());
       float cost = static_cast<float>(atof(parts[2].c_str()));
 
-      int index = this->SearchByName(name);
-      if (index == -1) {
+      std::map<std::string, int>::const_iterator found =
+        indexByName.find(name);
+      if (found == indexByName.end()) {
         // This test is not in memory. We just rewrite the entry
         fout << name << " " << prev << " " << cost << "\n";
       } else {
+        int index = found->second;
         // Update with our new average cost
         fout << name << " " << this->Properties[index]->PreviousRuns << " "
              << this->Properties[index]->Cost << "\n";
@@ -536,6 +585,8 @@ void cmCTestMultiProcessHandler::ReadCostData()
   std::string fname = this->CTest->GetCostDataFile();
 
   if (cmSystemTools::FileExists(fname, true)) {
+    std::map<std::string, int> const indexByName =
+      this->GetTestIndexByName();
     cmsys::ifstream fin;
     fin.open(fname.c_str());
     std::string line;
@@ -556,10 +607,12 @@ void cmCTestMultiProcessHandler::ReadCostData()
       int prev = atoi(parts[1].c_str());
       float cost = static_cast<float>(atof(parts[2].c_str()));
 
-      int index = this->SearchByName(name);
-      if (index == -1) {
+      std::map<std::string, int>::const_iterator found =
+        indexByName.find(name);
+      if (found == indexByName.end()) {
         continue;
       }
+      int index = found->second;
 
       this->Properties[index]->PreviousRuns = prev;
       // When not running in parallel mode, don't use cost data
@@ -578,16 +631,14 @@ void cmCTestMultiProcessHandler::ReadCostData()
   }
 }
 
-int cmCTestMultiProcessHandler::SearchByName(std::string const& name)
+std::map<std::string, int> cmCTestMultiProcessHandler::GetTestIndexByName()
 {
-  int index = -1;
-
+  // Later tests win over earlier ones with the same name.
+  std::map<std::string, int> indexByName;
   for (auto const& p : this->Properties) {
-    if (p.second->Name == name) {
-      index = p.first;
-    }
+    indexByName[p.second->Name] = p.first;
   }
-  return index;
+  return indexByName;
 }
 
 void cmCTestMultiProcessHandler::CreateTestCostList()
@@ -603,12 +654,8 @@ void cmCTestMultiProcessHandler::CreateParallelTestCostList()
 {
   TestSet alreadySortedTests;
 
-  std::list<TestSet> priorityStack;
-  priorityStack.emplace_back();
-  TestSet& topLevel = priorityStack.back();
-
   // In parallel test runs add previously failed tests to the front
-  // of the cost list and queue other tests for further sorting
+  // of the cost list
   for (auto const& t : this->Tests) {
     if (std::find(this->LastTestsFailed.begin(), this->LastTestsFailed.end(),
                   this->Properties[t.first]->Name) !=
@@ -616,52 +663,75 @@ void cmCTestMultiProcessHandler::CreateParallelTestCostList()
       // If the test failed last time, it should be run first.
       this->SortedTests.push_back(t.first);
       alreadySortedTests.insert(t.first);
-    } else {
-      topLevel.insert(t.first);
     }
   }
 
-  // In parallel test runs repeatedly move dependencies of the tests on
-  // the current dependency level to the next level until no
-  // further dependencies exist.
-  while (!priorityStack.back().empty()) {
-    TestSet& previousSet = priorityStack.back();
-    priorityStack.emplace_back();
-    TestSet& currentSet = priorityStack.back();
-
-    for (auto const& i : previousSet) {
-      TestSet const& dependencies = this->Tests[i];
-      currentSet.insert(dependencies.begin(), dependencies.end());
-    }
-
-    for (auto const& i : currentSet) {
-      previousSet.erase(i);
+  // Compute the critical path of each test: its own COST plus the
+  // largest critical path among the tests depending on it.  Visit the
+  // tests in reverse dependency order, starting with those on which no
+  // other test depends.
+  struct CriticalPath
+  {
+    double Cost = 0;
+    size_t Length = 0;
+  };
+  std::map<int, CriticalPath> paths;
+  std::map<int, size_t> pendingDependents;
+  std::vector<int> queue;
+  for (auto const& t : this->Tests) {
+    size_t const count = this->Dependents[t.first].size();
+    pendingDependents[t.first] = count;
+    if (count == 0) {
+      queue.push_back(t.first);
+    }
+  }
+  while (!queue.empty()) {
+    int const test = queue.back();
+    queue.pop_back();
+    CriticalPath path;
+    for (int d : this->Dependents[test]) {
+      CriticalPath const& dp = paths[d];
+      if (dp.Cost > path.Cost ||
+          (dp.Cost == path.Cost && dp.Length > path.Length)) {
+        path = dp;
+      }
     }
-  }
-
-  // Remove the empty dependency level
-  priorityStack.pop_back();
-
-  // Reverse iterate over the different dependency levels (deepest first).
-  // Sort tests within each level by COST and append them to the cost list.
-  for (std::list<TestSet>::reverse_iterator i = priorityStack.rbegin();
-       i != priorityStack.rend(); ++i) {
-    TestSet const& currentSet = *i;
-    TestComparator comp(this);
-
-    TestList sortedCopy;
-
-    sortedCopy.insert(sortedCopy.end(), currentSet.begin(), currentSet.end());
-
-    std::stable_sort(sortedCopy.begin(), sortedCopy.end(), comp);
-
-    for (auto const& j : sortedCopy) {
-      if (alreadySortedTests.find(j) == alreadySortedTests.end()) {
-        this->SortedTests.push_back(j);
-        alreadySortedTests.insert(j);
+    // Negative costs only order tests, they do not shorten paths.
+    path.Cost += std::max(this->Properties[test]->Cost, 0.0f);
+    path.Length += 1;
+    paths[test] = path;
+    for (int d : this->Tests[test]) {
+      if (--pendingDependents[d] == 0) {
+        queue.push_back(d);
       }
     }
   }
+
+  // Start the longest chains first.  Break ties by chain length so
+  // dependencies still come before their dependents when no timing
+  // data exist, then by COST so the order of independent tests is
+  // unchanged.
+  TestList sortedCopy;
+  for (auto const& t : this->Tests) {
+    if (alreadySortedTests.find(t.first) == alreadySortedTests.end()) {
+      sortedCopy.push_back(t.first);
+    }
+  }
+  std::stable_sort(sortedCopy.begin(), sortedCopy.end(),
+                   [this, &paths](int l, int r) -> bool {
+                     CriticalPath const& lp = paths[l];
+                     CriticalPath const& rp = paths[r];
+                     if (lp.Cost != rp.Cost) {
+                       return lp.Cost > rp.Cost;
+                     }
+                     if (lp.Length != rp.Length) {
+                       return lp.Length > rp.Length;
+                     }
+                     return this->Properties[l]->Cost >
+                       this->Properties[r]->Cost;
+                   });
+  this->SortedTests.insert(this->SortedTests.end(), sortedCopy.begin(),
+                           sortedCopy.end());
 }
 
 void cmCTestMultiProcessHandler::GetAllTestDependencies(int test,
@@ -859,29 +929,44 @@ bool cmCTestMultiProcessHandler::CheckCycles()
   cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                      "Checking test dependency graph..." << std::endl,
                      this->Quiet);
+  // Depth first search visiting every test once.  A dependency on a
+  // test still on the stack closes a cycle.
+  enum VisitState
+  {
+    Unvisited,
+    OnStack,
+    Done
+  };
+  std::map<int, VisitState> state;
   for (auto const& it : this->Tests) {
-    // DFS from each element to itself
-    int root = it.first;
-    std::set<int> visited;
-    std::stack<int> s;
-    s.push(root);
+    if (state[it.first] != Unvisited) {
+      continue;
+    }
+    std::stack<std::pair<int, TestSet::const_iterator>> s;
+    state[it.first] = OnStack;
+    s.push(std::make_pair(it.first, this->Tests[it.first].cbegin()));
     while (!s.empty()) {
-      int test = s.top();
-      s.pop();
-      if (visited.insert(test).second) {
-        for (auto const& d : this->Tests[test]) {
-          if (d == root) {
-            // cycle exists
-            cmCTestLog(
-              this->CTest, ERROR_MESSAGE,
-              "Error: a cycle exists in the test dependency graph "
-              "for the test \""
-                << this->Properties[root]->Name
-                << "\".\nPlease fix the cycle and run ctest again.\n");
-            return false;
-          }
-          s.push(d);
-        }
+      int const test = s.top().first;
+      TestSet::const_iterator& next = s.top().second;
+      if (next == this->Tests[test].cend()) {
+        state[test] = Done;
+        s.pop();
+        continue;
+      }
+      int const d = *next++;
+      VisitState& ds = state[d];
+      if (ds == OnStack) {
+        // cycle exists
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+                   "Error: a cycle exists in the test dependency graph "
+                   "for the test \""
+                     << this->Properties[d]->Name
+                     << "\".\nPlease fix the cycle and run ctest again.\n");
+        return false;
+      }
+      if (ds == Unvisited) {
+        ds = OnStack;
+        s.push(std::make_pair(d, this->Tests[d].cbegin()));
       }
     }
   }
@@ -10,6 +10,7 @@
 #include <set>
 #include <stddef.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cmUVHandlePtr.h"
@@ -87,10 +88,14 @@ protected:
 
   void UpdateCostData();
   void ReadCostData();
-  // Return index of a test based on its name
-  int SearchByName(std::string const& name);
+  // Return the index of each test by name
+  std::map<std::string, int> GetTestIndexByName();
 
   void CreateTestCostList();
+  // Rank tests by their position in the cost list and queue the tests
+  // without pending dependencies
+  void InitializeReadyTests();
+  void QueueReadyTest(int test);
 
   void GetAllTestDependencies(int test, TestList& dependencies);
   void CreateSerialTestCostList();
@@ -120,7 +125,14 @@ protected:
   void UnlockResources(int index);
   // map from test number to set of depend tests
   TestMap Tests;
+  // map from test number to set of tests depending on it
+  TestMap Dependents;
   TestList SortedTests;
+  // position of each test in SortedTests
+  std::map<int, size_t> TestRanks;
+  // tests not yet started whose dependencies have all finished,
+  // ordered by rank
+  std::set<std::pair<size_t, int>> ReadyTests;
   // Total number of tests we'll be running
   size_t Total;
   // Number of tests that are complete
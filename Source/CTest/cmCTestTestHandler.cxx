@@ -10,12 +10,14 @@
 #include <functional>
 #include <iomanip>
 #include <iterator>
+#include <map>
 #include <memory> // IWYU pragma: keep
 #include <set>
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <utility>
 
 #include "cmAlgorithms.h"
 #include "cmCTest.h"
@@ -824,6 +826,7 @@ void cmCTestTestHandler::ComputeTestList()
   }
 
   UpdateForFixtures(finalList);
+  this->SelectShard(finalList);
 
   // Save the total number of tests before exclusions
   this->TotalNumberOfTests = this->TestList.size();
@@ -854,6 +857,7 @@ void cmCTestTestHandler::ComputeTestListForRerunFailed()
   }
 
   UpdateForFixtures(finalList);
+  this->SelectShard(finalList);
 
   // Save the total number of tests before exclusions
   this->TotalNumberOfTests = this->TestList.size();
@@ -1104,6 +1108,414 @@ void cmCTestTestHandler::UpdateForFixtures(ListOfTests& tests) const
                      this->Quiet);
 }
 
+namespace {
+// Contents of a CTestCostData.txt file: "<name> <runs> <cost>" lines
+// followed by "---" and the names of the tests that failed.
+struct cmCTestCostData
+{
+  std::vector<std::string> Names;
+  std::map<std::string, std::vector<std::string>> Entries;
+  std::vector<std::string> Failed;
+};
+
+bool ReadCostDataFile(std::string const& fname, cmCTestCostData& data)
+{
+  cmsys::ifstream fin(fname.c_str());
+  if (!fin) {
+    return false;
+  }
+  std::string line;
+  bool failedSection = false;
+  while (std::getline(fin, line)) {
+    if (failedSection) {
+      if (!line.empty()) {
+        data.Failed.push_back(line);
+      }
+      continue;
+    }
+    if (line == "---") {
+      failedSection = true;
+      continue;
+    }
+    std::vector<std::string> parts = cmSystemTools::SplitString(line, ' ');
+    if (parts.size() < 3) {
+      break;
+    }
+    if (data.Entries.find(parts[0]) == data.Entries.end()) {
+      data.Names.push_back(parts[0]);
+    }
+    data.Entries[parts[0]] = parts;
+  }
+  return true;
+}
+
+size_t FindShardGroup(std::vector<size_t>& parent, size_t i)
+{
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+void UniteShardGroups(std::vector<size_t>& parent, size_t a, size_t b)
+{
+  a = FindShardGroup(parent, a);
+  b = FindShardGroup(parent, b);
+  // The group representative is always its first test so that the
+  // partition only depends on the order of the test list.
+  if (a < b) {
+    parent[b] = a;
+  } else if (b < a) {
+    parent[a] = b;
+  }
+}
+}
+
+void cmCTestTestHandler::SelectShard(ListOfTests& tests) const
+{
+  int const shardCount = this->CTest->GetShardCount();
+  if (shardCount < 1 || tests.empty()) {
+    return;
+  }
+  size_t const numTests = tests.size();
+
+  // Tests connected through DEPENDS or a fixture form one group.
+  std::vector<size_t> parent(numTests);
+  std::map<std::string, size_t> testByName;
+  for (size_t i = 0; i < numTests; ++i) {
+    parent[i] = i;
+    testByName[tests[i].Name] = i;
+  }
+  std::map<std::string, size_t> testByFixture;
+  for (size_t i = 0; i < numTests; ++i) {
+    cmCTestTestProperties const& p = tests[i];
+    for (std::string const& dep : p.Depends) {
+      std::map<std::string, size_t>::const_iterator found =
+        testByName.find(dep);
+      if (found != testByName.end()) {
+        UniteShardGroups(parent, i, found->second);
+      }
+    }
+    for (std::set<std::string> const* fixtures :
+         { &p.FixturesSetup, &p.FixturesCleanup, &p.FixturesRequired }) {
+      for (std::string const& fixture : *fixtures) {
+        std::map<std::string, size_t>::const_iterator found =
+          testByFixture.insert(std::make_pair(fixture, i)).first;
+        UniteShardGroups(parent, i, found->second);
+      }
+    }
+  }
+
+  // Estimate each test's cost from the recorded average run times,
+  // falling back to the COST property and then to the mean known cost.
+  cmCTestCostData costData;
+  ReadCostDataFile(this->CTest->GetCostDataFile(), costData);
+  std::vector<double> costs(numTests, 0.0);
+  double knownCost = 0.0;
+  size_t numKnown = 0;
+  for (size_t i = 0; i < numTests; ++i) {
+    std::map<std::string, std::vector<std::string>>::const_iterator found =
+      costData.Entries.find(tests[i].Name);
+    if (found != costData.Entries.end()) {
+      costs[i] = atof(found->second[2].c_str());
+    } else {
+      costs[i] = tests[i].Cost;
+    }
+    if (costs[i] > 0) {
+      knownCost += costs[i];
+      ++numKnown;
+    }
+  }
+  double const defaultCost = numKnown ? knownCost / numKnown : 1.0;
+  std::map<size_t, double> groupCosts;
+  for (size_t i = 0; i < numTests; ++i) {
+    groupCosts[FindShardGroup(parent, i)] +=
+      costs[i] > 0 ? costs[i] : defaultCost;
+  }
+
+  // Assign the most expensive groups first, each to the least loaded
+  // shard.  Ties are broken by position so every shard computes the
+  // same partition from the same test list and cost data.
+  std::vector<std::pair<double, size_t>> order;
+  order.reserve(groupCosts.size());
+  for (auto const& gc : groupCosts) {
+    order.emplace_back(gc.second, gc.first);
+  }
+  std::sort(order.begin(), order.end(),
+            [](std::pair<double, size_t> const& l,
+               std::pair<double, size_t> const& r) {
+              return l.first != r.first ? l.first > r.first
+                                        : l.second < r.second;
+            });
+  std::vector<double> loads(shardCount, 0.0);
+  std::map<size_t, int> shardOfGroup;
+  for (auto const& group : order) {
+    int const shard = static_cast<int>(
+      std::min_element(loads.begin(), loads.end()) - loads.begin());
+    loads[shard] += group.first;
+    shardOfGroup[group.second] = shard;
+  }
+
+  int const selected = this->CTest->GetShardIndex() - 1;
+  ListOfTests shardList;
+  for (size_t i = 0; i < numTests; ++i) {
+    if (shardOfGroup[FindShardGroup(parent, i)] == selected) {
+      shardList.push_back(tests[i]);
+    }
+  }
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                     "Shard " << selected + 1 << "/" << shardCount
+                              << " selected " << shardList.size() << " of "
+                              << numTests << " tests" << std::endl,
+                     this->Quiet);
+  tests.swap(shardList);
+}
+
+namespace {
+// The pieces of a Test.xml file that are combined when merging shards.
+struct cmCTestTestXMLParts
+{
+  std::string Head;      // everything up to and including "<TestList>"
+  std::string List;      // the <Test> names of the test list
+  std::string ListClose; // the indented "</TestList>"
+  std::string Results;   // the <Test> result elements
+  std::string Tail;      // from <EndDateTime> to the end
+  long EndTime;
+};
+
+bool SplitTestXML(std::string const& xml, cmCTestTestXMLParts& parts)
+{
+  std::string::size_type const listBegin = xml.find("<TestList");
+  std::string::size_type const listOpenEnd = xml.find('>', listBegin);
+  if (listBegin == std::string::npos || listOpenEnd == std::string::npos) {
+    return false;
+  }
+  std::string::size_type const lineBegin = xml.rfind('\n', listBegin) + 1;
+  std::string const indent = xml.substr(lineBegin, listBegin - lineBegin);
+  parts.Head = xml.substr(0, listBegin) + "<TestList>\n";
+  parts.ListClose = indent + "</TestList>\n";
+
+  std::string::size_type resultsBegin;
+  if (xml[listOpenEnd - 1] == '/') {
+    parts.List.clear();
+    resultsBegin = xml.find('\n', listOpenEnd);
+  } else {
+    std::string::size_type const listEnd =
+      xml.find("</TestList>", listOpenEnd);
+    if (listEnd == std::string::npos) {
+      return false;
+    }
+    std::string::size_type const listBodyBegin =
+      xml.find('\n', listOpenEnd) + 1;
+    std::string::size_type const listBodyEnd = xml.rfind('\n', listEnd) + 1;
+    parts.List = listBodyEnd > listBodyBegin
+      ? xml.substr(listBodyBegin, listBodyEnd - listBodyBegin)
+      : std::string();
+    resultsBegin = xml.find('\n', listEnd);
+  }
+  std::string::size_type const endBegin =
+    xml.find("<EndDateTime>", resultsBegin);
+  if (resultsBegin == std::string::npos || endBegin == std::string::npos) {
+    return false;
+  }
+  ++resultsBegin;
+  std::string::size_type const tailBegin = xml.rfind('\n', endBegin) + 1;
+  parts.Results = xml.substr(resultsBegin, tailBegin - resultsBegin);
+  parts.Tail = xml.substr(tailBegin);
+  std::string::size_type const endTime = parts.Tail.find("<EndTestTime>");
+  parts.EndTime = endTime == std::string::npos
+    ? 0
+    : atol(parts.Tail.c_str() + endTime + strlen("<EndTestTime>"));
+  return true;
+}
+
+std::string ReadTestingTag(std::string const& dir)
+{
+  std::string tag;
+  cmsys::ifstream fin((dir + "/Testing/TAG").c_str());
+  if (fin) {
+    cmSystemTools::GetLineFromStream(fin, tag);
+  }
+  return tag;
+}
+
+bool AppendFileContents(std::string const& fname, std::string& out)
+{
+  cmsys::ifstream fin(fname.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  std::ostringstream content;
+  content << fin.rdbuf();
+  out += content.str();
+  return true;
+}
+}
+
+int cmCTestTestHandler::MergeShardResults(
+  std::string const& outputDir, std::vector<std::string> const& inputDirs)
+{
+  std::vector<std::string> dirs;
+  for (std::string const& dir : inputDirs) {
+    dirs.push_back(cmSystemTools::CollapseFullPath(dir));
+  }
+  if (dirs.empty()) {
+    dirs.push_back(outputDir);
+  }
+
+  // Results are merged into the current tag of the output tree, or the
+  // tag of the first input when the output tree has not been tested.
+  std::string tag = ReadTestingTag(outputDir);
+  for (std::vector<std::string>::const_iterator d = dirs.begin();
+       tag.empty() && d != dirs.end(); ++d) {
+    tag = ReadTestingTag(*d);
+    if (!tag.empty()) {
+      cmSystemTools::MakeDirectory(outputDir + "/Testing");
+      cmSystemTools::CopyAFile(*d + "/Testing/TAG",
+                               outputDir + "/Testing/TAG");
+    }
+  }
+  std::string const tagSuffix = tag.empty() ? "" : "_" + tag;
+
+  std::string log;
+  std::string failedLog;
+  std::vector<cmCTestTestXMLParts> xmlParts;
+  cmCTestCostData costData;
+  std::set<std::string> shardTests;
+  std::vector<std::string> shardFailed;
+  int numShards = 0;
+  for (std::string const& dir : dirs) {
+    std::string const dirTag = ReadTestingTag(dir);
+    std::string const temporary = dir + "/Testing/Temporary";
+    cmsys::RegularExpression logRegex("^LastTest_([0-9]+)" +
+                                      (dirTag.empty() ? "" : "_" + dirTag) +
+                                      "\\.log$");
+    std::vector<int> indices;
+    cmsys::Directory directory;
+    if (directory.Load(temporary)) {
+      for (unsigned long i = 0; i < directory.GetNumberOfFiles(); ++i) {
+        if (logRegex.find(directory.GetFile(i))) {
+          indices.push_back(atoi(logRegex.match(1).c_str()));
+        }
+      }
+    }
+    std::sort(indices.begin(), indices.end());
+
+    for (int index : indices) {
+      std::string const shard = "_" + std::to_string(index);
+      std::string const suffix =
+        shard + (dirTag.empty() ? "" : "_" + dirTag) + ".log";
+      ++numShards;
+      AppendFileContents(temporary + "/LastTest" + suffix, log);
+      AppendFileContents(temporary + "/LastTestsFailed" + suffix, failedLog);
+
+      std::string xml;
+      if (!dirTag.empty() &&
+          AppendFileContents(dir + "/Testing/" + dirTag + "/Test" + shard +
+                               ".xml",
+                             xml)) {
+        cmCTestTestXMLParts parts;
+        if (!SplitTestXML(xml, parts)) {
+          cmCTestLog(this->CTest, ERROR_MESSAGE,
+                     "Cannot parse test results in "
+                       << dir << "/Testing/" << dirTag << "/Test" << shard
+                       << ".xml" << std::endl);
+          return 1;
+        }
+        xmlParts.push_back(parts);
+      }
+
+      cmCTestCostData shardCost;
+      if (ReadCostDataFile(temporary + "/CTestCostData" + shard + ".txt",
+                           shardCost)) {
+        for (std::string const& name : shardCost.Names) {
+          if (costData.Entries.find(name) == costData.Entries.end()) {
+            costData.Names.push_back(name);
+          }
+          costData.Entries[name] = shardCost.Entries[name];
+          shardTests.insert(name);
+        }
+        shardFailed.insert(shardFailed.end(), shardCost.Failed.begin(),
+                           shardCost.Failed.end());
+      }
+    }
+  }
+
+  if (numShards == 0) {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+               "No shard results found to merge." << std::endl);
+    return 1;
+  }
+
+  std::string const temporary = outputDir + "/Testing/Temporary";
+  cmSystemTools::MakeDirectory(temporary);
+  {
+    cmGeneratedFileStream fout(
+      (temporary + "/LastTest" + tagSuffix + ".log").c_str());
+    fout << log;
+  }
+  std::string const failedName =
+    temporary + "/LastTestsFailed" + tagSuffix + ".log";
+  if (failedLog.empty()) {
+    cmSystemTools::RemoveFile(failedName);
+  } else {
+    cmGeneratedFileStream fout(failedName.c_str());
+    fout << failedLog;
+  }
+
+  if (!xmlParts.empty()) {
+    cmCTestTestXMLParts const* last = &xmlParts.front();
+    for (cmCTestTestXMLParts const& parts : xmlParts) {
+      if (parts.EndTime > last->EndTime) {
+        last = &parts;
+      }
+    }
+    std::string const xmlName = outputDir + "/Testing/" + tag + "/Test.xml";
+    cmSystemTools::MakeDirectory(outputDir + "/Testing/" + tag);
+    cmGeneratedFileStream fout(xmlName.c_str());
+    fout << xmlParts.front().Head;
+    for (cmCTestTestXMLParts const& parts : xmlParts) {
+      fout << parts.List;
+    }
+    fout << xmlParts.front().ListClose;
+    for (cmCTestTestXMLParts const& parts : xmlParts) {
+      fout << parts.Results;
+    }
+    fout << last->Tail;
+  }
+
+  if (!shardTests.empty()) {
+    // Fold the measured costs into the cost data used by later runs.
+    std::string const fname = temporary + "/CTestCostData.txt";
+    cmCTestCostData merged;
+    ReadCostDataFile(fname, merged);
+    cmGeneratedFileStream fout(fname.c_str());
+    for (std::string const& name : merged.Names) {
+      if (shardTests.find(name) == shardTests.end()) {
+        fout << cmJoin(merged.Entries[name], " ") << "\n";
+      }
+    }
+    for (std::string const& name : costData.Names) {
+      fout << cmJoin(costData.Entries[name], " ") << "\n";
+    }
+    fout << "---\n";
+    for (std::string const& name : merged.Failed) {
+      if (shardTests.find(name) == shardTests.end()) {
+        fout << name << "\n";
+      }
+    }
+    for (std::string const& name : shardFailed) {
+      fout << name << "\n";
+    }
+  }
+
+  cmCTestLog(this->CTest, HANDLER_OUTPUT,
+             "Merged the results of " << numShards << " shards into "
+                                      << outputDir << std::endl);
+  return 0;
+}
+
 void cmCTestTestHandler::UpdateMaxTestNameWidth()
 {
   std::string::size_type max = this->CTest->GetMaxTestNameWidth();
@@ -184,6 +184,15 @@ public:
 
   typedef std::vector<cmCTestTestProperties> ListOfTests;
 
+  /**
+   * Merge the Test.xml, LastTest.log, LastTestsFailed.log and cost data
+   * written by "ctest --shard" runs in the given build trees into the
+   * corresponding files of outputDir.  With no input directories the
+   * shard results already present in outputDir are merged.
+   */
+  int MergeShardResults(std::string const& outputDir,
+                        std::vector<std::string> const& inputDirs);
+
 protected:
   // compute a final test list
   virtual int PreProcessHandler();
@@ -262,6 +271,10 @@ private:
   // tests to account for fixture setup/cleanup
   void UpdateForFixtures(ListOfTests& tests) const;
 
+  // keep only the tests of the shard selected by --shard; tests tied
+  // together by dependencies or fixtures always stay in one shard
+  void SelectShard(ListOfTests& tests) const;
+
   void UpdateMaxTestNameWidth();
 
   bool GetValue(const char* tag, std::string& value, std::istream& fin);
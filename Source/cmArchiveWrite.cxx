@@ -6,13 +6,30 @@
 #include "cmSystemTools.h"
 #include "cm_get_date.h"
 #include "cm_libarchive.h"
+#include "cm_zlib.h"
 #include "cmsys/Directory.hxx"
 #include "cmsys/Encoding.hxx"
 #include "cmsys/FStream.hxx"
+#include "cmsys/SystemInformation.hxx"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string.h>
+#include <thread>
 #include <time.h>
+#include <utility>
+#include <vector>
+
+// With its own libarchive CMake also links its liblzma, whose block
+// encoder is used directly.  Otherwise libarchive's own multithreaded
+// xz encoder is used if it has one.
+#if !defined(CMAKE_USE_SYSTEM_LIBARCHIVE)
+#  define CM_ARCHIVE_WRITE_XZ_BLOCKS
+#  include "cm_lzma.h"
+#endif
 
 #ifndef __LA_SSIZE_T
 #  define __LA_SSIZE_T la_ssize_t
@@ -57,29 +74,486 @@ public:
   operator struct archive_entry*() { return this->Object; }
 };
 
+/** \class cmArchiveWrite::BlockCompressor
+ * \brief Compress the archive data in blocks on worker threads.
+ *
+ * The data written by libarchive are split in blocks of a fixed size
+ * that are compressed independently and written in order, so the
+ * output depends only on the data.  Gzip blocks are raw deflate
+ * streams primed with the end of the previous block and ended by a
+ * sync flush, which together form a single gzip member.  Xz blocks
+ * form a single xz stream like the one written by "xz --threads".
+ */
+class cmArchiveWrite::BlockCompressor
+{
+public:
+  BlockCompressor(std::ostream& os, Compress c, unsigned int threads);
+  ~BlockCompressor();
+
+  bool Write(const char* data, size_t n);
+  bool Finish();
+  std::string const& GetError() const { return this->Error; }
+
+private:
+  struct Block
+  {
+    std::string Dictionary;
+    std::string Input;
+    std::string Output;
+    unsigned long Crc;
+    unsigned long long UnpaddedSize;
+    bool Last;
+    bool Done;
+    bool Failed;
+  };
+
+  bool Start();
+  void Submit(bool last);
+  bool WriteDone(std::unique_lock<std::mutex>& lock, size_t keep);
+  bool WriteBlock(Block const& b);
+  bool WriteOutput(const void* data, size_t n);
+  void Run();
+  static bool DeflateBlock(Block& b);
+#ifdef CM_ARCHIVE_WRITE_XZ_BLOCKS
+  bool EncodeXZBlock(Block& b) const;
+#endif
+
+  std::ostream& Stream;
+  Compress Method;
+  size_t BlockSize;
+  std::string Input;
+  std::string Dictionary;
+  std::string Error;
+  bool Started;
+  bool Finished;
+
+  // Checksum and size of the data of the gzip member.
+  unsigned long Crc;
+  unsigned long Size;
+
+#ifdef CM_ARCHIVE_WRITE_XZ_BLOCKS
+  lzma_options_lzma LzmaOptions;
+  lzma_index* Index;
+#endif
+
+  // Blocks in output order, of which the ones in Queue wait for a
+  // worker.  Only the main thread writes the output.
+  std::mutex Mutex;
+  std::condition_variable JobReady;
+  std::condition_variable JobDone;
+  std::deque<std::unique_ptr<Block>> Blocks;
+  std::deque<Block*> Queue;
+  std::vector<std::thread> Workers;
+  bool Stop;
+};
+
+// Deflate primes each block with up to 32 KiB of the previous one.
+static size_t const cmArchiveWriteGZipWindow = 32768;
+
+cmArchiveWrite::BlockCompressor::BlockCompressor(std::ostream& os,
+                                                 Compress c,
+                                                 unsigned int threads)
+  : Stream(os)
+  , Method(c)
+  , BlockSize(1 << 20)
+  , Started(false)
+  , Finished(false)
+  , Crc(crc32(0L, Z_NULL, 0))
+  , Size(0)
+  , Stop(false)
+{
+#ifdef CM_ARCHIVE_WRITE_XZ_BLOCKS
+  this->Index = nullptr;
+  if (this->Method == CompressXZ) {
+    // Use the default preset of libarchive and the block size of the
+    // multithreaded encoder of liblzma.
+    lzma_lzma_preset(&this->LzmaOptions, LZMA_PRESET_DEFAULT);
+    this->BlockSize = 3 * static_cast<size_t>(this->LzmaOptions.dict_size);
+    this->Index = lzma_index_init(nullptr);
+    if (!this->Index) {
+      this->Error = "lzma_index_init: out of memory";
+    }
+  }
+#endif
+
+  // Each worker needs its encoder state and holds up to two blocks in
+  // flight, each with its input and output.  Like "xz --threads", use
+  // fewer threads if they would need more than a quarter of the
+  // physical memory.  The output does not depend on their number.
+  unsigned long long state = 256 << 10; // deflate with default settings
+#ifdef CM_ARCHIVE_WRITE_XZ_BLOCKS
+  if (this->Method == CompressXZ) {
+    lzma_filter filters[2];
+    filters[0].id = LZMA_FILTER_LZMA2;
+    filters[0].options = &this->LzmaOptions;
+    filters[1].id = LZMA_VLI_UNKNOWN;
+    filters[1].options = nullptr;
+    uint64_t const memusage = lzma_raw_encoder_memusage(filters);
+    if (memusage != UINT64_MAX) {
+      state = memusage;
+    }
+  }
+#endif
+  unsigned long long const perThread = state + 4ull * this->BlockSize;
+  cmsys::SystemInformation info;
+  info.RunMemoryCheck();
+  unsigned long long const limit =
+    static_cast<unsigned long long>(info.GetTotalPhysicalMemory()) << 18;
+  if (limit > 0) {
+    threads = static_cast<unsigned int>(std::max(
+      1ull, std::min<unsigned long long>(threads, limit / perThread)));
+  }
+  for (unsigned int i = 0; i < threads; ++i) {
+    this->Workers.emplace_back([this]() { this->Run(); });
+  }
+}
+
+cmArchiveWrite::BlockCompressor::~BlockCompressor()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Stop = true;
+  }
+  this->JobReady.notify_all();
+  for (std::thread& worker : this->Workers) {
+    worker.join();
+  }
+#ifdef CM_ARCHIVE_WRITE_XZ_BLOCKS
+  lzma_index_end(this->Index, nullptr);
+#endif
+}
+
+bool cmArchiveWrite::BlockCompressor::Start()
+{
+  this->Started = true;
+  if (this->Method == CompressGZip) {
+    // Deflate data without a name, time stamp or flags, made on Unix.
+    static unsigned char const header[] = { 0x1f, 0x8b, 8, 0, 0,
+                                            0,    0,    0, 0, 3 };
+    return this->WriteOutput(header, sizeof(header));
+  }
+#ifdef CM_ARCHIVE_WRITE_XZ_BLOCKS
+  lzma_stream_flags flags = lzma_stream_flags();
+  flags.check = LZMA_CHECK_CRC64;
+  uint8_t header[LZMA_STREAM_HEADER_SIZE];
+  if (lzma_stream_header_encode(&flags, header) != LZMA_OK) {
+    this->Error = "lzma_stream_header_encode failed";
+    return false;
+  }
+  return this->WriteOutput(header, sizeof(header));
+#else
+  return true;
+#endif
+}
+
+bool cmArchiveWrite::BlockCompressor::Write(const char* data, size_t n)
+{
+  if (!this->Error.empty() || (!this->Started && !this->Start())) {
+    return false;
+  }
+  while (n > 0) {
+    size_t const chunk = std::min(n, this->BlockSize - this->Input.size());
+    this->Input.append(data, chunk);
+    data += chunk;
+    n -= chunk;
+    if (this->Input.size() == this->BlockSize) {
+      this->Submit(false);
+    }
+  }
+  return this->Error.empty();
+}
+
+bool cmArchiveWrite::BlockCompressor::Finish()
+{
+  if (this->Finished) {
+    return this->Error.empty();
+  }
+  this->Finished = true;
+  if (!this->Error.empty() || (!this->Started && !this->Start())) {
+    return false;
+  }
+  this->Submit(true);
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    if (!this->WriteDone(lock, 0)) {
+      return false;
+    }
+  }
+
+  if (this->Method == CompressGZip) {
+    unsigned char trailer[8];
+    for (int i = 0; i < 4; ++i) {
+      trailer[i] = static_cast<unsigned char>(this->Crc >> (8 * i));
+      trailer[4 + i] = static_cast<unsigned char>(this->Size >> (8 * i));
+    }
+    return this->WriteOutput(trailer, sizeof(trailer));
+  }
+#ifdef CM_ARCHIVE_WRITE_XZ_BLOCKS
+  lzma_stream_flags flags = lzma_stream_flags();
+  flags.check = LZMA_CHECK_CRC64;
+  flags.backward_size = lzma_index_size(this->Index);
+  std::vector<uint8_t> index(static_cast<size_t>(flags.backward_size));
+  size_t pos = 0;
+  uint8_t footer[LZMA_STREAM_HEADER_SIZE];
+  if (lzma_index_buffer_encode(this->Index, index.data(), &pos,
+                               index.size()) != LZMA_OK ||
+      lzma_stream_footer_encode(&flags, footer) != LZMA_OK) {
+    this->Error = "lzma_index_buffer_encode failed";
+    return false;
+  }
+  return this->WriteOutput(index.data(), index.size()) &&
+    this->WriteOutput(footer, sizeof(footer));
+#else
+  return true;
+#endif
+}
+
+void cmArchiveWrite::BlockCompressor::Submit(bool last)
+{
+  std::unique_ptr<Block> block(new Block);
+  block->Input.swap(this->Input);
+  block->Crc = 0;
+  block->UnpaddedSize = 0;
+  block->Last = last;
+  block->Done = false;
+  block->Failed = false;
+  if (this->Method == CompressGZip) {
+    block->Dictionary.swap(this->Dictionary);
+    size_t const n = block->Input.size();
+    size_t const keep = std::min(n, cmArchiveWriteGZipWindow);
+    this->Dictionary.assign(block->Input, n - keep, keep);
+  }
+
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  this->Queue.push_back(block.get());
+  this->Blocks.push_back(std::move(block));
+  this->JobReady.notify_one();
+
+  // Bound the number of blocks held in memory.
+  this->WriteDone(lock, 2 * this->Workers.size());
+}
+
+bool cmArchiveWrite::BlockCompressor::WriteDone(
+  std::unique_lock<std::mutex>& lock, size_t keep)
+{
+  // Write the finished blocks at the front, waiting for more while
+  // there are too many.
+  while (!this->Blocks.empty()) {
+    if (!this->Blocks.front()->Done) {
+      if (this->Blocks.size() <= keep) {
+        break;
+      }
+      this->JobDone.wait(lock);
+      continue;
+    }
+    std::unique_ptr<Block> block = std::move(this->Blocks.front());
+    this->Blocks.pop_front();
+    lock.unlock();
+    bool const written = this->WriteBlock(*block);
+    lock.lock();
+    if (!written) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool cmArchiveWrite::BlockCompressor::WriteBlock(Block const& b)
+{
+  if (b.Failed) {
+    this->Error = this->Method == CompressGZip
+      ? "deflate failed"
+      : "lzma_block_buffer_encode failed";
+    return false;
+  }
+  if (this->Method == CompressGZip) {
+    this->Crc = crc32_combine(this->Crc, b.Crc,
+                              static_cast<z_off_t>(b.Input.size()));
+    this->Size += static_cast<unsigned long>(b.Input.size());
+  }
+#ifdef CM_ARCHIVE_WRITE_XZ_BLOCKS
+  if (this->Method == CompressXZ && !b.Input.empty() &&
+      lzma_index_append(this->Index, nullptr, b.UnpaddedSize,
+                        b.Input.size()) != LZMA_OK) {
+    this->Error = "lzma_index_append failed";
+    return false;
+  }
+#endif
+  return this->WriteOutput(b.Output.data(), b.Output.size());
+}
+
+bool cmArchiveWrite::BlockCompressor::WriteOutput(const void* data, size_t n)
+{
+  if (!this->Stream.write(static_cast<const char*>(data),
+                          static_cast<std::streamsize>(n))) {
+    this->Error = "write failed";
+    return false;
+  }
+  return true;
+}
+
+void cmArchiveWrite::BlockCompressor::Run()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  for (;;) {
+    while (this->Queue.empty() && !this->Stop) {
+      this->JobReady.wait(lock);
+    }
+    if (this->Queue.empty()) {
+      return;
+    }
+    Block* block = this->Queue.front();
+    this->Queue.pop_front();
+    lock.unlock();
+#ifdef CM_ARCHIVE_WRITE_XZ_BLOCKS
+    bool const compressed = this->Method == CompressGZip
+      ? DeflateBlock(*block)
+      : this->EncodeXZBlock(*block);
+#else
+    bool const compressed = DeflateBlock(*block);
+#endif
+    lock.lock();
+    block->Failed = !compressed;
+    block->Done = true;
+    this->JobDone.notify_all();
+  }
+}
+
+bool cmArchiveWrite::BlockCompressor::DeflateBlock(Block& b)
+{
+  Bytef* const input =
+    reinterpret_cast<Bytef*>(const_cast<char*>(b.Input.data()));
+  uInt const inputSize = static_cast<uInt>(b.Input.size());
+  b.Crc = crc32(crc32(0L, Z_NULL, 0), input, inputSize);
+
+  z_stream z;
+  memset(&z, 0, sizeof(z));
+  if (deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return false;
+  }
+  bool ok = b.Dictionary.empty() ||
+    deflateSetDictionary(
+      &z, reinterpret_cast<const Bytef*>(b.Dictionary.data()),
+      static_cast<uInt>(b.Dictionary.size())) == Z_OK;
+
+  // A sync flush ends all but the last block on a byte boundary.
+  int const flush = b.Last ? Z_FINISH : Z_SYNC_FLUSH;
+  b.Output.resize(deflateBound(&z, inputSize) + 16);
+  z.next_in = input;
+  z.avail_in = inputSize;
+  z.next_out = reinterpret_cast<Bytef*>(&b.Output[0]);
+  z.avail_out = static_cast<uInt>(b.Output.size());
+  while (ok) {
+    int const ret = deflate(&z, flush);
+    if (ret != Z_OK && ret != Z_BUF_ERROR && ret != Z_STREAM_END) {
+      ok = false;
+    } else if (ret == Z_STREAM_END || (!b.Last && z.avail_out != 0)) {
+      break;
+    } else if (z.avail_out == 0) {
+      size_t const used = b.Output.size();
+      b.Output.resize(2 * used);
+      z.next_out = reinterpret_cast<Bytef*>(&b.Output[used]);
+      z.avail_out = static_cast<uInt>(used);
+    }
+  }
+  b.Output.resize(b.Output.size() - z.avail_out);
+  deflateEnd(&z);
+  return ok;
+}
+
+#ifdef CM_ARCHIVE_WRITE_XZ_BLOCKS
+bool cmArchiveWrite::BlockCompressor::EncodeXZBlock(Block& b) const
+{
+  // An empty last block is left out of the stream.
+  if (b.Input.empty()) {
+    return true;
+  }
+  lzma_options_lzma options = this->LzmaOptions;
+  lzma_filter filters[2];
+  filters[0].id = LZMA_FILTER_LZMA2;
+  filters[0].options = &options;
+  filters[1].id = LZMA_VLI_UNKNOWN;
+  filters[1].options = nullptr;
+  lzma_block block = lzma_block();
+  block.version = 0;
+  block.check = LZMA_CHECK_CRC64;
+  block.filters = filters;
+
+  b.Output.resize(lzma_block_buffer_bound(b.Input.size()));
+  size_t pos = 0;
+  if (lzma_block_buffer_encode(
+        &block, nullptr, reinterpret_cast<const uint8_t*>(b.Input.data()),
+        b.Input.size(), reinterpret_cast<uint8_t*>(&b.Output[0]), &pos,
+        b.Output.size()) != LZMA_OK) {
+    return false;
+  }
+  b.Output.resize(pos);
+  b.UnpaddedSize = lzma_block_unpadded_size(&block);
+  return true;
+}
+#endif
+
 struct cmArchiveWrite::Callback
 {
   // archive_write_callback
-  static __LA_SSIZE_T Write(struct archive* /*unused*/, void* cd,
-                            const void* b, size_t n)
+  static __LA_SSIZE_T Write(struct archive* a, void* cd, const void* b,
+                            size_t n)
   {
     cmArchiveWrite* self = static_cast<cmArchiveWrite*>(cd);
+    if (self->Compressor) {
+      if (self->Compressor->Write(static_cast<const char*>(b), n)) {
+        return static_cast<__LA_SSIZE_T>(n);
+      }
+      archive_set_error(a, -1, "%s", self->Compressor->GetError().c_str());
+      return static_cast<__LA_SSIZE_T>(-1);
+    }
     if (self->Stream.write(static_cast<const char*>(b),
                            static_cast<std::streamsize>(n))) {
       return static_cast<__LA_SSIZE_T>(n);
     }
     return static_cast<__LA_SSIZE_T>(-1);
   }
+
+  // archive_close_callback
+  static int Close(struct archive* a, void* cd)
+  {
+    // The archive is closed by the destructor, so report errors of the
+    // last blocks here.
+    cmArchiveWrite* self = static_cast<cmArchiveWrite*>(cd);
+    if (self->Compressor && !self->Compressor->Finish()) {
+      std::string const e = "Error compressing archive: " +
+        self->Compressor->GetError();
+      archive_set_error(a, -1, "%s", e.c_str());
+      cmSystemTools::Error(e.c_str());
+      return ARCHIVE_FATAL;
+    }
+    return ARCHIVE_OK;
+  }
 };
 
 cmArchiveWrite::cmArchiveWrite(std::ostream& os, Compress c,
-                               std::string const& format)
+                               std::string const& format, int threads)
   : Stream(os)
   , Archive(archive_write_new())
   , Disk(archive_read_disk_new())
   , Verbose(false)
   , Format(format)
 {
+  // Compress in blocks on worker threads instead of in libarchive.
+  if (threads != 1 &&
+      (c == CompressGZip
+#ifdef CM_ARCHIVE_WRITE_XZ_BLOCKS
+       || c == CompressXZ
+#endif
+       )) {
+    unsigned int const n = threads > 0
+      ? static_cast<unsigned int>(threads)
+      : std::max(std::thread::hardware_concurrency(), 1u);
+    this->Compressor.reset(new BlockCompressor(os, c, n));
+    c = CompressNone;
+  }
+
   switch (c) {
     case CompressNone:
       if (archive_write_add_filter_none(this->Archive) != ARCHIVE_OK) {
@@ -134,6 +608,12 @@ cmArchiveWrite::cmArchiveWrite(std::ostream& os, Compress c,
         this->Error += cm_archive_error_string(this->Archive);
         return;
       }
+      if (threads != 1) {
+        // A libarchive without a multithreaded encoder uses one thread.
+        std::string const n = std::to_string(std::max(threads, 0));
+        static_cast<void>(archive_write_set_filter_option(
+          this->Archive, "xz", "threads", n.c_str()));
+      }
       break;
   };
 #if !defined(_WIN32) || defined(__CYGWIN__)
@@ -161,7 +641,7 @@ cmArchiveWrite::cmArchiveWrite(std::ostream& os, Compress c,
   if (archive_write_open(
         this->Archive, this, nullptr,
         reinterpret_cast<archive_write_callback*>(&Callback::Write),
-        nullptr) != ARCHIVE_OK) {
+        &Callback::Close) != ARCHIVE_OK) {
     this->Error = "archive_write_open: ";
     this->Error += cm_archive_error_string(this->Archive);
     return;
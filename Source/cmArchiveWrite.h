@@ -6,6 +6,7 @@
 #include "cmConfigure.h" // IWYU pragma: keep
 
 #include <iosfwd>
+#include <memory>
 #include <stddef.h>
 #include <string>
 
@@ -55,9 +56,13 @@ public:
     CompressXZ
   };
 
-  /** Construct with output stream to which to write archive.  */
+  /** Construct with output stream to which to write archive.  With a
+      thread count other than 1, gzip and xz data are compressed in
+      independent blocks on that many threads, or on one thread per
+      processor if it is 0.  The output then does not depend on the
+      count.  */
   cmArchiveWrite(std::ostream& os, Compress c = CompressNone,
-                 std::string const& format = "paxr");
+                 std::string const& format = "paxr", int threads = 1);
 
   ~cmArchiveWrite();
 
@@ -153,6 +158,9 @@ private:
 
   class Entry;
 
+  class BlockCompressor;
+  std::unique_ptr<BlockCompressor> Compressor;
+
   std::ostream& Stream;
   struct archive* Archive;
   struct archive* Disk;
@@ -289,6 +289,9 @@ cmCTest::cmCTest()
   this->GlobalTimeout = cmDuration::zero();
   this->CompressXMLFiles = false;
   this->ScheduleType.clear();
+  this->ShardIndex = 0;
+  this->ShardCount = 0;
+  this->MergeResults = false;
   this->OutputLogFile = nullptr;
   this->OutputLogFileLastTag = -1;
   this->SuppressUpdatingCTestConfiguration = false;
@@ -1963,6 +1966,34 @@ bool cmCTest::HandleCommandLineArguments(size_t& i,
     }
   }
 
+  if (this->CheckArgument(arg, "--shard") && i < args.size() - 1) {
+    i++;
+    std::string const& shard = args[i];
+    std::string::size_type const slash = shard.find('/');
+    unsigned long index = 0;
+    unsigned long count = 0;
+    if (slash == std::string::npos ||
+        !cmSystemTools::StringToULong(shard.substr(0, slash).c_str(),
+                                      &index) ||
+        !cmSystemTools::StringToULong(shard.substr(slash + 1).c_str(),
+                                      &count) ||
+        count < 1 || index < 1 || index > count) {
+      errormsg = "'--shard' requires an argument of the form <i>/<N> with "
+                 "1 <= i <= N, but got '" +
+        shard + "'";
+      return false;
+    }
+    this->ShardIndex = static_cast<int>(index);
+    this->ShardCount = static_cast<int>(count);
+  }
+  if (this->CheckArgument(arg, "--merge-results")) {
+    this->MergeResults = true;
+    while (i + 1 < args.size() && !cmHasLiteralPrefix(args[i + 1], "-")) {
+      i++;
+      this->MergeResultsDirectories.push_back(args[i]);
+    }
+  }
+
   if (this->CheckArgument(arg, "--overwrite") && i < args.size() - 1) {
     i++;
     this->AddCTestConfigurationOverwrite(args[i]);
@@ -2237,12 +2268,28 @@ int cmCTest::Run(std::vector<std::string>& args, std::string* output)
   }
 #endif
 
+  // each shard writes its results under its own submit index so that
+  // several shards can share one build tree and be merged afterwards
+  if (this->ShardCount > 0 && this->SubmitIndex == 0) {
+    this->SubmitIndex = this->ShardIndex;
+  }
+
   // now what should cmake do? if --build-and-test was specified then
   // we run the build and test handler and return
   if (cmakeAndTest) {
     return this->RunCMakeAndTest(output);
   }
 
+  if (this->MergeResults) {
+    this->ExtraVerbose = this->Verbose;
+    this->Verbose = true;
+    cmCTestTestHandler* handler =
+      static_cast<cmCTestTestHandler*>(this->GetHandler("test"));
+    return handler->MergeShardResults(
+      cmSystemTools::GetCurrentWorkingDirectory(),
+      this->MergeResultsDirectories);
+  }
+
   if (executeTests) {
     return this->ExecuteTests();
   }
@@ -234,6 +234,11 @@ public:
   std::string GetScheduleType() { return this->ScheduleType; }
   void SetScheduleType(std::string const& type) { this->ScheduleType = type; }
 
+  /** Used to run only one cost-balanced shard of the selected tests.
+      The index is 1-based; a count of zero disables sharding.  */
+  int GetShardIndex() const { return this->ShardIndex; }
+  int GetShardCount() const { return this->ShardCount; }
+
   /** The max output width */
   int GetMaxTestNameWidth() const;
   void SetMaxTestNameWidth(int w) { this->MaxTestNameWidth = w; }
@@ -469,6 +474,10 @@ private:
   bool RepeatUntilFail;
   std::string ConfigType;
   std::string ScheduleType;
+  int ShardIndex;
+  int ShardCount;
+  bool MergeResults;
+  std::vector<std::string> MergeResultsDirectories;
   std::chrono::system_clock::time_point StopTime;
   bool TestProgressOutput;
   bool Verbose;
@@ -32,6 +32,7 @@ public:
    */
   cmCommand()
     : Makefile(nullptr)
+    , Invoking(false)
   {
   }
 
@@ -79,6 +80,20 @@ public:
    */
   virtual cmCommand* Clone() = 0;
 
+  /**
+   * May the command be invoked on the prototype held by cmState instead
+   * of a clone?  Such a command keeps no state in its members from one
+   * invocation to the next and has no final pass.
+   */
+  virtual bool IsReusable() const { return false; }
+
+  /**
+   * Mark the prototype of a reusable command while an invocation runs
+   * on it so that a nested invocation uses a clone.
+   */
+  bool IsInvoking() const { return this->Invoking; }
+  void SetInvoking(bool invoking) { this->Invoking = invoking; }
+
   /**
    * Return the last error string.
    */
@@ -94,6 +109,7 @@ protected:
 
 private:
   std::string Error;
+  bool Invoking;
 };
 
 #endif
@@ -195,6 +195,8 @@ cmComputeLinkDepends::cmComputeLinkDepends(const cmGeneratorTarget* target,
 
   // No computation has been done.
   this->CCG = nullptr;
+
+  this->Cache = &this->GlobalGenerator->GetLinkDependsCache();
 }
 
 cmComputeLinkDepends::~cmComputeLinkDepends()
@@ -279,39 +281,36 @@ cmComputeLinkDepends::Compute()
   return this->FinalLinkEntries;
 }
 
-std::map<cmLinkItem, int>::iterator cmComputeLinkDepends::AllocateLinkEntry(
-  cmLinkItem const& item)
+int cmComputeLinkDepends::FindLinkEntry(int item_id)
+{
+  if (static_cast<size_t>(item_id) >= this->ItemEntryIndex.size()) {
+    this->ItemEntryIndex.resize(item_id + 1, -1);
+  }
+  return this->ItemEntryIndex[item_id];
+}
+
+int cmComputeLinkDepends::AllocateLinkEntry(int item_id)
 {
-  std::map<cmLinkItem, int>::value_type index_entry(
-    item, static_cast<int>(this->EntryList.size()));
-  std::map<cmLinkItem, int>::iterator lei =
-    this->LinkEntryIndex.insert(index_entry).first;
-  this->EntryList.emplace_back();
+  int index = static_cast<int>(this->EntryList.size());
+  this->ItemEntryIndex[item_id] = index;
+  this->EntryList.push_back(this->Cache->GetEntry(item_id));
   this->InferredDependSets.push_back(nullptr);
   this->EntryConstraintGraph.emplace_back();
-  return lei;
+  return index;
 }
 
-int cmComputeLinkDepends::AddLinkEntry(cmLinkItem const& item)
+int cmComputeLinkDepends::AddLinkEntry(int item_id)
 {
   // Check if the item entry has already been added.
-  std::map<cmLinkItem, int>::iterator lei = this->LinkEntryIndex.find(item);
-  if (lei != this->LinkEntryIndex.end()) {
+  int index = this->FindLinkEntry(item_id);
+  if (index >= 0) {
     // Yes.  We do not need to follow the item's dependencies again.
-    return lei->second;
+    return index;
   }
 
   // Allocate a spot for the item entry.
-  lei = this->AllocateLinkEntry(item);
-
-  // Initialize the item entry.
-  int index = lei->second;
+  index = this->AllocateLinkEntry(item_id);
   LinkEntry& entry = this->EntryList[index];
-  entry.Item = item.AsStr();
-  entry.Target = item.Target;
-  entry.IsFlag =
-    (!entry.Target && entry.Item[0] == '-' && entry.Item[1] != 'l' &&
-     entry.Item.substr(0, 10) != "-framework");
 
   // If the item has dependencies queue it to follow them.
   if (entry.Target) {
@@ -349,7 +348,8 @@ void cmComputeLinkDepends::FollowLinkEntry(BFSEntry qe)
       const bool isIface =
         entry.Target->GetType() == cmStateEnums::INTERFACE_LIBRARY;
       // This target provides its own link interface information.
-      this->AddLinkEntries(depender_index, iface->Libraries);
+      this->AddLinkEntryIds(depender_index,
+                            this->Cache->GetInterface(iface).Libraries);
 
       if (isIface) {
         return;
@@ -375,19 +375,21 @@ void cmComputeLinkDepends::FollowSharedDeps(int depender_index,
 {
   // Follow dependencies if we have not followed them already.
   if (this->SharedDepFollowed.insert(depender_index).second) {
+    cmComputeLinkDependsCache::Interface const& ci =
+      this->Cache->GetInterface(iface);
     if (follow_interface) {
-      this->QueueSharedDependencies(depender_index, iface->Libraries);
+      this->QueueSharedDependencies(depender_index, ci.Libraries);
     }
-    this->QueueSharedDependencies(depender_index, iface->SharedDeps);
+    this->QueueSharedDependencies(depender_index, ci.SharedDeps);
   }
 }
 
 void cmComputeLinkDepends::QueueSharedDependencies(
-  int depender_index, std::vector<cmLinkItem> const& deps)
+  int depender_index, std::vector<int> const& deps)
 {
-  for (cmLinkItem const& li : deps) {
+  for (int id : deps) {
     SharedDepEntry qe;
-    qe.Item = li;
+    qe.ItemId = id;
     qe.DependerIndex = depender_index;
     this->SharedDepQueue.push(qe);
   }
@@ -396,25 +398,20 @@ void cmComputeLinkDepends::QueueSharedDependencies(
 void cmComputeLinkDepends::HandleSharedDependency(SharedDepEntry const& dep)
 {
   // Check if the target already has an entry.
-  std::map<cmLinkItem, int>::iterator lei =
-    this->LinkEntryIndex.find(dep.Item);
-  if (lei == this->LinkEntryIndex.end()) {
+  int index = this->FindLinkEntry(dep.ItemId);
+  if (index < 0) {
     // Allocate a spot for the item entry.
-    lei = this->AllocateLinkEntry(dep.Item);
-
-    // Initialize the item entry.
-    LinkEntry& entry = this->EntryList[lei->second];
-    entry.Item = dep.Item.AsStr();
-    entry.Target = dep.Item.Target;
+    index = this->AllocateLinkEntry(dep.ItemId);
 
     // This item was added specifically because it is a dependent
     // shared library.  It may get special treatment
     // in cmComputeLinkInformation.
+    LinkEntry& entry = this->EntryList[index];
+    entry.IsFlag = false;
     entry.IsSharedDep = true;
   }
 
   // Get the link entry for this target.
-  int index = lei->second;
   LinkEntry& entry = this->EntryList[index];
 
   // This shared library dependency must follow the item that listed
@@ -504,21 +501,32 @@ void cmComputeLinkDepends::AddDirectLinkEntries()
 template <typename T>
 void cmComputeLinkDepends::AddLinkEntries(int depender_index,
                                           std::vector<T> const& libs)
+{
+  std::vector<int> ids;
+  ids.reserve(libs.size());
+  for (cmLinkItem const& item : libs) {
+    ids.push_back(this->Cache->GetItemId(item));
+  }
+  this->AddLinkEntryIds(depender_index, ids);
+}
+
+void cmComputeLinkDepends::AddLinkEntryIds(int depender_index,
+                                           std::vector<int> const& ids)
 {
   // Track inferred dependency sets implied by this list.
   std::map<int, DependSet> dependSets;
 
   // Loop over the libraries linked directly by the depender.
-  for (T const& l : libs) {
+  for (int id : ids) {
     // Skip entries that will resolve to the target getting linked or
     // are empty.
-    cmLinkItem const& item = l;
-    if (item.AsStr() == this->Target->GetName() || item.AsStr().empty()) {
+    std::string const& item = this->Cache->GetEntry(id).Item;
+    if (item == this->Target->GetName() || item.empty()) {
       continue;
     }
 
     // Add a link entry for this item.
-    int dependee_index = this->AddLinkEntry(l);
+    int dependee_index = this->AddLinkEntry(id);
 
     // The dependee must come after the depender.
     if (depender_index >= 0) {
@@ -845,3 +853,41 @@ void cmComputeLinkDepends::CheckWrongConfigItem(cmLinkItem const& item)
     this->OldWrongConfigItems.insert(item.Target);
   }
 }
+
+int cmComputeLinkDependsCache::GetItemId(cmLinkItem const& item)
+{
+  std::map<cmLinkItem, int>::iterator i = this->ItemIds.find(item);
+  if (i != this->ItemIds.end()) {
+    return i->second;
+  }
+  int id = static_cast<int>(this->Entries.size());
+  this->ItemIds.emplace(item, id);
+
+  cmComputeLinkDepends::LinkEntry entry;
+  entry.Item = item.AsStr();
+  entry.Target = item.Target;
+  entry.IsFlag =
+    (!entry.Target && entry.Item[0] == '-' && entry.Item[1] != 'l' &&
+     entry.Item.substr(0, 10) != "-framework");
+  this->Entries.push_back(entry);
+  return id;
+}
+
+cmComputeLinkDependsCache::Interface const&
+cmComputeLinkDependsCache::GetInterface(cmLinkInterface const* iface)
+{
+  auto i = this->Interfaces.find(iface);
+  if (i != this->Interfaces.end()) {
+    return i->second;
+  }
+  Interface ci;
+  ci.Libraries.reserve(iface->Libraries.size());
+  for (cmLinkItem const& item : iface->Libraries) {
+    ci.Libraries.push_back(this->GetItemId(item));
+  }
+  ci.SharedDeps.reserve(iface->SharedDeps.size());
+  for (cmLinkItem const& item : iface->SharedDeps) {
+    ci.SharedDeps.push_back(this->GetItemId(item));
+  }
+  return this->Interfaces.emplace(iface, std::move(ci)).first->second;
+}
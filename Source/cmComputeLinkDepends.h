@@ -13,9 +13,11 @@
 #include <queue>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class cmComputeComponentGraph;
+class cmComputeLinkDependsCache;
 class cmGeneratorTarget;
 class cmGlobalGenerator;
 class cmMakefile;
@@ -72,18 +74,24 @@ private:
   std::string Config;
   EntryVector FinalLinkEntries;
 
-  std::map<cmLinkItem, int>::iterator AllocateLinkEntry(
-    cmLinkItem const& item);
-  int AddLinkEntry(cmLinkItem const& item);
+  // Items and link interfaces shared with other link computations.
+  cmComputeLinkDependsCache* Cache;
+
+  int AllocateLinkEntry(int item_id);
+  int AddLinkEntry(int item_id);
   void AddVarLinkEntries(int depender_index, const char* value);
   void AddDirectLinkEntries();
   template <typename T>
   void AddLinkEntries(int depender_index, std::vector<T> const& libs);
+  void AddLinkEntryIds(int depender_index, std::vector<int> const& ids);
   cmLinkItem ResolveLinkItem(int depender_index, const std::string& name);
 
   // One entry for each unique item.
   std::vector<LinkEntry> EntryList;
-  std::map<cmLinkItem, int> LinkEntryIndex;
+
+  // Index of the entry for each item id of the cache, or -1 if none.
+  std::vector<int> ItemEntryIndex;
+  int FindLinkEntry(int item_id);
 
   // BFS of initial dependencies.
   struct BFSEntry
@@ -99,7 +107,7 @@ private:
   // of the interface.
   struct SharedDepEntry
   {
-    cmLinkItem Item;
+    int ItemId;
     int DependerIndex;
   };
   std::queue<SharedDepEntry> SharedDepQueue;
@@ -107,7 +115,7 @@ private:
   void FollowSharedDeps(int depender_index, cmLinkInterface const* iface,
                         bool follow_interface = false);
   void QueueSharedDependencies(int depender_index,
-                               std::vector<cmLinkItem> const& deps);
+                               std::vector<int> const& deps);
   void HandleSharedDependency(SharedDepEntry const& dep);
 
   // Dependency inferral for each link item.
@@ -169,4 +177,46 @@ private:
   bool OldLinkDirMode;
 };
 
+/** \class cmComputeLinkDependsCache
+ * \brief Link items and interfaces shared by all link computations.
+ *
+ * Every distinct link item gets a number, and the items listed directly
+ * by each link interface are resolved to numbers once.  The link
+ * computations of all targets and configurations whose dependencies
+ * reach the same interface reuse those lists instead of looking up the
+ * items again.  Each computation still walks the transitive closure of
+ * its own dependencies, so the total work remains proportional to the
+ * sum of the closure sizes.  Interfaces that depend on the head target
+ * are distinct objects for each head, so keying by interface keeps their
+ * results apart.  The cache lives as long as the generator targets it
+ * refers to.
+ */
+class cmComputeLinkDependsCache
+{
+public:
+  // The items of one link interface.
+  struct Interface
+  {
+    std::vector<int> Libraries;
+    std::vector<int> SharedDeps;
+  };
+
+  /** Get the number of an item, assigning one on first use.  */
+  int GetItemId(cmLinkItem const& item);
+
+  /** Get the initial link entry of the item with the given number.  */
+  cmComputeLinkDepends::LinkEntry const& GetEntry(int id) const
+  {
+    return this->Entries[id];
+  }
+
+  /** Get the items of a link interface, resolving them on first use.  */
+  Interface const& GetInterface(cmLinkInterface const* iface);
+
+private:
+  std::map<cmLinkItem, int> ItemIds;
+  std::vector<cmComputeLinkDepends::LinkEntry> Entries;
+  std::unordered_map<cmLinkInterface const*, Interface> Interfaces;
+};
+
 #endif
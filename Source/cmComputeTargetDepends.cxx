@@ -2,6 +2,7 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmComputeTargetDepends.h"
 
+#include "cmAlgorithms.h"
 #include "cmComputeComponentGraph.h"
 #include "cmGeneratorTarget.h"
 #include "cmGlobalGenerator.h"
@@ -141,8 +142,7 @@ void cmComputeTargetDepends::GetTargetDirectDepends(cmGeneratorTarget const* t,
 {
   // Lookup the index for this target.  All targets should be known by
   // this point.
-  std::map<cmGeneratorTarget const*, int>::const_iterator tii =
-    this->TargetIndex.find(t);
+  auto tii = this->TargetIndex.find(t);
   assert(tii != this->TargetIndex.end());
   int i = tii->second;
 
@@ -169,6 +169,73 @@ void cmComputeTargetDepends::CollectTargets()
       this->Targets.push_back(ti);
     }
   }
+  this->TargetIds = this->Targets;
+}
+
+int cmComputeTargetDepends::GetTargetId(cmGeneratorTarget const* t)
+{
+  auto i = this->TargetIndex.find(t);
+  if (i != this->TargetIndex.end()) {
+    return i->second;
+  }
+  int id = static_cast<int>(this->TargetIds.size());
+  this->TargetIndex.emplace(t, id);
+  this->TargetIds.push_back(t);
+  return id;
+}
+
+bool cmComputeTargetDepends::TargetSet::Contains(int id) const
+{
+  size_t const w = static_cast<size_t>(id) / 64;
+  return w < this->Words.size() && ((this->Words[w] >> (id % 64)) & 1);
+}
+
+bool cmComputeTargetDepends::TargetSet::Insert(int id)
+{
+  size_t const w = static_cast<size_t>(id) / 64;
+  if (w >= this->Words.size()) {
+    this->Words.resize(w + 1, 0);
+  }
+  unsigned long long const bit = 1ull << (id % 64);
+  if (this->Words[w] & bit) {
+    return false;
+  }
+  this->Words[w] |= bit;
+  return true;
+}
+
+bool cmComputeTargetDepends::TargetSet::ContainsAll(
+  TargetSet const& other) const
+{
+  for (size_t w = 0; w < other.Words.size(); ++w) {
+    unsigned long long const have =
+      w < this->Words.size() ? this->Words[w] : 0;
+    if (other.Words[w] & ~have) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct cmComputeTargetDepends::EmittedItems
+{
+  // Targets by id and other items by name.
+  TargetSet Targets;
+  std::set<cmLinkItem> Items;
+
+  // Whether the link interface of every emitted target other than the
+  // depender itself has been followed.  Interface closures may be used
+  // only while this holds.
+  bool Closed = true;
+};
+
+bool cmComputeTargetDepends::Emit(cmLinkItem const& item,
+                                  EmittedItems& emitted)
+{
+  if (item.Target) {
+    return emitted.Targets.Insert(this->GetTargetId(item.Target));
+  }
+  return emitted.Items.insert(item).second;
 }
 
 void cmComputeTargetDepends::CollectDepends()
@@ -195,13 +262,17 @@ void cmComputeTargetDepends::CollectTargetDepends(int depender_index)
   // dependencies in all targets, because the generated build-systems can't
   // deal with config-specific dependencies.
   {
-    std::set<cmLinkItem> emitted;
+    EmittedItems emitted;
 
     std::vector<std::string> configs;
     depender->Makefile->GetConfigurations(configs);
     if (configs.empty()) {
       configs.emplace_back();
     }
+
+    // Items emitted for one configuration may not have been followed
+    // in the others.
+    emitted.Closed = configs.size() == 1;
     for (std::string const& it : configs) {
       std::vector<cmSourceFile const*> objectFiles;
       depender->GetExternalObjects(objectFiles, it);
@@ -209,7 +280,8 @@ void cmComputeTargetDepends::CollectTargetDepends(int depender_index)
         std::string const& objLib = o->GetObjectLibrary();
         if (!objLib.empty()) {
           cmLinkItem const& objItem = depender->ResolveLinkItem(objLib);
-          if (emitted.insert(objItem).second) {
+          if (this->Emit(objItem, emitted)) {
+            emitted.Closed = false;
             if (depender->GetType() != cmStateEnums::EXECUTABLE &&
                 depender->GetType() != cmStateEnums::STATIC_LIBRARY &&
                 depender->GetType() != cmStateEnums::SHARED_LIBRARY &&
@@ -230,12 +302,15 @@ void cmComputeTargetDepends::CollectTargetDepends(int depender_index)
       cmLinkImplementation const* impl = depender->GetLinkImplementation(it);
 
       // A target should not depend on itself.
-      emitted.insert(cmLinkItem(depender));
+      this->Emit(cmLinkItem(depender), emitted);
       for (cmLinkImplItem const& lib : impl->Libraries) {
         // Don't emit the same library twice for this target.
-        if (emitted.insert(lib).second) {
+        if (this->Emit(lib, emitted)) {
           this->AddTargetDepend(depender_index, lib, true);
-          this->AddInterfaceDepends(depender_index, lib, it, emitted);
+          if (!this->AddInterfaceClosureDepends(depender_index, lib, it,
+                                                emitted)) {
+            this->AddInterfaceDepends(depender_index, lib, it, emitted);
+          }
         }
       }
     }
@@ -258,14 +333,14 @@ void cmComputeTargetDepends::CollectTargetDepends(int depender_index)
 
 void cmComputeTargetDepends::AddInterfaceDepends(
   int depender_index, const cmGeneratorTarget* dependee,
-  const std::string& config, std::set<cmLinkItem>& emitted)
+  const std::string& config, EmittedItems& emitted)
 {
   cmGeneratorTarget const* depender = this->Targets[depender_index];
   if (cmLinkInterface const* iface =
         dependee->GetLinkInterface(config, depender)) {
     for (cmLinkItem const& lib : iface->Libraries) {
       // Don't emit the same library twice for this target.
-      if (emitted.insert(lib).second) {
+      if (this->Emit(lib, emitted)) {
         this->AddTargetDepend(depender_index, lib, true);
         this->AddInterfaceDepends(depender_index, lib, config, emitted);
       }
@@ -275,7 +350,7 @@ void cmComputeTargetDepends::AddInterfaceDepends(
 
 void cmComputeTargetDepends::AddInterfaceDepends(
   int depender_index, cmLinkItem const& dependee_name,
-  const std::string& config, std::set<cmLinkItem>& emitted)
+  const std::string& config, EmittedItems& emitted)
 {
   cmGeneratorTarget const* depender = this->Targets[depender_index];
   cmGeneratorTarget const* dependee = dependee_name.Target;
@@ -289,11 +364,108 @@ void cmComputeTargetDepends::AddInterfaceDepends(
 
   if (dependee) {
     // A target should not depend on itself.
-    emitted.insert(cmLinkItem(depender));
+    this->Emit(cmLinkItem(depender), emitted);
     this->AddInterfaceDepends(depender_index, dependee, config, emitted);
   }
 }
 
+bool cmComputeTargetDepends::AddInterfaceClosureDepends(
+  int depender_index, cmLinkItem const& dependee_name,
+  const std::string& config, EmittedItems& emitted)
+{
+  // The closure of an item matches the walk in AddInterfaceDepends only
+  // if every emitted target it reaches has been followed already and it
+  // does not reach back to the depender.
+  cmGeneratorTarget const* dependee = dependee_name.Target;
+  if (!emitted.Closed || !dependee ||
+      (dependee->GetType() == cmStateEnums::EXECUTABLE &&
+       !dependee->IsExecutableWithExports())) {
+    return false;
+  }
+  cmGeneratorTarget const* depender = this->Targets[depender_index];
+  InterfaceClosure const* closure =
+    this->GetInterfaceClosure(this->GetTargetId(dependee), depender, config);
+  if (!closure || closure->Reach.Contains(depender_index)) {
+    return false;
+  }
+
+  // Skip the walk if everything reachable has been emitted.
+  if (emitted.Targets.ContainsAll(closure->Reach)) {
+    return true;
+  }
+  for (int id : closure->Order) {
+    if (emitted.Targets.Insert(id)) {
+      this->AddTargetDepend(depender_index, cmLinkItem(this->TargetIds[id]),
+                            true);
+    }
+  }
+  return true;
+}
+
+cmComputeTargetDepends::InterfaceClosure const*
+cmComputeTargetDepends::GetInterfaceClosure(int id,
+                                            cmGeneratorTarget const* head,
+                                            const std::string& config)
+{
+  InterfaceClosureList& closures = this->InterfaceClosures[config];
+  if (closures.size() <= static_cast<size_t>(id)) {
+    closures.resize(id + 1);
+  }
+  if (InterfaceClosure const* known = closures[id].get()) {
+    // A closure still being computed is part of a cycle.
+    return known->Valid ? known : nullptr;
+  }
+  closures[id] = cm::make_unique<InterfaceClosure>();
+  InterfaceClosure* closure = closures[id].get();
+  closure->Valid = false;
+
+  cmGeneratorTarget const* dependee = this->TargetIds[id];
+  cmLinkInterface const* iface = dependee->GetLinkInterface(config, head);
+  if (iface && dependee->LinkInterfaceDependsOnHead(config)) {
+    return nullptr;
+  }
+  if (iface) {
+    for (cmLinkItem const& lib : iface->Libraries) {
+      // Items that are not targets add no target dependencies.
+      cmGeneratorTarget const* t = lib.Target;
+      if (!t) {
+        continue;
+      }
+      int const tid = this->GetTargetId(t);
+      if (tid == id) {
+        return nullptr;
+      }
+      if (!closure->Reach.Insert(tid)) {
+        continue;
+      }
+      closure->Order.push_back(tid);
+      if (t->GetType() == cmStateEnums::EXECUTABLE &&
+          !t->IsExecutableWithExports()) {
+        continue;
+      }
+
+      // Append the part of the nested closure not reached yet.  This is
+      // what a depth-first walk would visit because everything reached
+      // so far is closed under the walk.
+      InterfaceClosure const* nested =
+        this->GetInterfaceClosure(tid, head, config);
+      if (!nested || nested->Reach.Contains(id)) {
+        return nullptr;
+      }
+      if (closure->Reach.ContainsAll(nested->Reach)) {
+        continue;
+      }
+      for (int n : nested->Order) {
+        if (closure->Reach.Insert(n)) {
+          closure->Order.push_back(n);
+        }
+      }
+    }
+  }
+  closure->Valid = true;
+  return closure;
+}
+
 void cmComputeTargetDepends::AddTargetDepend(int depender_index,
                                              cmLinkItem const& dependee_name,
                                              bool linking)
@@ -367,10 +539,10 @@ void cmComputeTargetDepends::AddTargetDepend(int depender_index,
   } else {
     // Lookup the index for this target.  All targets should be known by
     // this point.
-    std::map<cmGeneratorTarget const*, int>::const_iterator tii =
-      this->TargetIndex.find(dependee);
+    auto tii = this->TargetIndex.find(dependee);
     assert(tii != this->TargetIndex.end());
     int dependee_index = tii->second;
+    assert(dependee_index < static_cast<int>(this->Targets.size()));
 
     // Add this entry to the dependency graph.
     this->InitialGraph[depender_index].emplace_back(dependee_index, !linking);
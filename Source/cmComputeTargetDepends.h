@@ -8,8 +8,10 @@
 #include "cmGraphAdjacencyList.h"
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class cmComputeComponentGraph;
@@ -49,20 +51,54 @@ private:
   void AddTargetDepend(int depender_index, cmGeneratorTarget const* dependee,
                        bool linking);
   bool ComputeFinalDepends(cmComputeComponentGraph const& ccg);
+  struct EmittedItems;
+  bool Emit(cmLinkItem const& item, EmittedItems& emitted);
   void AddInterfaceDepends(int depender_index, cmLinkItem const& dependee_name,
-                           const std::string& config,
-                           std::set<cmLinkItem>& emitted);
+                           const std::string& config, EmittedItems& emitted);
   void AddInterfaceDepends(int depender_index,
                            cmGeneratorTarget const* dependee,
-                           const std::string& config,
-                           std::set<cmLinkItem>& emitted);
+                           const std::string& config, EmittedItems& emitted);
+  bool AddInterfaceClosureDepends(int depender_index,
+                                  cmLinkItem const& dependee_name,
+                                  const std::string& config,
+                                  EmittedItems& emitted);
   cmGlobalGenerator* GlobalGenerator;
   bool DebugMode;
   bool NoCycles;
 
-  // Collect all targets.
+  // Collect all targets.  Every target reached while collecting
+  // dependencies gets a dense id.  The ids of the targets in Targets
+  // are their indices, and other targets, such as imported targets,
+  // follow them.
   std::vector<cmGeneratorTarget const*> Targets;
-  std::map<cmGeneratorTarget const*, int> TargetIndex;
+  std::unordered_map<cmGeneratorTarget const*, int> TargetIndex;
+  int GetTargetId(cmGeneratorTarget const* t);
+  std::vector<cmGeneratorTarget const*> TargetIds;
+
+  // Set of target ids stored as bits.
+  struct TargetSet
+  {
+    std::vector<unsigned long long> Words;
+    bool Contains(int id) const;
+    bool Insert(int id);
+    bool ContainsAll(TargetSet const& other) const;
+  };
+
+  // The targets reachable through the link interface of a target in
+  // one configuration, in the order of a depth-first walk.  The closure
+  // is shared by all dependers when no link interface it reaches
+  // depends on the depender and it contains no cycle.
+  struct InterfaceClosure
+  {
+    std::vector<int> Order;
+    TargetSet Reach;
+    bool Valid = true;
+  };
+  typedef std::vector<std::unique_ptr<InterfaceClosure>> InterfaceClosureList;
+  std::map<std::string, InterfaceClosureList> InterfaceClosures;
+  InterfaceClosure const* GetInterfaceClosure(int id,
+                                              cmGeneratorTarget const* head,
+                                              const std::string& config);
 
   // Represent the target dependency graph.  The entry at each
   // top-level index corresponds to a depender whose dependencies are
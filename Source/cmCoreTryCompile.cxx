@@ -3,18 +3,29 @@
 #include "cmCoreTryCompile.h"
 
 #include "cmsys/Directory.hxx"
+#include "cmsys/FStream.hxx"
+#include "cmsys/RegularExpression.hxx"
+#include <algorithm>
+#include <ios>
+#include <iterator>
+#include <map>
 #include <set>
 #include <sstream>
 #include <stdio.h>
 #include <string.h>
+#include <thread>
 #include <utility>
 
 #include "cmAlgorithms.h"
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#  include "cmCryptoHash.h"
+#endif
 #include "cmExportTryCompileFileGenerator.h"
 #include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmOutputConverter.h"
 #include "cmPolicies.h"
+#include "cmRulePlaceholderExpander.h"
 #include "cmState.h"
 #include "cmSystemTools.h"
 #include "cmTarget.h"
@@ -48,12 +59,98 @@ static std::string const kCMAKE_TRY_COMPILE_PLATFORM_VARIABLES =
   "CMAKE_TRY_COMPILE_PLATFORM_VARIABLES";
 static std::string const kCMAKE_WARN_DEPRECATED = "CMAKE_WARN_DEPRECATED";
 
-static void writeProperty(FILE* fout, std::string const& targetName,
+namespace {
+/** A target of the project generated for the source file signature.  */
+struct TryCompileTarget
+{
+  std::string Name;
+  std::vector<std::string> Sources;
+  std::string CacheKey;
+  bool Cached = false;
+  bool Result = false;
+};
+}
+
+static void writeProperty(std::ostream& fout, std::string const& targetName,
                           std::string const& prop, std::string const& value)
 {
-  fprintf(fout, "set_property(TARGET %s PROPERTY %s %s)\n", targetName.c_str(),
-          cmOutputConverter::EscapeForCMake(prop).c_str(),
-          cmOutputConverter::EscapeForCMake(value).c_str());
+  fout << "set_property(TARGET " << targetName << " PROPERTY "
+       << cmOutputConverter::EscapeForCMake(prop) << " "
+       << cmOutputConverter::EscapeForCMake(value) << ")\n";
+}
+
+static std::string readFileContent(std::string const& fileName)
+{
+  cmsys::ifstream fin(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return std::string();
+  }
+  return std::string((std::istreambuf_iterator<char>(fin)),
+                     std::istreambuf_iterator<char>());
+}
+
+static std::string resultCacheFile(std::string const& cacheDir,
+                                   std::string const& key)
+{
+  return cacheDir + "/" + key.substr(0, 2) + "/" + key;
+}
+
+static bool loadCachedResult(std::string const& cacheFile, bool& result,
+                             std::string& output)
+{
+  // Only successful results are used.  A failure may come from the
+  // environment, such as a missing header or a compiler that could not
+  // run, and must not stick in every build tree sharing the cache.
+  cmsys::ifstream fin(cacheFile.c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  if (!fin || !cmSystemTools::GetLineFromStream(fin, line) ||
+      line != "TRUE") {
+    return false;
+  }
+  result = true;
+  output.assign((std::istreambuf_iterator<char>(fin)),
+                std::istreambuf_iterator<char>());
+  return true;
+}
+
+static void storeCachedResult(std::string const& cacheFile,
+                              std::string const& output)
+{
+  // Build trees sharing the cache may read the entry at any time, so
+  // write it under a temporary name first.
+  cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(cacheFile));
+  std::string const tmpFile =
+    cacheFile + ".tmp" + std::to_string(cmSystemTools::RandomSeed());
+  bool written;
+  {
+    cmsys::ofstream fout(tmpFile.c_str(), std::ios::out | std::ios::binary);
+    fout << "TRUE\n" << output;
+    fout.close();
+    written = static_cast<bool>(fout);
+  }
+  if (!written ||
+      !cmSystemTools::RenameFile(tmpFile.c_str(), cacheFile.c_str())) {
+    cmSystemTools::RemoveFile(tmpFile);
+  }
+}
+
+// Check that every placeholder of a rule is among the given ones.
+static bool ruleUsesOnly(std::string const& rule,
+                         std::set<std::string> const& placeholders)
+{
+  for (std::string::size_type start = rule.find('<');
+       start != std::string::npos; start = rule.find('<', start + 1)) {
+    std::string::size_type const end = rule.find('>', start);
+    if (end == std::string::npos) {
+      break;
+    }
+    if (start + 1 < rule.size() && isalpha(rule[start + 1]) &&
+        placeholders.find(rule.substr(start + 1, end - start - 1)) ==
+          placeholders.end()) {
+      return false;
+    }
+  }
+  return true;
 }
 
 std::string cmCoreTryCompile::LookupStdVar(std::string const& var,
@@ -136,8 +233,10 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   bool didCExtensions = false;
   bool didCxxExtensions = false;
   bool didCudaExtensions = false;
+  bool didEachSourceResults = false;
   bool useSources = argv[2] == "SOURCES";
   std::vector<std::string> sources;
+  std::vector<std::string> eachSourceResults;
 
   enum Doing
   {
@@ -157,7 +256,8 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     DoingCExtensions,
     DoingCxxExtensions,
     DoingCudaExtensions,
-    DoingSources
+    DoingSources,
+    DoingEachSourceResults
   };
   Doing doing = useSources ? DoingSources : DoingNone;
   for (size_t i = 3; i < argv.size(); ++i) {
@@ -204,6 +304,9 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     } else if (argv[i] == "CUDA_EXTENSIONS") {
       doing = DoingCudaExtensions;
       didCudaExtensions = true;
+    } else if (argv[i] == "EACH_SOURCE_RESULTS") {
+      doing = DoingEachSourceResults;
+      didEachSourceResults = true;
     } else if (doing == DoingCMakeFlags) {
       cmakeFlags.push_back(argv[i]);
     } else if (doing == DoingCompileDefinitions) {
@@ -275,6 +378,8 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       doing = DoingNone;
     } else if (doing == DoingSources) {
       sources.push_back(argv[i]);
+    } else if (doing == DoingEachSourceResults) {
+      eachSourceResults.push_back(argv[i]);
     } else if (i == 3) {
       this->SrcFileSignature = false;
       projectName = argv[i].c_str();
@@ -320,6 +425,29 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     return -1;
   }
 
+  if (didEachSourceResults) {
+    if (isTryRun || !useSources) {
+      this->Makefile->IssueMessage(
+        cmake::FATAL_ERROR,
+        "EACH_SOURCE_RESULTS may be used only with the SOURCES signature "
+        "of try_compile");
+      return -1;
+    }
+    if (eachSourceResults.size() != sources.size()) {
+      this->Makefile->IssueMessage(
+        cmake::FATAL_ERROR,
+        "EACH_SOURCE_RESULTS must be followed by one variable name for each "
+        "source file");
+      return -1;
+    }
+    if (didCopyFile) {
+      this->Makefile->IssueMessage(
+        cmake::FATAL_ERROR,
+        "COPY_FILE may not be used with EACH_SOURCE_RESULTS");
+      return -1;
+    }
+  }
+
   if (didCStandard && !this->SrcFileSignature) {
     this->Makefile->IssueMessage(
       cmake::FATAL_ERROR, "C_STANDARD allowed only in source file signature.");
@@ -407,6 +535,10 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   }
 
   std::string outFileName = this->BinaryDirectory + "/CMakeLists.txt";
+  std::vector<TryCompileTarget> tcTargets;
+  std::string cacheDir;
+  std::string directLang;
+  std::string output;
   // which signature are we using? If we are using var srcfile bindir
   if (this->SrcFileSignature) {
     // remove any CMakeCache.txt files so we will have a clean test
@@ -660,25 +792,18 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       /* Put the executable at a known location (for COPY_FILE).  */
       fprintf(fout, "set(CMAKE_RUNTIME_OUTPUT_DIRECTORY \"%s\")\n",
               this->BinaryDirectory.c_str());
-      /* Create the actual executable.  */
-      fprintf(fout, "add_executable(%s", targetName.c_str());
     } else // if (targetType == cmStateEnums::STATIC_LIBRARY)
     {
       /* Put the static library at a known location (for COPY_FILE).  */
       fprintf(fout, "set(CMAKE_ARCHIVE_OUTPUT_DIRECTORY \"%s\")\n",
               this->BinaryDirectory.c_str());
-      /* Create the actual static library.  */
-      fprintf(fout, "add_library(%s STATIC", targetName.c_str());
     }
     for (std::string const& si : sources) {
-      fprintf(fout, " \"%s\"", si.c_str());
-
       // Add dependencies on any non-temporary sources.
       if (si.find("CMakeTmp") == std::string::npos) {
         this->Makefile->AddCMakeDependFile(si);
       }
     }
-    fprintf(fout, ")\n");
 
     bool const testC = testLangs.find("C") != testLangs.end();
     bool const testCxx = testLangs.find("CXX") != testLangs.end();
@@ -768,68 +893,284 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       this->Makefile->IssueMessage(cmake::AUTHOR_WARNING, w.str());
     }
 
-    if (testC) {
-      if (!cStandard.empty()) {
-        writeProperty(fout, targetName, "C_STANDARD", cStandard);
+    // Write the code of a target building the given sources.
+    auto targetCode = [&](std::string const& name,
+                          std::vector<std::string> const& srcs) {
+      std::ostringstream code;
+      if (targetType == cmStateEnums::EXECUTABLE) {
+        /* Create the actual executable.  */
+        code << "add_executable(" << name;
+      } else // if (targetType == cmStateEnums::STATIC_LIBRARY)
+      {
+        /* Create the actual static library.  */
+        code << "add_library(" << name << " STATIC";
       }
-      if (!cStandardRequired.empty()) {
-        writeProperty(fout, targetName, "C_STANDARD_REQUIRED",
-                      cStandardRequired);
+      for (std::string const& si : srcs) {
+        code << " \"" << si << "\"";
       }
-      if (!cExtensions.empty()) {
-        writeProperty(fout, targetName, "C_EXTENSIONS", cExtensions);
+      code << ")\n";
+
+      if (testC) {
+        if (!cStandard.empty()) {
+          writeProperty(code, name, "C_STANDARD", cStandard);
+        }
+        if (!cStandardRequired.empty()) {
+          writeProperty(code, name, "C_STANDARD_REQUIRED", cStandardRequired);
+        }
+        if (!cExtensions.empty()) {
+          writeProperty(code, name, "C_EXTENSIONS", cExtensions);
+        }
       }
-    }
 
-    if (testCxx) {
-      if (!cxxStandard.empty()) {
-        writeProperty(fout, targetName, "CXX_STANDARD", cxxStandard);
+      if (testCxx) {
+        if (!cxxStandard.empty()) {
+          writeProperty(code, name, "CXX_STANDARD", cxxStandard);
+        }
+        if (!cxxStandardRequired.empty()) {
+          writeProperty(code, name, "CXX_STANDARD_REQUIRED",
+                        cxxStandardRequired);
+        }
+        if (!cxxExtensions.empty()) {
+          writeProperty(code, name, "CXX_EXTENSIONS", cxxExtensions);
+        }
       }
-      if (!cxxStandardRequired.empty()) {
-        writeProperty(fout, targetName, "CXX_STANDARD_REQUIRED",
-                      cxxStandardRequired);
+
+      if (testCuda) {
+        if (!cudaStandard.empty()) {
+          writeProperty(code, name, "CUDA_STANDARD", cudaStandard);
+        }
+        if (!cudaStandardRequired.empty()) {
+          writeProperty(code, name, "CUDA_STANDARD_REQUIRED",
+                        cudaStandardRequired);
+        }
+        if (!cudaExtensions.empty()) {
+          writeProperty(code, name, "CUDA_EXTENSIONS", cudaExtensions);
+        }
       }
-      if (!cxxExtensions.empty()) {
-        writeProperty(fout, targetName, "CXX_EXTENSIONS", cxxExtensions);
+
+      if (useOldLinkLibs) {
+        code << "target_link_libraries(" << name << " ${LINK_LIBRARIES})\n";
+      } else {
+        code << "target_link_libraries(" << name << " " << libsToLink
+             << ")\n";
+      }
+      return code.str();
+    };
+
+    // Build all sources in one target, or each source in its own target
+    // for EACH_SOURCE_RESULTS.
+    if (didEachSourceResults) {
+      for (size_t i = 0; i < sources.size(); ++i) {
+        TryCompileTarget t;
+        t.Name = targetName + "_" + std::to_string(i);
+        t.Sources.push_back(sources[i]);
+        tcTargets.push_back(std::move(t));
       }
+    } else {
+      TryCompileTarget t;
+      t.Name = targetName;
+      t.Sources = sources;
+      tcTargets.push_back(std::move(t));
+    }
+
+    // A single C or C++ source built for the default configuration with
+    // nothing else to link may be compiled and linked directly by the
+    // rules of this project instead of a generated build system.  Keep
+    // the test project when debugging it.
+    if (sources.size() == 1 && !didEachSourceResults && targets.empty() &&
+        libsToLink == " " && (testC || testCxx) && cStandard.empty() &&
+        cStandardRequired.empty() && cExtensions.empty() &&
+        cxxStandard.empty() && cxxStandardRequired.empty() &&
+        cxxExtensions.empty() && tcConfig.empty() &&
+        this->Makefile->GetSafeDefinition("CMAKE_BUILD_TYPE_INIT").empty() &&
+        (targetType == cmStateEnums::STATIC_LIBRARY ||
+         this->Makefile->GetPolicyStatus(cmPolicies::CMP0056) ==
+           cmPolicies::NEW) &&
+        !gg->IsMultiConfig() &&
+        (gg->GetName() == "Ninja" ||
+         gg->GetName().find("Makefiles") != std::string::npos) &&
+        !this->Makefile->IsOn("APPLE") &&
+        !this->Makefile->GetCMakeInstance()->GetDebugTryCompile()) {
+      directLang = *testLangs.begin();
     }
 
-    if (testCuda) {
-      if (!cudaStandard.empty()) {
-        writeProperty(fout, targetName, "CUDA_STANDARD", cudaStandard);
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    // Results of probes that do not run or copy what they build may be
+    // stored in a result cache shared by the build trees on this machine.
+    std::string keyPrefix;
+    if (!isTryRun && !didCopyFile) {
+      if (const char* dir =
+            this->Makefile->GetDefinition("CMAKE_TRY_COMPILE_CACHE_DIR")) {
+        cacheDir = dir;
+      } else {
+        cmSystemTools::GetEnv("CMAKE_TRY_COMPILE_CACHE_DIR", cacheDir);
+      }
+      if (!cacheDir.empty()) {
+        cacheDir = cmSystemTools::CollapseFullPath(
+          cacheDir, this->Makefile->GetCurrentBinaryDirectory());
       }
-      if (!cudaStandardRequired.empty()) {
-        writeProperty(fout, targetName, "CUDA_STANDARD_REQUIRED",
-                      cudaStandardRequired);
+    }
+    if (!cacheDir.empty()) {
+      // The key covers the compiler, the code of the project and the
+      // content of the sources.  Other inputs, such as headers found on
+      // the include path, are not part of it.
+      fflush(fout);
+      std::ostringstream prefix;
+      prefix << "cmake " << cmVersion::GetCMakeVersion() << "\n"
+             << "generator " << gg->GetName() << "\n"
+             << "platform "
+             << this->Makefile->GetSafeDefinition("CMAKE_GENERATOR_PLATFORM")
+             << "\n"
+             << "toolset "
+             << this->Makefile->GetSafeDefinition("CMAKE_GENERATOR_TOOLSET")
+             << "\n"
+             << "config " << tcConfig << "\n";
+      for (std::string const& li : testLangs) {
+        std::string const compiler =
+          this->Makefile->GetSafeDefinition("CMAKE_" + li + "_COMPILER");
+        prefix << "compiler " << li << " " << compiler << " "
+               << this->Makefile->GetSafeDefinition("CMAKE_" + li +
+                                                    "_COMPILER_ID")
+               << " "
+               << this->Makefile->GetSafeDefinition("CMAKE_" + li +
+                                                    "_COMPILER_VERSION");
+        // Notice a compiler replaced in place.
+        if (cmSystemTools::FileExists(compiler, true)) {
+          prefix << " " << cmSystemTools::FileLength(compiler) << " "
+                 << cmSystemTools::ModifiedTime(compiler);
+        }
+        prefix << "\n";
       }
-      if (!cudaExtensions.empty()) {
-        writeProperty(fout, targetName, "CUDA_EXTENSIONS", cudaExtensions);
+      for (size_t i = 1; i < cmakeFlags.size(); ++i) {
+        prefix << "flag " << cmakeFlags[i] << "\n";
       }
+      if (!targets.empty()) {
+        prefix << readFileContent(this->BinaryDirectory + "/" + targetName +
+                                  "Targets.cmake");
+      }
+      prefix << readFileContent(outFileName);
+      keyPrefix = prefix.str();
     }
+#endif
 
-    if (useOldLinkLibs) {
-      fprintf(fout, "target_link_libraries(%s ${LINK_LIBRARIES})\n",
-              targetName.c_str());
-    } else {
-      fprintf(fout, "target_link_libraries(%s %s)\n", targetName.c_str(),
-              libsToLink.c_str());
+    for (TryCompileTarget& t : tcTargets) {
+      std::string const code = targetCode(t.Name, t.Sources);
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+      if (!keyPrefix.empty()) {
+        // Replace the names of the temporary directory and target so that
+        // equal probes share their key.
+        std::string keyText = keyPrefix + code;
+        for (std::string const& si : t.Sources) {
+          keyText += "source " + si + "\n" + readFileContent(si);
+        }
+        cmSystemTools::ReplaceString(keyText, this->BinaryDirectory,
+                                     "<CMakeTmp>");
+        cmSystemTools::ReplaceString(keyText, t.Name, "<target>");
+        cmSystemTools::ReplaceString(keyText, targetName, "<target>");
+        t.CacheKey =
+          cmCryptoHash(cmCryptoHash::AlgoSHA256).HashString(keyText);
+
+        // Build the test project anyway when debugging it.
+        std::string const cacheFile = resultCacheFile(cacheDir, t.CacheKey);
+        std::string cachedOutput;
+        if (!this->Makefile->GetCMakeInstance()->GetDebugTryCompile() &&
+            loadCachedResult(cacheFile, t.Result, cachedOutput)) {
+          t.Cached = true;
+          output += "Loaded try_compile result from cache entry\n  " +
+            cacheFile + "\n" + cachedOutput;
+          continue;
+        }
+      }
+#endif
+      fputs(code.c_str(), fout);
     }
+
     fclose(fout);
     projectName = "CMAKE_TRY_COMPILE";
   }
 
+  // The project files were written directly, so drop what the stat
+  // cache knows about the directory before the test project reads it.
+  cmSystemTools::InvalidateStatCache(this->BinaryDirectory);
+
   bool erroroc = cmSystemTools::GetErrorOccuredFlag();
   cmSystemTools::ResetErrorOccuredFlag();
-  std::string output;
-  // actually do the try compile now that everything is setup
-  int res = this->Makefile->TryCompile(
-    sourceDirectory, this->BinaryDirectory, projectName, targetName,
-    this->SrcFileSignature, cmake::NO_BUILD_PARALLEL_LEVEL, &cmakeFlags,
-    output);
+  // actually do the try compile now that everything is setup, unless
+  // all results came from the cache
+  int res = 0;
+  std::string buildOutput;
+  bool built = false;
+  if (!directLang.empty() && !tcTargets.front().Cached) {
+    TryCompileTarget const& t = tcTargets.front();
+    bool result = false;
+    if (this->TryCompileDirect(directLang, t.Sources.front(), t.Name,
+                               targetType, cmakeFlags, compileDefs, result,
+                               buildOutput)) {
+      res = result ? 0 : 1;
+      built = true;
+    }
+  }
+  if (!built &&
+      (!this->SrcFileSignature ||
+       std::any_of(tcTargets.begin(), tcTargets.end(),
+                   [](TryCompileTarget const& t) { return !t.Cached; }))) {
+    // Build the targets of EACH_SOURCE_RESULTS in parallel and do not
+    // stop at the first one that fails.
+    int jobs = cmake::NO_BUILD_PARALLEL_LEVEL;
+    std::string buildTarget = targetName;
+    if (didEachSourceResults) {
+      jobs =
+        static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+      buildTarget.clear();
+    }
+    res = this->Makefile->TryCompile(
+      sourceDirectory, this->BinaryDirectory, projectName, buildTarget,
+      this->SrcFileSignature, jobs, didEachSourceResults, &cmakeFlags,
+      buildOutput);
+  }
+  // Do not cache results of a build that could not run.
+  bool const buildError = cmSystemTools::GetErrorOccuredFlag() ||
+    cmSystemTools::GetFatalErrorOccured();
   if (erroroc) {
     cmSystemTools::SetErrorOccured();
   }
 
+  if (this->SrcFileSignature) {
+    cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
+    bool allResults = true;
+    for (size_t i = 0; i < tcTargets.size(); ++i) {
+      TryCompileTarget& t = tcTargets[i];
+      if (!t.Cached) {
+        if (didEachSourceResults) {
+          this->FindOutputFile(t.Name, targetType);
+          if (this->OutputFile.empty() && res != 0 &&
+              gg->GetKeepGoingBuildOptions().empty()) {
+            // The build tool may have stopped before this target.
+            gg->TryCompile(cmake::NO_BUILD_PARALLEL_LEVEL, sourceDirectory,
+                           this->BinaryDirectory, projectName, t.Name, true,
+                           false, buildOutput, this->Makefile);
+            this->FindOutputFile(t.Name, targetType);
+          }
+          t.Result = !this->OutputFile.empty();
+        } else {
+          t.Result = res == 0;
+        }
+        if (t.Result && !t.CacheKey.empty() && !buildError) {
+          storeCachedResult(resultCacheFile(cacheDir, t.CacheKey),
+                            buildOutput);
+        }
+      }
+      if (didEachSourceResults) {
+        this->Makefile->AddCacheDefinition(
+          eachSourceResults[i], (t.Result ? "TRUE" : "FALSE"),
+          "Result of TRY_COMPILE", cmStateEnums::INTERNAL);
+      }
+      allResults = allResults && t.Result;
+    }
+    res = allResults ? 0 : 1;
+  }
+  output += buildOutput;
+
   // set the result var to the return value to indicate success or failure
   this->Makefile->AddCacheDefinition(argv[0], (res == 0 ? "TRUE" : "FALSE"),
                                      "Result of TRY_COMPILE",
@@ -872,6 +1213,288 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   return res;
 }
 
+bool cmCoreTryCompile::TryCompileDirect(
+  std::string const& lang, std::string const& source,
+  std::string const& targetName, cmStateEnums::TargetType targetType,
+  std::vector<std::string> const& cmakeFlags,
+  std::vector<std::string> const& compileDefs, bool& result,
+  std::string& output)
+{
+  cmMakefile* mf = this->Makefile;
+
+  // The test project may be given only its definitions and include
+  // directories.
+  std::string compileDefinitions;
+  std::vector<std::string> includes;
+  for (size_t i = 1; i < cmakeFlags.size(); ++i) {
+    std::string const& flag = cmakeFlags[i];
+    std::string::size_type const eq = flag.find('=');
+    if (flag.empty()) {
+      continue;
+    }
+    if (flag.compare(0, 2, "-D") != 0 || eq == std::string::npos) {
+      return false;
+    }
+    std::string name = flag.substr(2, eq - 2);
+    name = name.substr(0, name.find(':'));
+    std::string const value = flag.substr(eq + 1);
+    if (name == "COMPILE_DEFINITIONS") {
+      compileDefinitions = value;
+    } else if (name == "INCLUDE_DIRECTORIES") {
+      cmSystemTools::ExpandListArgument(value, includes);
+    } else if ((name != "LINK_DIRECTORIES" && name != "LINK_LIBRARIES") ||
+               !value.empty()) {
+      return false;
+    }
+  }
+  if (mf->GetDefinition("CMAKE_INCLUDE_FLAG_SEP_" + lang) ||
+      mf->GetDefinition("CMAKE_QUOTE_INCLUDE_PATHS")) {
+    return false;
+  }
+
+  // Look up the rules.
+  std::string const compilerVar = "CMAKE_" + lang + "_COMPILER";
+  std::vector<std::string> compileRules;
+  cmSystemTools::ExpandListArgument(
+    mf->GetSafeDefinition("CMAKE_" + lang + "_COMPILE_OBJECT"), compileRules);
+  std::vector<std::string> linkRules;
+  std::set<std::string> linkPlaceholders;
+  if (targetType == cmStateEnums::EXECUTABLE) {
+    cmSystemTools::ExpandListArgument(
+      mf->GetSafeDefinition("CMAKE_" + lang + "_LINK_EXECUTABLE"), linkRules);
+    linkPlaceholders = { compilerVar, "CMAKE_" + lang + "_LINK_FLAGS",
+                         "CMAKE_LINKER", "FLAGS", "LINK_FLAGS",
+                         "LINK_LIBRARIES", "OBJECTS", "TARGET" };
+  } else {
+    // Use the archive rules as the Makefile generator does.
+    const char* arCreate =
+      mf->GetDefinition("CMAKE_" + lang + "_ARCHIVE_CREATE");
+    if (arCreate && mf->GetDefinition("CMAKE_" + lang + "_ARCHIVE_APPEND")) {
+      cmSystemTools::ExpandListArgument(arCreate, linkRules);
+      cmSystemTools::ExpandListArgument(
+        mf->GetSafeDefinition("CMAKE_" + lang + "_ARCHIVE_FINISH"),
+        linkRules);
+    } else {
+      cmSystemTools::ExpandListArgument(
+        mf->GetSafeDefinition("CMAKE_" + lang + "_CREATE_STATIC_LIBRARY"),
+        linkRules);
+    }
+    linkPlaceholders = { "CMAKE_AR", "CMAKE_RANLIB", "LINK_FLAGS", "OBJECTS",
+                         "TARGET" };
+  }
+  std::set<std::string> const compilePlaceholders = {
+    compilerVar, "DEFINES", "FLAGS", "INCLUDES", "OBJECT", "SOURCE"
+  };
+  if (compileRules.empty() || linkRules.empty()) {
+    return false;
+  }
+  for (std::string const& rule : compileRules) {
+    if (!ruleUsesOnly(rule, compilePlaceholders)) {
+      return false;
+    }
+  }
+  for (std::string const& rule : linkRules) {
+    if (!ruleUsesOnly(rule, linkPlaceholders)) {
+      return false;
+    }
+  }
+
+  // Compute the flags the generators would put in the test project.
+  cmOutputConverter converter(mf->GetStateSnapshot());
+  auto appendFlags = [](std::string& flags, std::string const& newFlags) {
+    if (!newFlags.empty()) {
+      if (!flags.empty()) {
+        flags += " ";
+      }
+      flags += newFlags;
+    }
+  };
+  std::string langFlags = mf->GetSafeDefinition("CMAKE_" + lang + "_FLAGS");
+  langFlags += " " + compileDefinitions;
+  std::string extensionFlags;
+  if (mf->GetDefinition("CMAKE_" + lang + "_STANDARD_DEFAULT")) {
+    std::vector<std::string> options;
+    cmSystemTools::ExpandListArgument(
+      mf->GetSafeDefinition("CMAKE_" + lang + "_EXTENSION_COMPILE_OPTION"),
+      options);
+    for (std::string const& option : options) {
+      appendFlags(extensionFlags, converter.EscapeForShell(option));
+    }
+  }
+
+  std::string compileFlags = langFlags;
+  std::set<std::string> defines;
+  const char* df = mf->GetDefinition("CMAKE_" + lang + "_DEFINE_FLAG");
+  std::string const defineFlag = (df && *df) ? df : "-D";
+  cmsys::RegularExpression valid("^[-/]D[A-Za-z_][A-Za-z0-9_]*(=.*)?$");
+  for (std::string const& def : compileDefs) {
+    // The test project passes the definitions to add_definitions() in
+    // one string, so they must not change when parsed back.
+    if (def.find_first_of(" \t\n\"#$();[\\]") != std::string::npos) {
+      return false;
+    }
+    if (def.empty()) {
+      continue;
+    }
+    if (valid.find(def)) {
+      defines.insert(def.substr(2));
+    } else {
+      appendFlags(compileFlags, def);
+    }
+  }
+  appendFlags(compileFlags, extensionFlags);
+  std::string definesFlags;
+  for (std::string const& def : defines) {
+    std::string::size_type const eq = def.find('=');
+    std::string flag = defineFlag + def.substr(0, eq);
+    if (eq != std::string::npos) {
+      flag += "=" + converter.EscapeForShell(def.substr(eq + 1), true);
+    }
+    appendFlags(definesFlags, flag);
+  }
+
+  std::string includeFlags;
+  {
+    std::vector<std::string> implicitDirs;
+    cmSystemTools::ExpandListArgument(
+      mf->GetSafeDefinition("CMAKE_" + lang + "_IMPLICIT_INCLUDE_DIRECTORIES"),
+      implicitDirs);
+    std::set<std::string> emitted(implicitDirs.begin(), implicitDirs.end());
+    std::string const includeFlag =
+      mf->GetSafeDefinition("CMAKE_INCLUDE_FLAG_" + lang);
+    for (std::string const& dir : includes) {
+      std::string const fullDir =
+        cmSystemTools::CollapseFullPath(dir, this->BinaryDirectory);
+      if (emitted.insert(fullDir).second) {
+        appendFlags(includeFlags,
+                    includeFlag +
+                      converter.ConvertToOutputFormat(
+                        fullDir, cmOutputConverter::SHELL));
+      }
+    }
+  }
+
+  std::string linkFlags;
+  std::string linkLibs;
+  std::string target = this->BinaryDirectory + "/";
+  if (targetType == cmStateEnums::EXECUTABLE) {
+    appendFlags(linkFlags, mf->GetSafeDefinition("CMAKE_EXE_LINKER_FLAGS"));
+    appendFlags(linkFlags, mf->GetSafeDefinition("CMAKE_CREATE_CONSOLE_EXE"));
+    if (mf->GetPolicyStatus(cmPolicies::CMP0065) != cmPolicies::NEW &&
+        mf->GetState()->GetGlobalPropertyAsBool(
+          "TARGET_SUPPORTS_SHARED_LIBS")) {
+      appendFlags(linkFlags,
+                  mf->GetSafeDefinition("CMAKE_SHARED_LIBRARY_LINK_" + lang +
+                                        "_FLAGS"));
+    }
+    linkLibs = mf->GetSafeDefinition("CMAKE_" + lang + "_STANDARD_LIBRARIES");
+    target += targetName + mf->GetSafeDefinition("CMAKE_EXECUTABLE_SUFFIX");
+  } else {
+    appendFlags(linkFlags,
+                mf->GetSafeDefinition("CMAKE_STATIC_LINKER_FLAGS"));
+    target += mf->GetSafeDefinition("CMAKE_STATIC_LIBRARY_PREFIX") +
+      targetName + mf->GetSafeDefinition("CMAKE_STATIC_LIBRARY_SUFFIX");
+  }
+  std::string linkLangFlags;
+  if (mf->IsOn("CMAKE_" + lang + "_LINK_WITH_STANDARD_COMPILE_OPTION")) {
+    appendFlags(linkLangFlags, extensionFlags);
+  }
+  appendFlags(linkLangFlags, langFlags);
+
+  // Expand the rules.
+  std::string const objectDir =
+    this->BinaryDirectory + "/CMakeFiles/" + targetName + ".dir";
+  std::string const object = objectDir + "/" +
+    cmSystemTools::GetFilenameName(source) +
+    mf->GetSafeDefinition("CMAKE_" + lang + "_OUTPUT_EXTENSION");
+  std::string const sourceArg =
+    converter.ConvertToOutputFormat(source, cmOutputConverter::SHELL);
+  std::string const objectArg =
+    converter.ConvertToOutputFormat(object, cmOutputConverter::SHELL);
+  std::string const targetArg =
+    converter.ConvertToOutputFormat(target, cmOutputConverter::SHELL);
+
+  std::map<std::string, std::string> compilers;
+  compilers[compilerVar] = lang;
+  std::map<std::string, std::string> variableMappings;
+  for (std::string const& var :
+       { compilerVar, compilerVar + "_ARG1", "CMAKE_" + lang + "_LINK_FLAGS",
+         std::string("CMAKE_AR"), std::string("CMAKE_RANLIB"),
+         std::string("CMAKE_LINKER") }) {
+    variableMappings[var] = mf->GetSafeDefinition(var);
+  }
+  cmRulePlaceholderExpander expander(compilers, variableMappings,
+                                     std::string(), std::string());
+
+  cmRulePlaceholderExpander::RuleVariables vars;
+  vars.CMTargetName = targetName.c_str();
+  vars.CMTargetType = cmState::GetTargetTypeName(targetType);
+  vars.Language = lang.c_str();
+  vars.Source = sourceArg.c_str();
+  vars.Object = objectArg.c_str();
+  vars.Defines = definesFlags.c_str();
+  vars.Includes = includeFlags.c_str();
+  vars.Flags = compileFlags.c_str();
+  std::vector<std::string> commands;
+  for (std::string rule : compileRules) {
+    expander.ExpandRuleVariables(&converter, rule, vars);
+    commands.push_back(std::move(rule));
+  }
+
+  vars.Source = nullptr;
+  vars.Object = nullptr;
+  vars.Defines = nullptr;
+  vars.Includes = nullptr;
+  vars.Objects = objectArg.c_str();
+  vars.Target = targetArg.c_str();
+  vars.LinkLibraries = linkLibs.c_str();
+  vars.Flags = linkLangFlags.c_str();
+  vars.LinkFlags = linkFlags.c_str();
+  for (std::string rule : linkRules) {
+    expander.ExpandRuleVariables(&converter, rule, vars);
+    commands.push_back(std::move(rule));
+  }
+
+  // Commands that need a shell to interpret them are left to the
+  // generated build system.
+  bool const windowsShell = mf->GetState()->UseWindowsShell();
+  std::vector<std::vector<std::string>> commandArgs;
+  for (std::string const& command : commands) {
+    if (command.find_first_of("\n!#$%&()*;<>?[]`{|}~") != std::string::npos) {
+      return false;
+    }
+    std::vector<std::string> args;
+    if (windowsShell) {
+      cmSystemTools::ParseWindowsCommandLine(command.c_str(), args);
+    } else {
+      cmSystemTools::ParseUnixCommandLine(command.c_str(), args);
+    }
+    if (args.empty()) {
+      return false;
+    }
+    commandArgs.push_back(std::move(args));
+  }
+
+  // Run the commands in the order of the rules.
+  cmSystemTools::MakeDirectory(objectDir);
+  cmSystemTools::RemoveFile(target);
+  output += "Change Dir: " + this->BinaryDirectory + "\n\n";
+  result = true;
+  for (size_t i = 0; i < commands.size() && result; ++i) {
+    output += commands[i];
+    output += "\n";
+    std::string commandOutput;
+    int retVal = 0;
+    result = cmSystemTools::RunSingleCommand(
+               commandArgs[i], &commandOutput, &commandOutput, &retVal,
+               this->BinaryDirectory.c_str(), cmSystemTools::OUTPUT_NONE,
+               mf->GetGlobalGenerator()->TryCompileTimeout) &&
+      retVal == 0;
+    output += commandOutput;
+  }
+  return true;
+}
+
 void cmCoreTryCompile::CleanupFiles(std::string const& binDir)
 {
   if (binDir.empty()) {
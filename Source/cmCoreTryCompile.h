@@ -43,6 +43,19 @@ protected:
   void FindOutputFile(const std::string& targetName,
                       cmStateEnums::TargetType targetType);
 
+  /**
+   * Build the single source of a simple source file signature by running
+   * the compile and link rules of the calling project directly instead
+   * of generating a test project.  Returns false without running anything
+   * if the rules need more than this can provide.
+   */
+  bool TryCompileDirect(std::string const& lang, std::string const& source,
+                        std::string const& targetName,
+                        cmStateEnums::TargetType targetType,
+                        std::vector<std::string> const& cmakeFlags,
+                        std::vector<std::string> const& compileDefs,
+                        bool& result, std::string& output);
+
   std::string BinaryDirectory;
   std::string OutputFile;
   std::string FindErrorMessage;
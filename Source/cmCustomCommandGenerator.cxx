@@ -6,11 +6,14 @@
 #include "cmCustomCommandLines.h"
 #include "cmGeneratorExpression.h"
 #include "cmGeneratorTarget.h"
+#include "cmGlobalGenerator.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
+#include "cmOutputConverter.h"
 #include "cmStateTypes.h"
 #include "cmSystemTools.h"
 
+#include <algorithm>
 #include <memory> // IWYU pragma: keep
 #include <stddef.h>
 #include <utility>
@@ -51,6 +54,11 @@ cmCustomCommandGenerator::cmCustomCommandGenerator(cmCustomCommand const& cc,
     this->CommandLines.push_back(std::move(argv));
   }
 
+  // Run adjacent "cmake -E" steps in one process.
+  if (this->LG->GetGlobalGenerator()->SupportsCMakeCommandSequences()) {
+    this->MergeCMakeCommands();
+  }
+
   std::vector<std::string> depends = this->CC.GetDepends();
   for (std::string const& d : depends) {
     std::unique_ptr<cmCompiledGeneratorExpression> cge = this->GE->Parse(d);
@@ -84,9 +92,70 @@ cmCustomCommandGenerator::~cmCustomCommandGenerator()
   delete this->GE;
 }
 
+static bool cmCustomCommandGeneratorCanMerge(cmCustomCommandLine const& argv,
+                                             std::string const& cmake,
+                                             bool oldStyle)
+{
+  // Only commands that work on files or print text are run in a
+  // sequence.  The sequence separates the commands by "-E" arguments.
+  static const char* const commands[] = {
+    "cmake_echo_color", "cmake_symlink_executable", "cmake_symlink_library",
+    "copy",             "copy_directory",           "copy_if_different",
+    "create_symlink",   "echo",                     "echo_append",
+    "make_directory",   "remove",                   "remove_directory",
+    "rename",           "touch",                    "touch_nocreate"
+  };
+  if (argv.size() < 3 || argv[0] != cmake || argv[1] != "-E" ||
+      std::find(argv.begin() + 2, argv.end(), "-E") != argv.end()) {
+    return false;
+  }
+  // Shell operators are written unquoted, and so are other shell
+  // characters without VERBATIM.  Merging would change what they apply
+  // to, as in "cmake -E touch a || true".
+  for (std::string const& arg : argv) {
+    if (cmOutputConverter::IsShellOperator(arg) ||
+        (oldStyle && arg.find_first_of("&|;<>`") != std::string::npos)) {
+      return false;
+    }
+  }
+  for (const char* command : commands) {
+    if (argv[2] == command) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void cmCustomCommandGenerator::MergeCMakeCommands()
+{
+  std::string const& cmake = cmSystemTools::GetCMakeCommand();
+  cmCustomCommandLines merged;
+  merged.reserve(this->CommandLines.size());
+  bool lastCanMerge = false;
+  for (cmCustomCommandLine& argv : this->CommandLines) {
+    bool const canMerge =
+      cmCustomCommandGeneratorCanMerge(argv, cmake, this->OldStyle);
+    if (canMerge && lastCanMerge) {
+      // Turn the previous command into a sequence and append this one:
+      //   cmake -E __run_sequence -E <command> [args...] -E ...
+      cmCustomCommandLine& sequence = merged.back();
+      if (sequence[2] != "__run_sequence") {
+        sequence.insert(sequence.begin() + 2, "-E");
+        sequence.insert(sequence.begin() + 2, "__run_sequence");
+      }
+      sequence.push_back("-E");
+      sequence.insert(sequence.end(), argv.begin() + 2, argv.end());
+    } else {
+      merged.push_back(std::move(argv));
+    }
+    lastCanMerge = canMerge;
+  }
+  this->CommandLines = std::move(merged);
+}
+
 unsigned int cmCustomCommandGenerator::GetNumberOfCommands() const
 {
-  return static_cast<unsigned int>(this->CC.GetCommandLines().size());
+  return static_cast<unsigned int>(this->CommandLines.size());
 }
 
 const char* cmCustomCommandGenerator::GetCrossCompilingEmulator(
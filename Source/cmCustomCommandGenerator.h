@@ -27,6 +27,7 @@ class cmCustomCommandGenerator
 
   const char* GetCrossCompilingEmulator(unsigned int c) const;
   const char* GetArgv0Location(unsigned int c) const;
+  void MergeCMakeCommands();
 
 public:
   cmCustomCommandGenerator(cmCustomCommand const& cc,
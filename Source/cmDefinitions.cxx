@@ -2,18 +2,62 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmDefinitions.h"
 
+#include <algorithm>
 #include <assert.h>
-#include <set>
+#include <unordered_set>
 #include <utility>
 
+#include "cmSystemTools.h"
+
 cmDefinitions::Def cmDefinitions::NoDef;
 
-cmDefinitions::Def const& cmDefinitions::GetInternal(const std::string& key,
+namespace {
+struct cmDefinitionsKeyTable
+{
+  std::unordered_map<std::string, unsigned int> Ids;
+  std::vector<std::string const*> Names;
+};
+
+cmDefinitionsKeyTable& GetKeyTable()
+{
+  static cmDefinitionsKeyTable table;
+  return table;
+}
+}
+
+bool cmDefinitions::FindKey(const std::string& key, KeyId& id)
+{
+  cmDefinitionsKeyTable const& table = GetKeyTable();
+  auto i = table.Ids.find(key);
+  if (i == table.Ids.end()) {
+    return false;
+  }
+  id = i->second;
+  return true;
+}
+
+cmDefinitions::KeyId cmDefinitions::InternKey(const std::string& key)
+{
+  cmDefinitionsKeyTable& table = GetKeyTable();
+  auto const ins =
+    table.Ids.emplace(key, static_cast<KeyId>(table.Names.size()));
+  if (ins.second) {
+    table.Names.push_back(&ins.first->first);
+  }
+  return ins.first->second;
+}
+
+std::string const& cmDefinitions::GetKeyName(KeyId id)
+{
+  return *GetKeyTable().Names[id];
+}
+
+cmDefinitions::Def const& cmDefinitions::GetInternal(KeyId id,
                                                      StackIter begin,
                                                      StackIter end, bool raise)
 {
   assert(begin != end);
-  MapType::iterator i = begin->Map.find(key);
+  MapType::iterator i = begin->Map.find(id);
   if (i != begin->Map.end()) {
     i->second.Used = true;
     return i->second;
@@ -23,31 +67,62 @@ cmDefinitions::Def const& cmDefinitions::GetInternal(const std::string& key,
   if (it == end) {
     return cmDefinitions::NoDef;
   }
-  Def const& def = cmDefinitions::GetInternal(key, it, end, raise);
+  Def const& def = cmDefinitions::GetInternal(id, it, end, raise);
   if (!raise) {
     return def;
   }
-  return begin->Map.insert(MapType::value_type(key, def)).first->second;
+  return begin->Map.insert(MapType::value_type(id, def)).first->second;
 }
 
 const std::string* cmDefinitions::Get(const std::string& key, StackIter begin,
                                       StackIter end)
 {
-  Def const& def = cmDefinitions::GetInternal(key, begin, end, false);
-  return def.Exists ? &def : nullptr;
+  // A name that was never interned was never set in any scope.
+  KeyId id;
+  if (!cmDefinitions::FindKey(key, id)) {
+    return nullptr;
+  }
+  Def const& def = cmDefinitions::GetInternal(id, begin, end, false);
+  return def.Value.get();
+}
+
+const std::string* cmDefinitions::GetList(const std::string& key,
+                                          StackIter begin, StackIter end,
+                                          cmListElements const*& elements)
+{
+  elements = nullptr;
+  KeyId id;
+  if (!cmDefinitions::FindKey(key, id)) {
+    return nullptr;
+  }
+  Def const& def = cmDefinitions::GetInternal(id, begin, end, false);
+  if (!def.Exists()) {
+    return nullptr;
+  }
+  if (!def.Elements) {
+    auto list = std::make_shared<cmListElements>();
+    cmSystemTools::ExpandListElements(*def.Value, *list);
+    def.Elements = std::move(list);
+  }
+  elements = def.Elements.get();
+  return def.Value.get();
 }
 
 void cmDefinitions::Raise(const std::string& key, StackIter begin,
                           StackIter end)
 {
-  cmDefinitions::GetInternal(key, begin, end, true);
+  cmDefinitions::GetInternal(cmDefinitions::InternKey(key), begin, end, true);
 }
 
 bool cmDefinitions::HasKey(const std::string& key, StackIter begin,
                            StackIter end)
 {
+  KeyId id;
+  if (!cmDefinitions::FindKey(key, id)) {
+    return false;
+  }
   for (StackIter it = begin; it != end; ++it) {
-    MapType::const_iterator i = it->Map.find(key);
+    MapType::const_iterator i = it->Map.find(id);
     if (i != it->Map.end()) {
       return true;
     }
@@ -58,7 +133,7 @@ bool cmDefinitions::HasKey(const std::string& key, StackIter begin,
 void cmDefinitions::Set(const std::string& key, const char* value)
 {
   Def def(value);
-  this->Map[key] = def;
+  this->Map[cmDefinitions::InternKey(key)] = std::move(def);
 }
 
 std::vector<std::string> cmDefinitions::UnusedKeys() const
@@ -68,28 +143,30 @@ std::vector<std::string> cmDefinitions::UnusedKeys() const
   // Consider local definitions.
   for (auto const& mi : this->Map) {
     if (!mi.second.Used) {
-      keys.push_back(mi.first);
+      keys.push_back(cmDefinitions::GetKeyName(mi.first));
     }
   }
+  std::sort(keys.begin(), keys.end());
   return keys;
 }
 
 cmDefinitions cmDefinitions::MakeClosure(StackIter begin, StackIter end)
 {
   cmDefinitions closure;
-  std::set<std::string> undefined;
   for (StackIter it = begin; it != end; ++it) {
-    // Consider local definitions.
+    // Consider local definitions.  Use each key if it is not already
+    // set or unset by an inner scope.  Only the shared values are
+    // copied, not the strings.
     for (auto const& mi : it->Map) {
-      // Use this key if it is not already set or unset.
-      if (closure.Map.find(mi.first) == closure.Map.end() &&
-          undefined.find(mi.first) == undefined.end()) {
-        if (mi.second.Exists) {
-          closure.Map.insert(mi);
-        } else {
-          undefined.insert(mi.first);
-        }
-      }
+      closure.Map.insert(mi);
+    }
+  }
+  // Drop keys whose innermost definition unsets them.
+  for (MapType::iterator i = closure.Map.begin(); i != closure.Map.end();) {
+    if (i->second.Exists()) {
+      ++i;
+    } else {
+      i = closure.Map.erase(i);
     }
   }
   return closure;
@@ -98,15 +175,15 @@ cmDefinitions cmDefinitions::MakeClosure(StackIter begin, StackIter end)
 std::vector<std::string> cmDefinitions::ClosureKeys(StackIter begin,
                                                     StackIter end)
 {
-  std::set<std::string> bound;
+  std::unordered_set<KeyId> bound;
   std::vector<std::string> defined;
 
   for (StackIter it = begin; it != end; ++it) {
     defined.reserve(defined.size() + it->Map.size());
     for (auto const& mi : it->Map) {
       // Use this key if it is not already set or unset.
-      if (bound.insert(mi.first).second && mi.second.Exists) {
-        defined.push_back(mi.first);
+      if (bound.insert(mi.first).second && mi.second.Exists()) {
+        defined.push_back(cmDefinitions::GetKeyName(mi.first));
       }
     }
   }
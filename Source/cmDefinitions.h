@@ -5,11 +5,13 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "cmLinkedTree.h"
+#include "cmListElement.h"
 
 /** \class cmDefinitions
  * \brief Store a scope of variable definitions for CMake language.
@@ -26,6 +28,13 @@ public:
   static const std::string* Get(const std::string& key, StackIter begin,
                                 StackIter end);
 
+  /** Get the value associated with a key and the positions of its
+      elements as a ;-separated list.  The positions are computed once
+      per value and shared by every scope that looks it up.  */
+  static const std::string* GetList(const std::string& key, StackIter begin,
+                                    StackIter end,
+                                    cmListElements const*& elements);
+
   static void Raise(const std::string& key, StackIter begin, StackIter end);
 
   static bool HasKey(const std::string& key, StackIter begin, StackIter end);
@@ -40,41 +49,38 @@ public:
   static cmDefinitions MakeClosure(StackIter begin, StackIter end);
 
 private:
-  // String with existence boolean.
-  struct Def : public std::string
+  // Variable names are interned to integer identifiers so that a lookup
+  // hashes the name once instead of once per scope it visits.
+  typedef unsigned int KeyId;
+  static bool FindKey(const std::string& key, KeyId& id);
+  static KeyId InternKey(const std::string& key);
+  static std::string const& GetKeyName(KeyId id);
+
+  // Value with existence boolean.  The value is shared so that copying
+  // a definition into another scope does not copy the string.
+  struct Def
   {
-  private:
-    typedef std::string std_string;
-
-  public:
     Def()
-      : std_string()
-      , Exists(false)
-      , Used(false)
+      : Used(false)
     {
     }
     Def(const char* v)
-      : std_string(v ? v : "")
-      , Exists(v ? true : false)
-      , Used(false)
-    {
-    }
-    Def(const std_string& v)
-      : std_string(v)
-      , Exists(true)
+      : Value(v ? std::make_shared<std::string const>(v) : nullptr)
       , Used(false)
     {
     }
-    bool Exists;
+    bool Exists() const { return this->Value != nullptr; }
+    std::shared_ptr<std::string const> Value;
+    mutable std::shared_ptr<cmListElements const> Elements;
     bool Used;
   };
   static Def NoDef;
 
-  typedef std::unordered_map<std::string, Def> MapType;
+  typedef std::unordered_map<KeyId, Def> MapType;
   MapType Map;
 
-  static Def const& GetInternal(const std::string& key, StackIter begin,
-                                StackIter end, bool raise);
+  static Def const& GetInternal(KeyId id, StackIter begin, StackIter end,
+                                bool raise);
 };
 
 #endif
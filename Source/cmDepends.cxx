@@ -12,6 +12,7 @@
 #include <sstream>
 #include <string.h>
 #include <utility>
+#include <vector>
 
 cmDepends::cmDepends(cmLocalGenerator* lg, const char* targetDir)
   : LocalGenerator(lg)
@@ -20,14 +21,12 @@ cmDepends::cmDepends(cmLocalGenerator* lg, const char* targetDir)
   , TargetDirectory(targetDir)
   , MaxPath(16384)
   , Dependee(new char[MaxPath])
-  , Depender(new char[MaxPath])
 {
 }
 
 cmDepends::~cmDepends()
 {
   delete[] this->Dependee;
-  delete[] this->Depender;
 }
 
 bool cmDepends::Write(std::ostream& makeDepends, std::ostream& internalDepends)
@@ -113,13 +112,11 @@ bool cmDepends::CheckDependencies(
   std::istream& internalDepends, const char* internalDependsFileName,
   std::map<std::string, DependencyVector>& validDeps)
 {
-  // Parse dependencies from the stream.  If any dependee is missing
-  // or newer than the depender then dependencies should be
-  // regenerated.
-  bool okay = true;
-  bool dependerExists = false;
-  DependencyVector* currentDependencies = nullptr;
-
+  // Parse dependencies from the stream.  Each dependee line belongs to
+  // the depender line preceding it.
+  std::vector<std::string> dependers;
+  std::vector<size_t> firstDependee;
+  cmFileTimeComparison::FilePairs pairs;
   while (internalDepends.getline(this->Dependee, this->MaxPath)) {
     if (this->Dependee[0] == 0 || this->Dependee[0] == '#' ||
         this->Dependee[0] == '\r') {
@@ -131,57 +128,71 @@ bool cmDepends::CheckDependencies(
       this->Dependee[len] = 0;
     }
     if (this->Dependee[0] != ' ') {
-      memcpy(this->Depender, this->Dependee, len + 1);
-      // Calling FileExists() for the depender here saves in many cases 50%
-      // of the calls to FileExists() further down in the loop. E.g. for
-      // kdelibs/khtml this reduces the number of calls from 184k down to 92k,
-      // or the time for cmake -E cmake_depends from 0.3 s down to 0.21 s.
-      dependerExists = cmSystemTools::FileExists(this->Depender);
-      // If we erase validDeps[this->Depender] by overwriting it with an empty
-      // vector, we lose dependencies for dependers that have multiple
-      // entries. No need to initialize the entry, std::map will do so on first
-      // access.
-      currentDependencies = &validDeps[this->Depender];
-      continue;
+      dependers.emplace_back(this->Dependee, len);
+      firstDependee.push_back(pairs.size());
+    } else if (!dependers.empty()) {
+      pairs.emplace_back(dependers.back(), this->Dependee + 1);
     }
-    /*
-    // Parse the dependency line.
-    if(!this->ParseDependency(line.c_str()))
-      {
-      continue;
-      }
-      */
+  }
 
-    // Dependencies must be regenerated
-    // * if the dependee does not exist
-    // * if the depender exists and is older than the dependee.
-    // * if the depender does not exist, but the dependee is newer than the
-    //   depends file
-    bool regenerate = false;
-    const char* dependee = this->Dependee + 1;
-    const char* depender = this->Depender;
-    if (currentDependencies != nullptr) {
-      currentDependencies->push_back(dependee);
+  // Query the modification times of all files in one batch so that each
+  // file is checked only once.  A dependee is compared to its depender,
+  // or to the depends file if the depender does not exist.
+  std::vector<int> results;
+  this->FileComparison->FileTimeCompare(pairs, results);
+  cmFileTimeComparison::FilePairs dependsFilePairs;
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    if (results[i] == cmFileTimeComparison::FirstMissing) {
+      dependsFilePairs.emplace_back(internalDependsFileName, pairs[i].second);
     }
+  }
+  std::vector<int> dependsFileResults;
+  this->FileComparison->FileTimeCompare(dependsFilePairs, dependsFileResults);
 
-    if (!cmSystemTools::FileExists(dependee)) {
-      // The dependee does not exist.
-      regenerate = true;
-
-      // Print verbose output.
-      if (this->Verbose) {
-        std::ostringstream msg;
-        msg << "Dependee \"" << dependee << "\" does not exist for depender \""
-            << depender << "\"." << std::endl;
-        cmSystemTools::Stdout(msg.str().c_str());
+  // Dependencies must be regenerated if any dependee is missing or newer
+  // than the depender.
+  bool okay = true;
+  size_t dependsFileIndex = 0;
+  for (size_t d = 0; d < dependers.size(); ++d) {
+    std::string const& depender = dependers[d];
+    // If we erase validDeps[depender] by overwriting it with an empty
+    // vector, we lose dependencies for dependers that have multiple
+    // entries. No need to initialize the entry, std::map will do so on first
+    // access.
+    DependencyVector* currentDependencies = &validDeps[depender];
+    bool dependerRemoved = false;
+    size_t const end =
+      d + 1 < dependers.size() ? firstDependee[d + 1] : pairs.size();
+    for (size_t i = firstDependee[d]; i < end; ++i) {
+      std::string const& dependee = pairs[i].second;
+      if (currentDependencies != nullptr) {
+        currentDependencies->push_back(dependee);
       }
-    } else {
-      if (dependerExists) {
-        // The dependee and depender both exist.  Compare file times.
-        int result = 0;
-        if ((!this->FileComparison->FileTimeCompare(depender, dependee,
-                                                    &result) ||
-             result < 0)) {
+
+      // Dependencies must be regenerated
+      // * if the dependee does not exist
+      // * if the depender exists and is older than the dependee.
+      // * if the depender does not exist, but the dependee is newer than the
+      //   depends file
+      bool const dependerExists =
+        results[i] != cmFileTimeComparison::FirstMissing;
+      int const result =
+        dependerExists ? results[i] : dependsFileResults[dependsFileIndex++];
+      bool regenerate = false;
+      if (result == cmFileTimeComparison::SecondMissing) {
+        // The dependee does not exist.
+        regenerate = true;
+
+        // Print verbose output.
+        if (this->Verbose) {
+          std::ostringstream msg;
+          msg << "Dependee \"" << dependee
+              << "\" does not exist for depender \"" << depender << "\"."
+              << std::endl;
+          cmSystemTools::Stdout(msg.str().c_str());
+        }
+      } else if (dependerExists) {
+        if (result < 0) {
           // The depender is older than the dependee.
           regenerate = true;
 
@@ -193,42 +204,36 @@ bool cmDepends::CheckDependencies(
             cmSystemTools::Stdout(msg.str().c_str());
           }
         }
-      } else {
-        // The dependee exists, but the depender doesn't. Regenerate if the
-        // internalDepends file is older than the dependee.
-        int result = 0;
-        if ((!this->FileComparison->FileTimeCompare(internalDependsFileName,
-                                                    dependee, &result) ||
-             result < 0)) {
-          // The depends-file is older than the dependee.
-          regenerate = true;
+      } else if (result < 0 || result == cmFileTimeComparison::FirstMissing) {
+        // The dependee exists, but the depender doesn't, and the
+        // depends-file is older than the dependee.
+        regenerate = true;
 
-          // Print verbose output.
-          if (this->Verbose) {
-            std::ostringstream msg;
-            msg << "Dependee \"" << dependee
-                << "\" is newer than depends file \""
-                << internalDependsFileName << "\"." << std::endl;
-            cmSystemTools::Stdout(msg.str().c_str());
-          }
+        // Print verbose output.
+        if (this->Verbose) {
+          std::ostringstream msg;
+          msg << "Dependee \"" << dependee
+              << "\" is newer than depends file \"" << internalDependsFileName
+              << "\"." << std::endl;
+          cmSystemTools::Stdout(msg.str().c_str());
         }
       }
-    }
-    if (regenerate) {
-      // Dependencies must be regenerated.
-      okay = false;
+      if (regenerate) {
+        // Dependencies must be regenerated.
+        okay = false;
 
-      // Remove the information of this depender from the map, it needs
-      // to be rescanned
-      if (currentDependencies != nullptr) {
-        validDeps.erase(this->Depender);
-        currentDependencies = nullptr;
-      }
+        // Remove the information of this depender from the map, it needs
+        // to be rescanned
+        if (currentDependencies != nullptr) {
+          validDeps.erase(depender);
+          currentDependencies = nullptr;
+        }
 
-      // Remove the depender to be sure it is rebuilt.
-      if (dependerExists) {
-        cmSystemTools::RemoveFile(depender);
-        dependerExists = false;
+        // Remove the depender to be sure it is rebuilt.
+        if (dependerExists && !dependerRemoved) {
+          cmSystemTools::RemoveFile(depender);
+          dependerRemoved = true;
+        }
       }
     }
   }
@@ -106,7 +106,6 @@ protected:
 
   size_t MaxPath;
   char* Dependee;
-  char* Depender;
 
   // The include file search path.
   std::vector<std::string> IncludePath;
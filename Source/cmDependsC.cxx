@@ -3,13 +3,23 @@
 #include "cmDependsC.h"
 
 #include "cmsys/FStream.hxx"
+#include "cmsys/SystemTools.hxx"
+#include <functional>
+#include <sstream>
+#include <stdio.h>
+#include <time.h>
 #include <utility>
 
 #include "cmAlgorithms.h"
 #include "cmFileTimeComparison.h"
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#  include "cmFileLock.h"
+#  include "cmFileLockResult.h"
+#endif
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmSystemTools.h"
+#include "cmVersion.h"
 
 #define INCLUDE_REGEX_LINE                                                    \
   "^[ \t]*[#%][ \t]*(include|import)[ \t]*[<\"]([^\">]+)([\">])"
@@ -18,17 +28,35 @@
 #define INCLUDE_REGEX_SCAN_MARKER "#IncludeRegexScan: "
 #define INCLUDE_REGEX_COMPLAIN_MARKER "#IncludeRegexComplain: "
 #define INCLUDE_REGEX_TRANSFORM_MARKER "#IncludeRegexTransform: "
+#define INCLUDE_SCAN_CACHE_MARKER "#IncludeScanCache: "
+
+static bool cmDependsCGetFileStamp(std::string const& path, long long& mtime,
+                                   unsigned long long& size)
+{
+  cmsys::SystemTools::Stat_t st;
+  if (cmsys::SystemTools::Stat(path, &st) != 0) {
+    return false;
+  }
+  mtime = static_cast<long long>(st.st_mtime);
+  size = static_cast<unsigned long long>(st.st_size);
+  return true;
+}
 
 cmDependsC::cmDependsC()
   : ValidDeps(nullptr)
+  , SharedCaches(nullptr)
+  , SharedCache(nullptr)
 {
 }
 
 cmDependsC::cmDependsC(
   cmLocalGenerator* lg, const char* targetDir, const std::string& lang,
-  const std::map<std::string, DependencyVector>* validDeps)
+  const std::map<std::string, DependencyVector>* validDeps,
+  SharedCacheSet* sharedCaches)
   : cmDepends(lg, targetDir)
   , ValidDeps(validDeps)
+  , SharedCaches(sharedCaches)
+  , SharedCache(nullptr)
 {
   cmMakefile* mf = lg->GetMakefile();
 
@@ -70,6 +98,34 @@ cmDependsC::cmDependsC(
   this->CacheFileName += ".includecache";
 
   this->ReadCacheFile();
+
+  // All targets of the build tree scanning with the same rules share
+  // one cache, so each header is scanned once per build.
+  this->SharedCacheHeader = INCLUDE_SCAN_CACHE_MARKER;
+  this->SharedCacheHeader += cmVersion::GetCMakeVersion();
+  this->SharedCacheHeader += "\n";
+  this->SharedCacheHeader += this->IncludeRegexLineString;
+  this->SharedCacheHeader += "\n";
+  this->SharedCacheHeader += this->IncludeRegexScanString;
+  this->SharedCacheHeader += "\n";
+  this->SharedCacheHeader += this->IncludeRegexComplainString;
+  this->SharedCacheHeader += "\n";
+  this->SharedCacheHeader += this->IncludeRegexTransformString;
+  this->SharedCacheHeader += "\n";
+  char hash[32];
+  sprintf(hash, "%08lx",
+          static_cast<unsigned long>(
+            std::hash<std::string>()(this->SharedCacheHeader) & 0xffffffff));
+  this->SharedCacheFileName = lg->GetBinaryDirectory();
+  this->SharedCacheFileName += "/CMakeFiles/IncludeScan-";
+  this->SharedCacheFileName += hash;
+  this->SharedCacheFileName += ".includecache";
+  if (!this->SharedCaches) {
+    this->OwnSharedCaches = cm::make_unique<SharedCacheSet>();
+    this->SharedCaches = this->OwnSharedCaches.get();
+  }
+  this->SharedCache = this->SharedCaches->Get(this->SharedCacheFileName,
+                                              this->SharedCacheHeader);
 }
 
 cmDependsC::~cmDependsC()
@@ -186,12 +242,18 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
         scanned.insert(fullName);
 
         // Check whether this file is already in the cache
+        cmIncludeLines* cached = nullptr;
         std::map<std::string, cmIncludeLines*>::iterator fileIt =
           this->FileCache.find(fullName);
         if (fileIt != this->FileCache.end()) {
-          fileIt->second->Used = true;
+          cached = fileIt->second;
+        } else {
+          cached = this->FindSharedCacheEntry(fullName);
+        }
+        if (cached) {
+          cached->Used = true;
           dependencies.insert(fullName);
-          for (UnscannedEntry const& inc : fileIt->second->UnscannedEntries) {
+          for (UnscannedEntry const& inc : cached->UnscannedEntries) {
             if (this->Encountered.find(inc.FileName) ==
                 this->Encountered.end()) {
               this->Encountered.insert(inc.FileName);
@@ -214,6 +276,7 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
               // containing the file to handle double-quote includes.
               std::string dir = cmSystemTools::GetFilenamePath(fullName);
               this->Scan(fin, dir.c_str(), fullName);
+              this->StoreSharedCacheEntry(fullName);
             } else {
               // Skip file with encoding we do not implement.
             }
@@ -343,6 +406,237 @@ void cmDependsC::WriteCacheFile() const
   }
 }
 
+cmDependsC::cmIncludeLines* cmDependsC::FindSharedCacheEntry(
+  std::string const& fullName)
+{
+  if (!this->SharedCache) {
+    return nullptr;
+  }
+  cmSharedIncludeLines cached;
+  {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    std::lock_guard<std::mutex> lock(this->SharedCaches->Mutex);
+#endif
+    SharedCacheType::const_iterator it =
+      this->SharedCache->Entries.find(fullName);
+    if (it == this->SharedCache->Entries.end()) {
+      return nullptr;
+    }
+    cached = it->second;
+  }
+  long long mtime;
+  unsigned long long size;
+  if (!cmDependsCGetFileStamp(fullName, mtime, size) ||
+      mtime != cached.MTime || size != cached.Size) {
+    return nullptr;
+  }
+  cmIncludeLines* entry = new cmIncludeLines;
+  entry->UnscannedEntries = std::move(cached.UnscannedEntries);
+  this->FileCache[fullName] = entry;
+  return entry;
+}
+
+void cmDependsC::StoreSharedCacheEntry(std::string const& fullName)
+{
+  if (!this->SharedCache) {
+    return;
+  }
+  long long mtime;
+  unsigned long long size;
+  if (!cmDependsCGetFileStamp(fullName, mtime, size)) {
+    return;
+  }
+  // A file modified within the current second may change again
+  // without a visible time stamp change.
+  if (mtime >= static_cast<long long>(time(nullptr))) {
+    return;
+  }
+  cmSharedIncludeLines entry;
+  entry.MTime = mtime;
+  entry.Size = size;
+  entry.UnscannedEntries = this->FileCache[fullName]->UnscannedEntries;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  std::lock_guard<std::mutex> lock(this->SharedCaches->Mutex);
+#endif
+  this->SharedCache->Entries[fullName] = std::move(entry);
+  this->SharedCache->Added.insert(fullName);
+}
+
+cmDependsC::SharedCacheSet::~SharedCacheSet()
+{
+  for (auto& cache : this->Caches) {
+    if (!cache.second.Added.empty()) {
+      Write(cache.first, cache.second);
+    }
+  }
+}
+
+cmDependsC::SharedCacheData* cmDependsC::SharedCacheSet::Get(
+  std::string const& fileName, std::string const& header)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  std::lock_guard<std::mutex> lock(this->Mutex);
+#endif
+  auto ins = this->Caches.emplace(fileName, SharedCacheData());
+  SharedCacheData& data = ins.first->second;
+  if (ins.second) {
+    data.Header = header;
+    Read(fileName, header, data.Entries, &data.Records);
+  } else if (data.Header != header) {
+    // The file name hash collides with that of other scanning rules.
+    return nullptr;
+  }
+  return &data;
+}
+
+bool cmDependsC::SharedCacheSet::Read(std::string const& fileName,
+                                      std::string const& header,
+                                      SharedCacheType& cache, size_t* records)
+{
+  cmsys::ifstream fin(fileName.c_str());
+  if (!fin) {
+    return false;
+  }
+
+  // The header records the rules used to scan the files.
+  std::string line;
+  std::string fileHeader;
+  while (cmSystemTools::GetLineFromStream(fin, line) && !line.empty()) {
+    fileHeader += line;
+    fileHeader += "\n";
+  }
+  if (fileHeader != header) {
+    return false;
+  }
+
+  // Each entry is the file name, its time stamp and size, and pairs of
+  // include lines and quoted locations, followed by an empty line.  A
+  // later entry for the same file replaces an earlier one.  Another
+  // process may be appending an entry, so ignore one that is not
+  // terminated.
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::string stamp;
+    if (!cmSystemTools::GetLineFromStream(fin, stamp)) {
+      return false;
+    }
+    cmSharedIncludeLines entry;
+    std::istringstream stampStream(stamp);
+    if (!(stampStream >> entry.MTime >> entry.Size)) {
+      return false;
+    }
+    std::string name;
+    bool terminated = false;
+    while (cmSystemTools::GetLineFromStream(fin, name)) {
+      if (name.empty()) {
+        terminated = true;
+        break;
+      }
+      UnscannedEntry inc;
+      inc.FileName = name;
+      if (!cmSystemTools::GetLineFromStream(fin, inc.QuotedLocation)) {
+        return false;
+      }
+      if (inc.QuotedLocation == "-") {
+        inc.QuotedLocation.clear();
+      }
+      entry.UnscannedEntries.push_back(std::move(inc));
+    }
+    if (!terminated) {
+      return false;
+    }
+    cache[line] = std::move(entry);
+    if (records) {
+      ++*records;
+    }
+  }
+  return true;
+}
+
+void cmDependsC::SharedCacheSet::WriteEntry(std::ostream& os,
+                                            std::string const& name,
+                                            cmSharedIncludeLines const& entry)
+{
+  os << name << "\n" << entry.MTime << " " << entry.Size << "\n";
+  for (UnscannedEntry const& inc : entry.UnscannedEntries) {
+    os << inc.FileName << "\n"
+       << (inc.QuotedLocation.empty() ? "-" : inc.QuotedLocation) << "\n";
+  }
+  os << "\n";
+}
+
+void cmDependsC::SharedCacheSet::Write(std::string const& fileName,
+                                       SharedCacheData& data)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Scanners of other targets may update the cache at the same time.
+  // The cache is only an optimization, so give up if it stays locked.
+  std::string const lockName = fileName + ".lock";
+  cmSystemTools::Touch(lockName, true);
+  cmFileLock lock;
+  if (!lock.Lock(lockName, 10).IsOk()) {
+    return;
+  }
+
+  // Append the entries scanned here while most of the file is current.
+  // Readers take the last entry for each file.
+  if (data.Records > 0 &&
+      data.Records + data.Added.size() <= 2 * data.Entries.size()) {
+    cmsys::ifstream fin(fileName.c_str());
+    std::string line;
+    std::string fileHeader;
+    while (cmSystemTools::GetLineFromStream(fin, line) && !line.empty()) {
+      fileHeader += line;
+      fileHeader += "\n";
+    }
+    fin.close();
+    if (fileHeader == data.Header) {
+      cmsys::ofstream cacheOut(fileName.c_str(), std::ios::app);
+      for (std::string const& name : data.Added) {
+        WriteEntry(cacheOut, name, data.Entries[name]);
+      }
+      return;
+    }
+  }
+
+  // Otherwise write the current entries of the file and those scanned
+  // here to a private temporary file and rename it so concurrent
+  // readers never see a partially written cache.
+  SharedCacheType cache;
+  Read(fileName, data.Header, cache);
+  for (std::string const& name : data.Added) {
+    cache[name] = std::move(data.Entries[name]);
+  }
+  char suffix[32];
+  sprintf(suffix, ".%08x.tmp", cmSystemTools::RandomSeed());
+  std::string const tempName = fileName + suffix;
+  {
+    cmsys::ofstream cacheOut(tempName.c_str());
+    if (!cacheOut) {
+      return;
+    }
+    cacheOut << data.Header << "\n";
+    for (auto const& entry : cache) {
+      WriteEntry(cacheOut, entry.first, entry.second);
+    }
+    if (!cacheOut) {
+      cacheOut.close();
+      cmSystemTools::RemoveFile(tempName);
+      return;
+    }
+  }
+  if (!cmSystemTools::RenameFile(tempName.c_str(), fileName.c_str())) {
+    cmSystemTools::RemoveFile(tempName);
+  }
+#else
+  // Without a lock concurrent scanners could lose each other's entries.
+  static_cast<void>(fileName);
+  static_cast<void>(data);
+#endif
+}
+
 void cmDependsC::Scan(std::istream& is, const char* directory,
                       const std::string& fullName)
 {
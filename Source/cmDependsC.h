@@ -10,11 +10,16 @@
 #include "cmsys/RegularExpression.hxx"
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <queue>
 #include <set>
 #include <string>
 #include <vector>
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#  include <mutex>
+#endif
+
 class cmLocalGenerator;
 
 /** \class cmDependsC
@@ -25,12 +30,17 @@ class cmDependsC : public cmDepends
   CM_DISABLE_COPY(cmDependsC)
 
 public:
+  class SharedCacheSet;
+
   /** Checking instances need to know the build directory name and the
-      relative path from the build directory to the target file.  */
+      relative path from the build directory to the target file.
+      Scanners of many targets running in one process may share their
+      include caches in memory through a common sharedCaches set.  */
   cmDependsC();
   cmDependsC(cmLocalGenerator* lg, const char* targetDir,
              const std::string& lang,
-             const std::map<std::string, DependencyVector>* validDeps);
+             const std::map<std::string, DependencyVector>* validDeps,
+             SharedCacheSet* sharedCaches = nullptr);
 
   /** Virtual destructor to cleanup subclasses properly.  */
   ~cmDependsC() override;
@@ -95,6 +105,69 @@ protected:
 
   void WriteCacheFile() const;
   void ReadCacheFile();
+
+  // Include lines of files scanned by any target in the build tree,
+  // valid while the file keeps the recorded time stamp and size.
+  struct cmSharedIncludeLines
+  {
+    long long MTime;
+    unsigned long long Size;
+    std::vector<UnscannedEntry> UnscannedEntries;
+  };
+  typedef std::map<std::string, cmSharedIncludeLines> SharedCacheType;
+  struct SharedCacheData
+  {
+    std::string Header;
+    SharedCacheType Entries;
+    // Names of the entries scanned by this process.
+    std::set<std::string> Added;
+    // Number of entries in the file, including outdated ones.
+    size_t Records = 0;
+  };
+  std::unique_ptr<SharedCacheSet> OwnSharedCaches;
+  SharedCacheSet* SharedCaches;
+  SharedCacheData* SharedCache;
+  std::string SharedCacheFileName;
+  std::string SharedCacheHeader;
+
+  cmIncludeLines* FindSharedCacheEntry(std::string const& fullName);
+  void StoreSharedCacheEntry(std::string const& fullName);
+
+public:
+  /** \class SharedCacheSet
+   * \brief Build tree include caches loaded into memory.
+   *
+   * Each cache file is read when the first scanner uses it.  Entries
+   * scanned since are appended to the file when the set is destroyed,
+   * under a lock shared with other processes.  The file is rewritten
+   * only when most of its entries are outdated.  The set may be used
+   * by scanners running on several threads at once.
+   */
+  class SharedCacheSet
+  {
+    CM_DISABLE_COPY(SharedCacheSet)
+
+  public:
+    SharedCacheSet() = default;
+    ~SharedCacheSet();
+
+  private:
+    friend class cmDependsC;
+
+    SharedCacheData* Get(std::string const& fileName,
+                         std::string const& header);
+    static bool Read(std::string const& fileName, std::string const& header,
+                     SharedCacheType& cache, size_t* records = nullptr);
+    static void Write(std::string const& fileName,
+                      SharedCacheData& data);
+    static void WriteEntry(std::ostream& os, std::string const& name,
+                           cmSharedIncludeLines const& entry);
+
+    std::map<std::string, SharedCacheData> Caches;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    std::mutex Mutex;
+#endif
+  };
 };
 
 #endif
@@ -0,0 +1,210 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmDependsCompiler.h"
+
+#include "cmsys/FStream.hxx"
+#include <ios>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+#include "cmFileTimeComparison.h"
+#include "cmGeneratedFileStream.h"
+#include "cmSystemTools.h"
+
+#define COMPILER_DEPEND_LIST "/compiler_depend.list"
+#define COMPILER_DEPEND_MAKE "/compiler_depend.make"
+#define COMPILER_DEPEND_STAMP "/compiler_depend.ts"
+
+void cmDependsCompiler::WriteList(std::string const& targetDir,
+                                  std::string const& workDir,
+                                  FileList const& files)
+{
+  // The list is read back by UpdateDependencies.  The first line names
+  // the working directory of the compiler and every following pair of
+  // lines names an object file and its dependency file.
+  cmGeneratedFileStream fout(targetDir + COMPILER_DEPEND_LIST);
+  fout.SetCopyIfDifferent(true);
+  fout << "# CMAKE generated file: DO NOT EDIT!\n"
+       << "# Dependency files written by the compiler for this target.\n"
+       << workDir << "\n";
+  for (auto const& f : files) {
+    fout << f.first << "\n" << f.second << "\n";
+  }
+}
+
+bool cmDependsCompiler::UpdateDependencies(std::string const& targetDir,
+                                           bool verbose)
+{
+  std::string const listFile = targetDir + COMPILER_DEPEND_LIST;
+  std::string const stampFile = targetDir + COMPILER_DEPEND_STAMP;
+
+  // Read the list of dependency files.
+  std::string workDir;
+  FileList files;
+  {
+    cmsys::ifstream fin(listFile.c_str());
+    if (!fin) {
+      cmSystemTools::Error("Cannot read compiler dependency list ",
+                           listFile.c_str());
+      return false;
+    }
+    std::string line;
+    std::string object;
+    bool haveObject = false;
+    while (cmSystemTools::GetLineFromStream(fin, line)) {
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+      if (workDir.empty()) {
+        workDir = line;
+      } else if (!haveObject) {
+        object = line;
+        haveObject = true;
+      } else {
+        files.emplace_back(object, line);
+        haveObject = false;
+      }
+    }
+  }
+
+  // Merge the files only if the list or any of them changed since the
+  // last merge.  Times that compare equal may hide a change made within
+  // the resolution of the file system.
+  cmFileTimeComparison::FilePairs pairs;
+  pairs.reserve(files.size() + 1);
+  pairs.emplace_back(listFile, stampFile);
+  for (auto const& f : files) {
+    pairs.emplace_back(f.second, stampFile);
+  }
+  cmFileTimeComparison ftc;
+  std::vector<int> results;
+  ftc.FileTimeCompare(pairs, results);
+  bool changed = false;
+  for (size_t i = 0; i < results.size() && !changed; ++i) {
+    if (results[i] == cmFileTimeComparison::FirstMissing ||
+        results[i] < 0) {
+      continue;
+    }
+    changed = true;
+    if (verbose) {
+      std::ostringstream msg;
+      msg << "Dependee \"" << pairs[i].first
+          << "\" is newer than depender \"" << stampFile << "\"."
+          << std::endl;
+      cmSystemTools::Stdout(msg.str().c_str());
+    }
+  }
+  if (!changed) {
+    return true;
+  }
+
+  cmGeneratedFileStream makeDepends(targetDir + COMPILER_DEPEND_MAKE);
+  makeDepends.SetCopyIfDifferent(true);
+  if (!makeDepends) {
+    return false;
+  }
+  makeDepends << "# CMAKE generated file: DO NOT EDIT!\n"
+              << "# Generated by \"cmake -E cmake_depends_compiler\".\n\n";
+  std::set<std::string> allDeps;
+  std::vector<std::string> deps;
+  for (auto const& f : files) {
+    deps.clear();
+    if (!ParseDependencyFile(f.second, workDir, deps)) {
+      // The object has not been compiled yet.
+      continue;
+    }
+    std::string const obj = cmSystemTools::ConvertToOutputPath(f.first);
+    for (std::string const& dep : deps) {
+      makeDepends << obj << ": " << cmSystemTools::ConvertToOutputPath(dep)
+                  << "\n";
+      allDeps.insert(dep);
+    }
+    makeDepends << "\n";
+  }
+
+  // Add a rule without commands for every dependency so that make does
+  // not fail when one of them is removed.
+  for (std::string const& dep : allDeps) {
+    makeDepends << cmSystemTools::ConvertToOutputPath(dep) << ":\n";
+  }
+  makeDepends.Close();
+
+  return cmSystemTools::Touch(stampFile, true);
+}
+
+bool cmDependsCompiler::ParseDependencyFile(std::string const& fileName,
+                                            std::string const& workDir,
+                                            std::vector<std::string>& deps)
+{
+  cmsys::ifstream fin(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  std::string const content((std::istreambuf_iterator<char>(fin)),
+                            std::istreambuf_iterator<char>());
+
+  // Targets precede the first colon of each rule and are ignored.  A
+  // colon not followed by white space is part of a Windows path.
+  std::set<std::string> seen;
+  std::string token;
+  bool prerequisites = false;
+  auto endToken = [&]() {
+    if (prerequisites && !token.empty()) {
+      std::string dep = cmSystemTools::CollapseFullPath(token, workDir);
+      if (seen.insert(dep).second) {
+        deps.push_back(std::move(dep));
+      }
+    }
+    token.clear();
+  };
+  size_t const n = content.size();
+  for (size_t i = 0; i < n; ++i) {
+    char const c = content[i];
+    char const next = i + 1 < n ? content[i + 1] : '\n';
+    switch (c) {
+      case '\\':
+        if (next == '\n' || (next == '\r' && i + 2 < n &&
+                             content[i + 2] == '\n')) {
+          // Line continuation.
+          endToken();
+          i += (next == '\r') ? 2 : 1;
+        } else if (next == ' ' || next == '#') {
+          token += next;
+          ++i;
+        } else {
+          token += c;
+        }
+        break;
+      case '$':
+        token += c;
+        if (next == '$') {
+          ++i;
+        }
+        break;
+      case ' ':
+      case '\t':
+      case '\r':
+        endToken();
+        break;
+      case '\n':
+        endToken();
+        prerequisites = false;
+        break;
+      case ':':
+        if (!prerequisites &&
+            (next == ' ' || next == '\t' || next == '\r' || next == '\n')) {
+          endToken();
+          prerequisites = true;
+        } else {
+          token += c;
+        }
+        break;
+      default:
+        token += c;
+        break;
+    }
+  }
+  endToken();
+  return true;
+}
@@ -0,0 +1,46 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmDependsCompiler_h
+#define cmDependsCompiler_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/** \class cmDependsCompiler
+ * \brief Merge dependency files written by the compiler.
+ *
+ * Compilers such as GNU write the dependencies of an object file in
+ * make syntax as a side effect of compiling it.  The Makefile generator
+ * can use them instead of scanning sources with cmDependsC.  It lists
+ * the dependency files of a target in compiler_depend.list, and
+ * "cmake -E cmake_depends_compiler" merges them into the
+ * compiler_depend.make file included by the target's build.make.
+ */
+class cmDependsCompiler
+{
+public:
+  /** Pairs of object file rule names, relative to the top of the build
+      tree, and full paths to their dependency files.  */
+  typedef std::vector<std::pair<std::string, std::string>> FileList;
+
+  /** Write the list of dependency files of the target whose files are
+      in the given directory.  Dependencies written with relative paths
+      are relative to the working directory of the compiler.  */
+  static void WriteList(std::string const& targetDir,
+                        std::string const& workDir, FileList const& files);
+
+  /** Merge the dependency files of the target whose files are in the
+      given directory if any of them changed since the last merge.  */
+  static bool UpdateDependencies(std::string const& targetDir, bool verbose);
+
+  /** Parse a dependency file in make syntax and append the full path
+      of every prerequisite to deps.  */
+  static bool ParseDependencyFile(std::string const& fileName,
+                                  std::string const& workDir,
+                                  std::vector<std::string>& deps);
+};
+
+#endif
@@ -3,14 +3,18 @@
 #include "cmDependsFortran.h"
 
 #include "cmsys/FStream.hxx"
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <stdlib.h>
 #include <string.h>
+#include <thread>
 #include <utility>
 
 #include "cmAlgorithms.h"
+#include "cmCryptoHash.h"
 #include "cmFortranParser.h" /* Interface to parser object.  */
 #include "cmGeneratedFileStream.h"
 #include "cmLocalGenerator.h"
@@ -66,8 +70,93 @@ public:
     }
     return i->second;
   }
+
+  // Object files and their sources recorded for scanning.
+  std::vector<std::pair<std::string, std::string>> Pending;
+
+  // Scan results of one source.  The hash covers the content of the
+  // source and the scanner settings.  The included files are checked
+  // separately by their own hashes, and the paths checked before them
+  // must still not exist.
+  struct ScanJob
+  {
+    std::string Source;
+    std::string Hash;
+    std::vector<std::pair<std::string, std::string>> IncludeHashes;
+    cmFortranSourceInfo Info;
+    std::string Error;
+    bool Okay = true;
+  };
+  typedef std::map<std::string, ScanJob> ScanCacheMap;
+
+  void ReadScanCache(std::string const& fname, ScanCacheMap& cache);
+  void WriteScanCache(std::string const& fname,
+                      std::vector<ScanJob> const& jobs);
 };
 
+// The scan cache lists every source on a "source" line followed by lines
+// holding its results.  Paths come last on a line to allow spaces.
+void cmDependsFortranInternals::ReadScanCache(std::string const& fname,
+                                              ScanCacheMap& cache)
+{
+  cmsys::ifstream fin(fname.c_str());
+  std::string line;
+  ScanJob* job = nullptr;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (cmHasLiteralPrefix(line, "source ")) {
+      std::string const src = line.substr(7);
+      job = &cache[src];
+      job->Source = src;
+      job->Info.Source = src;
+    } else if (!job) {
+      continue;
+    } else if (cmHasLiteralPrefix(line, " hash ")) {
+      job->Hash = line.substr(6);
+    } else if (cmHasLiteralPrefix(line, " include ")) {
+      std::string::size_type const pos = line.find(' ', 9);
+      if (pos != std::string::npos) {
+        std::string include = line.substr(pos + 1);
+        job->Info.Includes.insert(include);
+        job->IncludeHashes.emplace_back(std::move(include),
+                                        line.substr(9, pos - 9));
+      }
+    } else if (cmHasLiteralPrefix(line, " missing ")) {
+      job->Info.MissingIncludes.insert(line.substr(9));
+    } else if (cmHasLiteralPrefix(line, " provides ")) {
+      job->Info.Provides.insert(line.substr(10));
+    } else if (cmHasLiteralPrefix(line, " requires ")) {
+      job->Info.Requires.insert(line.substr(10));
+    }
+  }
+}
+
+void cmDependsFortranInternals::WriteScanCache(
+  std::string const& fname, std::vector<ScanJob> const& jobs)
+{
+  cmGeneratedFileStream fout(fname);
+  fout.SetCopyIfDifferent(true);
+  fout << "# The fortran scan results of the sources of this target.\n";
+  for (ScanJob const& job : jobs) {
+    if (!job.Okay) {
+      continue;
+    }
+    fout << "source " << job.Source << "\n";
+    fout << " hash " << job.Hash << "\n";
+    for (auto const& include : job.IncludeHashes) {
+      fout << " include " << include.second << " " << include.first << "\n";
+    }
+    for (std::string const& m : job.Info.MissingIncludes) {
+      fout << " missing " << m << "\n";
+    }
+    for (std::string const& p : job.Info.Provides) {
+      fout << " provides " << p << "\n";
+    }
+    for (std::string const& r : job.Info.Requires) {
+      fout << " requires " << r << "\n";
+    }
+  }
+}
+
 cmDependsFortran::cmDependsFortran()
   : Internal(nullptr)
 {
@@ -119,37 +208,137 @@ bool cmDependsFortran::WriteDependencies(const std::set<std::string>& sources,
     return false;
   }
 
-  bool okay = true;
+  // Defer parsing to Finalize so that all sources of the target can be
+  // scanned together.
   for (std::string const& src : sources) {
-    // Get the information object for this source.
-    cmFortranSourceInfo& info =
-      this->Internal->CreateObjectInfo(obj.c_str(), src.c_str());
+    this->Internal->Pending.emplace_back(obj, src);
+  }
+  return true;
+}
 
-    // Create the parser object. The constructor takes info by reference,
-    // so we may look into the resulting objects later.
-    cmFortranParser parser(this->IncludePath, this->PPDefinitions, info);
+bool cmDependsFortran::ScanSources()
+{
+  typedef cmDependsFortranInternals::ScanJob ScanJob;
+  std::string const cacheFile = this->TargetDirectory + "/fortran.scan";
+  cmDependsFortranInternals::ScanCacheMap cache;
+  this->Internal->ReadScanCache(cacheFile, cache);
+
+  // Results depend on the preprocessor definitions and include path.
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  std::string context;
+  for (std::string const& def : this->PPDefinitions) {
+    context += "\n-D" + def;
+  }
+  for (std::string const& dir : this->IncludePath) {
+    context += "\n-I" + dir;
+  }
+
+  // Reuse the cached results of sources whose content and included files
+  // did not change since they were last scanned, and that would still
+  // include the same files.
+  std::map<std::string, std::string> fileHashes;
+  auto hashFile = [&hasher, &fileHashes](std::string const& file) {
+    auto i = fileHashes.find(file);
+    if (i == fileHashes.end()) {
+      i = fileHashes.emplace(file, hasher.HashFile(file)).first;
+    }
+    return i->second;
+  };
+  std::vector<ScanJob> jobs(this->Internal->Pending.size());
+  std::vector<ScanJob*> misses;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    ScanJob& job = jobs[i];
+    job.Source = this->Internal->Pending[i].second;
+    job.Hash = hasher.HashString(hashFile(job.Source) + context);
+    auto c = cache.find(job.Source);
+    if (c != cache.end() && c->second.Hash == job.Hash &&
+        std::all_of(c->second.IncludeHashes.begin(),
+                    c->second.IncludeHashes.end(),
+                    [&hashFile](std::pair<std::string, std::string> const& h) {
+                      return hashFile(h.first) == h.second;
+                    }) &&
+        std::none_of(c->second.Info.MissingIncludes.begin(),
+                     c->second.Info.MissingIncludes.end(),
+                     [](std::string const& m) {
+                       return cmSystemTools::FileExists(m, true);
+                     })) {
+      job.Info = c->second.Info;
+      job.IncludeHashes = c->second.IncludeHashes;
+    } else {
+      misses.push_back(&job);
+    }
+  }
 
-    // Push on the starting file.
-    cmFortranParser_FilePush(&parser, src.c_str());
+  // Parse the remaining sources.  Each parser has its own reentrant
+  // lexer, so they can run on worker threads.
+  auto parse = [this](ScanJob* job) {
+    job->Info.Source = job->Source;
+    cmFortranParser parser(this->IncludePath, this->PPDefinitions, job->Info);
+    cmFortranParser_FilePush(&parser, job->Source.c_str());
+    job->Okay = cmFortran_yyparse(parser.Scanner) == 0;
+    if (!job->Okay) {
+      job->Error = parser.Error;
+    }
+  };
+  std::atomic<size_t> next(0);
+  auto work = [&misses, &next, &parse]() {
+    for (size_t i = next++; i < misses.size(); i = next++) {
+      parse(misses[i]);
+    }
+  };
+  size_t const threads = std::min<size_t>(
+    std::max(std::thread::hardware_concurrency(), 1u), misses.size());
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
 
-    // Parse the translation unit.
-    if (cmFortran_yyparse(parser.Scanner) != 0) {
+  bool okay = true;
+  for (ScanJob* job : misses) {
+    if (!job->Okay) {
       // Failed to parse the file.  Report failure to write dependencies.
       okay = false;
       /* clang-format off */
       std::cerr <<
         "warning: failed to parse dependencies from Fortran source "
-        "'" << src << "': " << parser.Error << std::endl
+        "'" << job->Source << "': " << job->Error << std::endl
         ;
       /* clang-format on */
+      continue;
+    }
+    for (std::string const& include : job->Info.Includes) {
+      job->IncludeHashes.emplace_back(include, hashFile(include));
     }
   }
+
+  // Merge the results into the information of each object file.
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    std::string const& obj = this->Internal->Pending[i].first;
+    cmFortranSourceInfo const& result = jobs[i].Info;
+    cmFortranSourceInfo& info =
+      this->Internal->CreateObjectInfo(obj.c_str(), jobs[i].Source.c_str());
+    info.Provides.insert(result.Provides.begin(), result.Provides.end());
+    info.Requires.insert(result.Requires.begin(), result.Requires.end());
+    info.Includes.insert(result.Includes.begin(), result.Includes.end());
+  }
+  this->Internal->Pending.clear();
+
+  this->Internal->WriteScanCache(cacheFile, jobs);
   return okay;
 }
 
 bool cmDependsFortran::Finalize(std::ostream& makeDepends,
                                 std::ostream& internalDepends)
 {
+  // Scan the sources recorded by WriteDependencies.
+  if (!this->ScanSources()) {
+    return false;
+  }
+
   // Prepare the module search process.
   this->LocateModules();
 
@@ -52,6 +52,10 @@ protected:
   bool Finalize(std::ostream& makeDepends,
                 std::ostream& internalDepends) override;
 
+  // Scan the sources recorded by WriteDependencies on worker threads,
+  // reusing the cached results of unchanged sources.
+  bool ScanSources();
+
   // Find all the modules required by the target.
   void LocateModules();
   void MatchLocalModules();
@@ -209,6 +209,10 @@ bool cmExecProgramCommand::RunCommand(const char* command, std::string& output,
   cmsysProcess_SetCommand(cp, cmd);
 #endif
 
+  // The process may change any file, so do not trust cached results.
+  cmSystemTools::StatCacheBypass statCacheBypass;
+  static_cast<void>(statCacheBypass);
+
   cmsysProcess_Execute(cp);
 
   // Read the process output.
@@ -233,6 +233,10 @@ bool cmExecuteProcessCommand::InitialPass(std::vector<std::string> const& args,
     cmsysProcess_SetTimeout(cp, timeout);
   }
 
+  // The processes may change any file, so do not trust cached results.
+  cmSystemTools::StatCacheBypass statCacheBypass;
+  static_cast<void>(statCacheBypass);
+
   // Start the process.
   cmsysProcess_Execute(cp);
 
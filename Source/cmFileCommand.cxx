@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <memory> // IWYU pragma: keep
+#include <set>
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -88,6 +89,20 @@ bool cmFileCommand::InitialPass(std::vector<std::string> const& args,
     return false;
   }
   std::string const& subCommand = args[0];
+
+  // Subcommands that modify files see the file system directly and
+  // drop the cached results when done.  The others only read it.
+  static std::set<std::string> const modifyingSubCommands = {
+    "APPEND",         "CHRPATH",        "COPY",
+    "DOWNLOAD",       "INSTALL",        "LOCK",
+    "MAKE_DIRECTORY", "REMOVE",         "REMOVE_RECURSE",
+    "RENAME",         "RPATH_CHANGE",   "RPATH_REMOVE",
+    "TOUCH",          "TOUCH_NOCREATE", "WRITE"
+  };
+  cmSystemTools::StatCacheBypass statCacheBypass(
+    modifyingSubCommands.count(subCommand) != 0);
+  static_cast<void>(statCacheBypass);
+
   if (subCommand == "WRITE") {
     return this->HandleWriteCommand(args, false);
   }
@@ -2,19 +2,35 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmFileTimeComparison.h"
 
+#include <functional>
 #include <string>
 #include <time.h>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 // Use a platform-specific API to get file times efficiently.
 #if !defined(_WIN32) || defined(__CYGWIN__)
 #  include "cm_sys_stat.h"
-#  define cmFileTimeComparison_Type struct stat
+#  if defined(__linux__) && defined(STATX_MTIME)
+#    include <errno.h>
+#    include <fcntl.h>
+#    define cmFileTimeComparison_USE_STATX
+#  endif
 #else
 #  include "cmsys/Encoding.hxx"
 #  include <windows.h>
-#  define cmFileTimeComparison_Type FILETIME
+#endif
+
+// Modification times are stored as integer ticks since the epoch.
+#if !defined(_WIN32) || defined(__CYGWIN__)
+#  if CMake_STAT_HAS_ST_MTIM || CMake_STAT_HAS_ST_MTIMESPEC ||             \
+    defined(cmFileTimeComparison_USE_STATX)
+static const long long cmFileTimeComparison_TicksPerSecond = 1000000000;
+#  else
+static const long long cmFileTimeComparison_TicksPerSecond = 1;
+#  endif
+#else
+static const long long cmFileTimeComparison_TicksPerSecond = 10000000;
 #endif
 
 class cmFileTimeComparisonInternal
@@ -25,36 +41,140 @@ public:
 
   bool FileTimesDiffer(const char* f1, const char* f2);
 
+  void FileTimeCompare(cmFileTimeComparison::FilePairs const& pairs,
+                       std::vector<int>& results);
+
 private:
-  typedef std::unordered_map<std::string, cmFileTimeComparison_Type>
-    FileStatsMap;
-  FileStatsMap Files;
+  // One slot of the open-addressing table of known modification times.
+  // A missing file is remembered only for the batch that queried it.
+  struct Slot
+  {
+    size_t Hash = 0;
+    std::string Name;
+    long long Time = 0;
+    bool Used = false;
+    bool Exists = false;
+    unsigned int Batch = 0;
+  };
+
+  // The table capacity is a power of two and is kept at most half full
+  // so that linear probing finds a slot in a few steps.
+  std::vector<Slot> Slots;
+  size_t NumUsed = 0;
+  unsigned int BatchId = 0;
+  bool InBatch = false;
+#if defined(cmFileTimeComparison_USE_STATX)
+  bool UseStatx = true;
+#endif
+
+  Slot& FindSlot(std::string const& fname, size_t hash);
+  void Grow();
 
   // Internal methods to lookup and compare modification times.
-  inline bool Stat(const char* fname, cmFileTimeComparison_Type* st);
-  inline int Compare(cmFileTimeComparison_Type* st1,
-                     cmFileTimeComparison_Type* st2);
-  inline bool TimesDiffer(cmFileTimeComparison_Type* st1,
-                          cmFileTimeComparison_Type* st2);
+  inline bool Stat(std::string const& fname, long long* time);
+  bool StatFile(const char* fname, long long* time);
+  static inline int Compare(long long t1, long long t2);
+  static inline bool TimesDiffer(long long t1, long long t2);
 };
 
-bool cmFileTimeComparisonInternal::Stat(const char* fname,
-                                        cmFileTimeComparison_Type* st)
+cmFileTimeComparisonInternal::Slot& cmFileTimeComparisonInternal::FindSlot(
+  std::string const& fname, size_t hash)
 {
+  size_t const mask = this->Slots.size() - 1;
+  size_t i = hash & mask;
+  while (this->Slots[i].Used &&
+         (this->Slots[i].Hash != hash || this->Slots[i].Name != fname)) {
+    i = (i + 1) & mask;
+  }
+  return this->Slots[i];
+}
+
+void cmFileTimeComparisonInternal::Grow()
+{
+  std::vector<Slot> old;
+  old.swap(this->Slots);
+  this->Slots.resize(old.empty() ? 256 : old.size() * 2);
+  for (Slot& s : old) {
+    if (s.Used) {
+      Slot& slot = this->FindSlot(s.Name, s.Hash);
+      slot = std::move(s);
+    }
+  }
+}
+
+bool cmFileTimeComparisonInternal::Stat(std::string const& fname,
+                                        long long* time)
+{
+  if ((this->NumUsed + 1) * 2 > this->Slots.size()) {
+    this->Grow();
+  }
+
   // Use the stored time if available.
-  cmFileTimeComparisonInternal::FileStatsMap::iterator fit =
-    this->Files.find(fname);
-  if (fit != this->Files.end()) {
-    *st = fit->second;
-    return true;
+  size_t const hash = std::hash<std::string>()(fname);
+  Slot& slot = this->FindSlot(fname, hash);
+  if (slot.Used &&
+      (slot.Exists || (this->InBatch && slot.Batch == this->BatchId))) {
+    *time = slot.Time;
+    return slot.Exists;
   }
 
+  bool const exists = this->StatFile(fname.c_str(), time);
+  if (!exists && !this->InBatch) {
+    // Outside of a batch missing files are queried again every time.
+    return false;
+  }
+
+  // Store the time for future use.
+  if (!slot.Used) {
+    slot.Used = true;
+    slot.Hash = hash;
+    slot.Name = fname;
+    ++this->NumUsed;
+  }
+  slot.Exists = exists;
+  slot.Time = exists ? *time : 0;
+  slot.Batch = this->BatchId;
+  return exists;
+}
+
+bool cmFileTimeComparisonInternal::StatFile(const char* fname,
+                                            long long* time)
+{
 #if !defined(_WIN32) || defined(__CYGWIN__)
+#  if defined(cmFileTimeComparison_USE_STATX)
+  // Linux version.  Ask only for the modification time, which some file
+  // systems can provide more cheaply than a full stat.
+  if (this->UseStatx) {
+    struct statx stx;
+    if (statx(AT_FDCWD, fname, 0, STATX_MTIME, &stx) == 0) {
+      if (stx.stx_mask & STATX_MTIME) {
+        *time = stx.stx_mtime.tv_sec * cmFileTimeComparison_TicksPerSecond +
+          stx.stx_mtime.tv_nsec;
+        return true;
+      }
+      // The file system did not provide the time.  Use stat below.
+    } else if (errno != ENOSYS && errno != EPERM) {
+      return false;
+    } else {
+      // The kernel does not support statx.
+      this->UseStatx = false;
+    }
+  }
+#  endif
   // POSIX version.  Use the stat function.
-  int res = ::stat(fname, st);
-  if (res != 0) {
+  struct stat st;
+  if (::stat(fname, &st) != 0) {
     return false;
   }
+#  if CMake_STAT_HAS_ST_MTIM
+  *time = st.st_mtim.tv_sec * cmFileTimeComparison_TicksPerSecond +
+    st.st_mtim.tv_nsec;
+#  elif CMake_STAT_HAS_ST_MTIMESPEC
+  *time = st.st_mtimespec.tv_sec * cmFileTimeComparison_TicksPerSecond +
+    st.st_mtimespec.tv_nsec;
+#  else
+  *time = st.st_mtime * cmFileTimeComparison_TicksPerSecond;
+#  endif
 #else
   // Windows version.  Get the modification time from extended file
   // attributes.
@@ -64,12 +184,12 @@ bool cmFileTimeComparisonInternal::Stat(const char* fname,
     return false;
   }
 
-  // Copy the file time to the output location.
-  *st = fdata.ftLastWriteTime;
+  // Convert the file time to 100ns ticks.
+  ULARGE_INTEGER t;
+  t.LowPart = fdata.ftLastWriteTime.dwLowDateTime;
+  t.HighPart = fdata.ftLastWriteTime.dwHighDateTime;
+  *time = static_cast<long long>(t.QuadPart);
 #endif
-
-  // Store the time for future use.
-  this->Files[fname] = *st;
   return true;
 }
 
@@ -94,120 +214,44 @@ bool cmFileTimeComparison::FileTimesDiffer(const char* f1, const char* f2)
   return this->Internals->FileTimesDiffer(f1, f2);
 }
 
-int cmFileTimeComparisonInternal::Compare(cmFileTimeComparison_Type* s1,
-                                          cmFileTimeComparison_Type* s2)
+void cmFileTimeComparison::FileTimeCompare(FilePairs const& pairs,
+                                           std::vector<int>& results)
 {
-#if !defined(_WIN32) || defined(__CYGWIN__)
-#  if CMake_STAT_HAS_ST_MTIM
-  // Compare using nanosecond resolution.
-  if (s1->st_mtim.tv_sec < s2->st_mtim.tv_sec) {
-    return -1;
-  }
-  if (s1->st_mtim.tv_sec > s2->st_mtim.tv_sec) {
-    return 1;
-  }
-  if (s1->st_mtim.tv_nsec < s2->st_mtim.tv_nsec) {
-    return -1;
-  }
-  if (s1->st_mtim.tv_nsec > s2->st_mtim.tv_nsec) {
-    return 1;
-  }
-#  elif CMake_STAT_HAS_ST_MTIMESPEC
-  // Compare using nanosecond resolution.
-  if (s1->st_mtimespec.tv_sec < s2->st_mtimespec.tv_sec) {
-    return -1;
-  }
-  if (s1->st_mtimespec.tv_sec > s2->st_mtimespec.tv_sec) {
-    return 1;
-  }
-  if (s1->st_mtimespec.tv_nsec < s2->st_mtimespec.tv_nsec) {
-    return -1;
-  }
-  if (s1->st_mtimespec.tv_nsec > s2->st_mtimespec.tv_nsec) {
-    return 1;
-  }
-#  else
-  // Compare using 1 second resolution.
-  if (s1->st_mtime < s2->st_mtime) {
+  this->Internals->FileTimeCompare(pairs, results);
+}
+
+int cmFileTimeComparisonInternal::Compare(long long t1, long long t2)
+{
+  if (t1 < t2) {
     return -1;
   }
-  if (s1->st_mtime > s2->st_mtime) {
+  if (t1 > t2) {
     return 1;
   }
-#  endif
   // Files have the same time.
   return 0;
-#else
-  // Compare using system-provided function.
-  return (int)CompareFileTime(s1, s2);
-#endif
 }
 
-bool cmFileTimeComparisonInternal::TimesDiffer(cmFileTimeComparison_Type* s1,
-                                               cmFileTimeComparison_Type* s2)
+bool cmFileTimeComparisonInternal::TimesDiffer(long long t1, long long t2)
 {
-#if !defined(_WIN32) || defined(__CYGWIN__)
-#  if CMake_STAT_HAS_ST_MTIM
-  // Times are integers in units of 1ns.
-  long long bil = 1000000000;
-  long long t1 = s1->st_mtim.tv_sec * bil + s1->st_mtim.tv_nsec;
-  long long t2 = s2->st_mtim.tv_sec * bil + s2->st_mtim.tv_nsec;
   if (t1 < t2) {
-    return (t2 - t1) >= bil;
+    return (t2 - t1) >= cmFileTimeComparison_TicksPerSecond;
   }
   if (t2 < t1) {
-    return (t1 - t2) >= bil;
+    return (t1 - t2) >= cmFileTimeComparison_TicksPerSecond;
   }
   return false;
-#  elif CMake_STAT_HAS_ST_MTIMESPEC
-  // Times are integers in units of 1ns.
-  long long bil = 1000000000;
-  long long t1 = s1->st_mtimespec.tv_sec * bil + s1->st_mtimespec.tv_nsec;
-  long long t2 = s2->st_mtimespec.tv_sec * bil + s2->st_mtimespec.tv_nsec;
-  if (t1 < t2) {
-    return (t2 - t1) >= bil;
-  }
-  if (t2 < t1) {
-    return (t1 - t2) >= bil;
-  }
-  return false;
-#  else
-  // Times are integers in units of 1s.
-  if (s1->st_mtime < s2->st_mtime) {
-    return (s2->st_mtime - s1->st_mtime) >= 1;
-  }
-  if (s1->st_mtime > s2->st_mtime) {
-    return (s1->st_mtime - s2->st_mtime) >= 1;
-  }
-  return false;
-#  endif
-#else
-  // Times are integers in units of 100ns.
-  LARGE_INTEGER t1;
-  LARGE_INTEGER t2;
-  t1.LowPart = s1->dwLowDateTime;
-  t1.HighPart = s1->dwHighDateTime;
-  t2.LowPart = s2->dwLowDateTime;
-  t2.HighPart = s2->dwHighDateTime;
-  if (t1.QuadPart < t2.QuadPart) {
-    return (t2.QuadPart - t1.QuadPart) >= static_cast<LONGLONG>(10000000);
-  } else if (t2.QuadPart < t1.QuadPart) {
-    return (t1.QuadPart - t2.QuadPart) >= static_cast<LONGLONG>(10000000);
-  } else {
-    return false;
-  }
-#endif
 }
 
 bool cmFileTimeComparisonInternal::FileTimeCompare(const char* f1,
                                                    const char* f2, int* result)
 {
   // Get the modification time for each file.
-  cmFileTimeComparison_Type s1;
-  cmFileTimeComparison_Type s2;
-  if (this->Stat(f1, &s1) && this->Stat(f2, &s2)) {
+  long long t1;
+  long long t2;
+  if (this->Stat(f1, &t1) && this->Stat(f2, &t2)) {
     // Compare the two modification times.
-    *result = this->Compare(&s1, &s2);
+    *result = this->Compare(t1, t2);
     return true;
   }
   // No comparison available.  Default to the same time.
@@ -219,12 +263,34 @@ bool cmFileTimeComparisonInternal::FileTimesDiffer(const char* f1,
                                                    const char* f2)
 {
   // Get the modification time for each file.
-  cmFileTimeComparison_Type s1;
-  cmFileTimeComparison_Type s2;
-  if (this->Stat(f1, &s1) && this->Stat(f2, &s2)) {
+  long long t1;
+  long long t2;
+  if (this->Stat(f1, &t1) && this->Stat(f2, &t2)) {
     // Compare the two modification times.
-    return this->TimesDiffer(&s1, &s2);
+    return this->TimesDiffer(t1, t2);
   }
   // No comparison available.  Default to different times.
   return true;
 }
+
+void cmFileTimeComparisonInternal::FileTimeCompare(
+  cmFileTimeComparison::FilePairs const& pairs, std::vector<int>& results)
+{
+  // Files missing during this batch are remembered until it ends.
+  ++this->BatchId;
+  this->InBatch = true;
+  results.clear();
+  results.reserve(pairs.size());
+  for (auto const& p : pairs) {
+    long long t1;
+    long long t2;
+    if (!this->Stat(p.first, &t1)) {
+      results.push_back(cmFileTimeComparison::FirstMissing);
+    } else if (!this->Stat(p.second, &t2)) {
+      results.push_back(cmFileTimeComparison::SecondMissing);
+    } else {
+      results.push_back(this->Compare(t1, t2));
+    }
+  }
+  this->InBatch = false;
+}
@@ -5,6 +5,10 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <string>
+#include <utility>
+#include <vector>
+
 class cmFileTimeComparisonInternal;
 
 /** \class cmFileTimeComparison
@@ -32,6 +36,24 @@ public:
    */
   bool FileTimesDiffer(const char* f1, const char* f2);
 
+  /** Results of a batch comparison besides -1, 0 and +1.  */
+  enum
+  {
+    FirstMissing = 2,
+    SecondMissing = 3
+  };
+
+  typedef std::vector<std::pair<std::string, std::string>> FilePairs;
+
+  /**
+   *  Compare the modification times of many pairs of files, querying
+   *  each distinct file at most once.  For every pair results receives
+   *  -1, 0, +1 for the first file older, same, or newer than the second,
+   *  or FirstMissing or SecondMissing if the time of the first or second
+   *  file is not available.
+   */
+  void FileTimeCompare(FilePairs const& pairs, std::vector<int>& results);
+
 protected:
   cmFileTimeComparisonInternal* Internals;
 };
@@ -350,7 +350,7 @@ bool cmFindLibraryHelper::CheckDirectoryForName(std::string const& path,
   // specifically for a static library on some platforms (on MS tools
   // one cannot tell just from the library name whether it is a static
   // library or an import library).
-  if (name.TryRaw) {
+  if (name.TryRaw && this->GG->DirectoryMayContain(path, name.Raw)) {
     this->TestPath = path;
     this->TestPath += name.Raw;
     if (cmSystemTools::FileExists(this->TestPath, true)) {
@@ -17,9 +17,11 @@
 #include <sstream>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <utility>
 
 #include "cmAlgorithms.h"
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmPolicies.h"
 #include "cmSearchPath.h"
@@ -28,6 +30,10 @@
 #include "cmVersion.h"
 #include "cmake.h"
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#  include "cmCryptoHash.h"
+#endif
+
 #if defined(__HAIKU__)
 #  include <FindDirectory.h>
 #  include <StorageDefs.h>
@@ -971,15 +977,132 @@ bool cmFindPackageCommand::FindConfig()
 
 bool cmFindPackageCommand::FindPrefixedConfig()
 {
+  bool found = false;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Replay an earlier search of the same prefixes if none of the
+  // directories it looked into changed since.
+  std::string key;
+  if (!this->DebugMode) {
+    key = this->ComputeConfigSearchKey();
+    if (this->ReplayConfigSearch(key, found)) {
+      return found;
+    }
+  }
+  long const start = static_cast<long>(time(nullptr));
+  size_t const considered = this->ConsideredConfigs.size();
+  this->SearchedDirectories.clear();
+#endif
+
   std::vector<std::string> const& prefixes = this->SearchPaths;
   for (std::string const& p : prefixes) {
     if (this->SearchPrefix(p)) {
+      found = true;
+      break;
+    }
+  }
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if (!key.empty()) {
+    this->StoreConfigSearch(key, considered, start, found);
+  }
+#endif
+  return found;
+}
+
+std::string cmFindPackageCommand::ComputeConfigSearchKey() const
+{
+  std::string key;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Every input of SearchPrefix, one per line.  Paths cannot contain
+  // the separator of lists.
+  auto add = [&key](std::string const& s) {
+    key += s;
+    key += "\n";
+  };
+  auto addList = [&key](std::vector<std::string> const& l) {
+    key += cmJoin(l, "\t");
+    key += "\n";
+  };
+  add(cmVersion::GetCMakeVersion());
+  add(this->Name);
+  add(this->Version);
+  add(this->VersionExact ? "EXACT" : "");
+  addList(this->Names);
+  addList(this->Configs);
+  addList(this->SearchPathSuffixes);
+  addList(this->SearchPaths);
+  key += cmJoin(this->IgnoredPaths, "\t");
+  key += "\n";
+  add(this->LibraryArchitecture);
+  add(std::string(this->UseLib32Paths ? "lib32" : "") +
+      (this->UseLib64Paths ? "lib64" : "") +
+      (this->UseLibx32Paths ? "libx32" : ""));
+  add(std::to_string(this->SortOrder) + " " +
+      std::to_string(this->SortDirection));
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  key = hasher.HashString(key);
+#endif
+  return key;
+}
+
+bool cmFindPackageCommand::ReplayConfigSearch(std::string const& key,
+                                              bool& found)
+{
+  cmGlobalGenerator::FindPackageConfigSearch const* search =
+    this->Makefile->GetGlobalGenerator()->GetFindPackageConfigSearch(key);
+  if (!search) {
+    return false;
+  }
+
+  // The directories are unchanged, so a search would consider the same
+  // files in the same order.  Their version files may give a different
+  // answer now, so check them again.
+  size_t const considered = this->ConsideredConfigs.size();
+  for (std::string const& c : search->Candidates) {
+    if (!cmSystemTools::FileExists(c, true)) {
+      break;
+    }
+    if (this->CheckVersion(c)) {
+      this->FileFound = c;
+      cmSystemTools::ConvertToUnixSlashes(this->FileFound);
+      found = true;
       return true;
     }
   }
+  if (!search->Found &&
+      this->ConsideredConfigs.size() - considered ==
+        search->Candidates.size()) {
+    found = false;
+    return true;
+  }
+
+  // The search would go on past the files it stopped at before.
+  this->ConsideredConfigs.resize(considered);
   return false;
 }
 
+void cmFindPackageCommand::StoreConfigSearch(std::string const& key,
+                                             size_t considered, long start,
+                                             bool found)
+{
+  cmGlobalGenerator::FindPackageConfigSearch search;
+  search.Found = found;
+  for (size_t i = considered; i < this->ConsideredConfigs.size(); ++i) {
+    search.Candidates.push_back(this->ConsideredConfigs[i].filename);
+  }
+  for (std::string const& d : this->SearchedDirectories) {
+    // A directory modified in the second the search started may have
+    // changed after it was looked into without a new time.
+    long const mt = cmSystemTools::ModifiedTime(d);
+    if (mt >= start) {
+      return;
+    }
+    search.Directories.emplace_back(d, mt);
+  }
+  this->Makefile->GetGlobalGenerator()->AddFindPackageConfigSearch(
+    key, std::move(search));
+}
+
 bool cmFindPackageCommand::FindFrameworkConfig()
 {
   std::vector<std::string> const& prefixes = this->SearchPaths;
@@ -1466,6 +1589,8 @@ bool cmFindPackageCommand::FindConfigFile(std::string const& dir,
     return false;
   }
 
+  this->SearchedDirectories.insert(dir.empty() ? "/" : dir);
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
   for (std::string const& c : this->Configs) {
     file = dir;
     file += "/";
@@ -1473,7 +1598,8 @@ bool cmFindPackageCommand::FindConfigFile(std::string const& dir,
     if (this->DebugMode) {
       fprintf(stderr, "Checking file [%s]\n", file.c_str());
     }
-    if (cmSystemTools::FileExists(file, true) && this->CheckVersion(file)) {
+    if (gg->DirectoryMayContain(dir, c) &&
+        cmSystemTools::FileExists(file, true) && this->CheckVersion(file)) {
       return true;
     }
   }
@@ -1637,6 +1763,8 @@ public:
 
 protected:
   bool Consider(std::string const& fullPath, cmFileList& listing);
+  static void Load(cmsys::Directory& d, std::string const& parent,
+                   cmFileList& listing);
 
 private:
   bool Search(cmFileList&);
@@ -1676,6 +1804,7 @@ public:
 
 private:
   virtual bool Visit(std::string const& fullPath) = 0;
+  virtual void Listed(std::string const& /*dir*/) {}
   friend class cmFileListGeneratorBase;
   std::unique_ptr<cmFileListGeneratorBase> First;
   cmFileListGeneratorBase* Last;
@@ -1699,6 +1828,10 @@ private:
     }
     return this->FPC->CheckDirectory(fullPath);
   }
+  void Listed(std::string const& dir) override
+  {
+    this->FPC->SearchedDirectories.insert(dir);
+  }
   cmFindPackageCommand* FPC;
   bool UseSuffixes;
 };
@@ -1724,6 +1857,17 @@ bool cmFileListGeneratorBase::Consider(std::string const& fullPath,
   return listing.Visit(fullPath + "/");
 }
 
+void cmFileListGeneratorBase::Load(cmsys::Directory& d,
+                                   std::string const& parent,
+                                   cmFileList& listing)
+{
+  // Record the directory without the trailing slash unless it is the
+  // root.
+  listing.Listed(parent.size() > 1 ? parent.substr(0, parent.size() - 1)
+                                   : parent);
+  d.Load(parent);
+}
+
 class cmFileListGeneratorFixed : public cmFileListGeneratorBase
 {
 public:
@@ -1823,7 +1967,7 @@ private:
     // Construct a list of matches.
     std::vector<std::string> matches;
     cmsys::Directory d;
-    d.Load(parent);
+    this->Load(d, parent, lister);
     for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
       const char* fname = d.GetFile(i);
       if (strcmp(fname, ".") == 0 || strcmp(fname, "..") == 0) {
@@ -1883,7 +2027,7 @@ private:
     // Construct a list of matches.
     std::vector<std::string> matches;
     cmsys::Directory d;
-    d.Load(parent);
+    this->Load(d, parent, lister);
     for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
       const char* fname = d.GetFile(i);
       if (strcmp(fname, ".") == 0 || strcmp(fname, "..") == 0) {
@@ -1934,7 +2078,7 @@ private:
     // Look for matching files.
     std::vector<std::string> matches;
     cmsys::Directory d;
-    d.Load(parent);
+    this->Load(d, parent, lister);
     for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
       const char* fname = d.GetFile(i);
       if (strcmp(fname, ".") == 0 || strcmp(fname, "..") == 0) {
@@ -2007,6 +2151,9 @@ bool cmFindPackageCommand::SearchPrefix(std::string const& prefix_in)
   }
 
   // Skip this if the prefix does not exist.
+  this->SearchedDirectories.insert(
+    prefix_in.size() > 1 ? prefix_in.substr(0, prefix_in.size() - 1)
+                         : prefix_in);
   if (!cmSystemTools::FileIsDirectory(prefix_in)) {
     return false;
   }
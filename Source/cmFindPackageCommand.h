@@ -102,6 +102,10 @@ private:
   bool HandlePackageMode();
   bool FindConfig();
   bool FindPrefixedConfig();
+  std::string ComputeConfigSearchKey() const;
+  bool ReplayConfigSearch(std::string const& key, bool& found);
+  void StoreConfigSearch(std::string const& key, size_t considered,
+                         long start, bool found);
   bool FindFrameworkConfig();
   bool FindAppBundleConfig();
   enum PolicyScopeRule
@@ -180,6 +184,8 @@ private:
   std::vector<std::string> Names;
   std::vector<std::string> Configs;
   std::set<std::string> IgnoredPaths;
+  // Directories looked into by the search of the prefixes.
+  std::set<std::string> SearchedDirectories;
 
   /*! the selected sortOrder (None by default)*/
   SortOrderType SortOrder;
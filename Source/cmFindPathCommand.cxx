@@ -4,6 +4,7 @@
 
 #include "cmsys/Glob.hxx"
 
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmStateTypes.h"
 #include "cmSystemTools.h"
@@ -123,9 +124,13 @@ std::string cmFindPathCommand::FindHeaderInFramework(std::string const& file,
 
 std::string cmFindPathCommand::FindNormalHeader()
 {
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
   std::string tryPath;
   for (std::string const& n : this->Names) {
     for (std::string const& sp : this->SearchPaths) {
+      if (!gg->DirectoryMayContain(sp, n)) {
+        continue;
+      }
       tryPath = sp;
       tryPath += n;
       if (cmSystemTools::FileExists(tryPath)) {
@@ -2,6 +2,7 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmFindProgramCommand.h"
 
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmStateTypes.h"
 #include "cmSystemTools.h"
@@ -14,7 +15,8 @@ class cmExecutionStatus;
 
 struct cmFindProgramHelper
 {
-  cmFindProgramHelper()
+  cmFindProgramHelper(cmMakefile* mf)
+    : GG(mf->GetGlobalGenerator())
   {
 #if defined(_WIN32) || defined(__CYGWIN__) || defined(__MINGW32__)
     // Consider platform-specific extensions.
@@ -25,6 +27,9 @@ struct cmFindProgramHelper
     this->Extensions.emplace_back();
   }
 
+  // Global generator holding the cached directory listings.
+  cmGlobalGenerator* GG;
+
   // List of valid extensions.
   std::vector<std::string> Extensions;
 
@@ -76,6 +81,9 @@ struct cmFindProgramHelper
       }
       this->TestNameExt = name;
       this->TestNameExt += ext;
+      if (!this->GG->DirectoryMayContain(path, this->TestNameExt)) {
+        continue;
+      }
       this->TestPath =
         cmSystemTools::CollapseCombinedPath(path, this->TestNameExt);
 
@@ -158,7 +166,7 @@ std::string cmFindProgramCommand::FindNormalProgram()
 std::string cmFindProgramCommand::FindNormalProgramNamesPerDir()
 {
   // Search for all names in each directory.
-  cmFindProgramHelper helper;
+  cmFindProgramHelper helper(this->Makefile);
   for (std::string const& n : this->Names) {
     helper.AddName(n);
   }
@@ -181,7 +189,7 @@ std::string cmFindProgramCommand::FindNormalProgramNamesPerDir()
 std::string cmFindProgramCommand::FindNormalProgramDirsPerName()
 {
   // Search the entire path for each name.
-  cmFindProgramHelper helper;
+  cmFindProgramHelper helper(this->Makefile);
   for (std::string const& n : this->Names) {
     // Switch to searching for this name.
     helper.SetName(n);
@@ -101,6 +101,10 @@ public:
 
   // Set of files included in the translation unit.
   std::set<std::string> Includes;
+
+  // Paths checked for included files that did not exist.  A file
+  // created at one of them would be included instead.
+  std::set<std::string> MissingIncludes;
 };
 
 // Parser methods not included in generated interface.
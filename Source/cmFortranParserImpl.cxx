@@ -17,7 +17,11 @@ bool cmFortranParser_s::FindIncludeFile(const char* dir,
   // If the file is a full path, include it directly.
   if (cmSystemTools::FileIsFullPath(includeName)) {
     fileName = includeName;
-    return cmSystemTools::FileExists(fileName, true);
+    if (cmSystemTools::FileExists(fileName, true)) {
+      return true;
+    }
+    this->Info.MissingIncludes.insert(fileName);
+    return false;
   }
   // Check for the file in the directory containing the including
   // file.
@@ -28,6 +32,7 @@ bool cmFortranParser_s::FindIncludeFile(const char* dir,
     fileName = fullName;
     return true;
   }
+  this->Info.MissingIncludes.insert(fullName);
 
   // Search the include path for the file.
   for (std::string const& i : this->IncludePath) {
@@ -38,6 +43,7 @@ bool cmFortranParser_s::FindIncludeFile(const char* dir,
       fileName = fullName;
       return true;
     }
+    this->Info.MissingIncludes.insert(fullName);
   }
   return false;
 }
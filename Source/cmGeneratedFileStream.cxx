@@ -9,6 +9,128 @@
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 #  include "cm_codecvt.hxx"
 #  include "cm_zlib.h"
+
+#  include <condition_variable>
+#  include <deque>
+#  include <mutex>
+#  include <set>
+#  include <thread>
+#  include <utility>
+#  include <vector>
+#endif
+
+// Compare the temporary file against the destination and replace the
+// destination if needed.  Returns whether it was replaced.
+static bool cmGeneratedFileCommit(std::string const& tempName,
+                                  std::string const& name,
+                                  bool copyIfDifferent)
+{
+  bool replaced = false;
+  if (!copyIfDifferent || cmSystemTools::FilesDiffer(tempName, name)) {
+    // The destination is to be replaced.  Rename the temporary to the
+    // destination atomically.
+    cmSystemTools::RenameFile(tempName.c_str(), name.c_str());
+    replaced = true;
+  }
+
+  // Always delete the temporary file. We never want it to stay around.
+  cmSystemTools::RemoveFile(tempName);
+
+  return replaced;
+}
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+namespace {
+// Queue of closed temporary files waiting to replace their destination.
+class cmGeneratedFileCommitQueue
+{
+public:
+  struct Job
+  {
+    std::string TempName;
+    std::string Name;
+    bool CopyIfDifferent;
+  };
+
+  cmGeneratedFileCommitQueue(unsigned int threads)
+    : Stop(false)
+  {
+    for (unsigned int i = 0; i < threads; ++i) {
+      this->Workers.emplace_back([this]() { this->Run(); });
+    }
+  }
+
+  ~cmGeneratedFileCommitQueue()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      this->Stop = true;
+    }
+    this->JobReady.notify_all();
+    for (std::thread& worker : this->Workers) {
+      worker.join();
+    }
+  }
+
+  void Push(Job job)
+  {
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      // Keep commits of the same destination in order.
+      this->WaitForLocked(lock, job.Name);
+      this->Pending.insert(job.Name);
+      this->Jobs.push_back(std::move(job));
+    }
+    this->JobReady.notify_one();
+  }
+
+  void WaitFor(std::string const& name)
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    this->WaitForLocked(lock, name);
+  }
+
+private:
+  void WaitForLocked(std::unique_lock<std::mutex>& lock,
+                     std::string const& name)
+  {
+    while (this->Pending.count(name)) {
+      this->JobDone.wait(lock);
+    }
+  }
+
+  void Run()
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    for (;;) {
+      while (this->Jobs.empty() && !this->Stop) {
+        this->JobReady.wait(lock);
+      }
+      if (this->Jobs.empty()) {
+        return;
+      }
+      Job job = std::move(this->Jobs.front());
+      this->Jobs.pop_front();
+      lock.unlock();
+      cmGeneratedFileCommit(job.TempName, job.Name, job.CopyIfDifferent);
+      lock.lock();
+      this->Pending.erase(job.Name);
+      this->JobDone.notify_all();
+    }
+  }
+
+  std::mutex Mutex;
+  std::condition_variable JobReady;
+  std::condition_variable JobDone;
+  std::deque<Job> Jobs;
+  std::set<std::string> Pending;
+  std::vector<std::thread> Workers;
+  bool Stop;
+};
+
+// The queue is only created and destroyed on the main thread.
+cmGeneratedFileCommitQueue* ActiveCommitQueue = nullptr;
+}
 #endif
 
 cmGeneratedFileStream::cmGeneratedFileStream(Encoding encoding)
@@ -127,7 +249,7 @@ cmGeneratedFileStreamBase::cmGeneratedFileStreamBase(std::string const& name)
 
 cmGeneratedFileStreamBase::~cmGeneratedFileStreamBase()
 {
-  this->Close();
+  this->CloseDeferred();
 }
 
 void cmGeneratedFileStreamBase::Open(std::string const& name)
@@ -143,6 +265,13 @@ void cmGeneratedFileStreamBase::Open(std::string const& name)
   this->TempName += ".tmp";
 #endif
 
+#ifdef CMAKE_BUILD_WITH_CMAKE
+  // A previous stream for the same file may not be committed yet.
+  if (ActiveCommitQueue) {
+    ActiveCommitQueue->WaitFor(name);
+  }
+#endif
+
   // Make sure the temporary file that will be used is not present.
   cmSystemTools::RemoveFile(this->TempName);
 
@@ -150,8 +279,38 @@ void cmGeneratedFileStreamBase::Open(std::string const& name)
   cmSystemTools::MakeDirectory(dir);
 }
 
+void cmGeneratedFileStreamBase::CloseDeferred()
+{
+#ifdef CMAKE_BUILD_WITH_CMAKE
+  if (ActiveCommitQueue && !this->TempName.empty() && !this->Compress &&
+      !this->Name.empty() && this->Okay) {
+    cmGeneratedFileCommitQueue::Job job;
+    job.TempName = this->TempName;
+    job.Name = this->Name;
+    job.CopyIfDifferent = this->CopyIfDifferent;
+    ActiveCommitQueue->Push(std::move(job));
+    this->TempName.clear();
+    return;
+  }
+#endif
+  this->Close();
+}
+
 bool cmGeneratedFileStreamBase::Close()
 {
+  // The temporary file was already committed or queued for commit.
+  if (this->TempName.empty()) {
+    return false;
+  }
+
+#ifdef CMAKE_BUILD_WITH_CMAKE
+  // The name may have changed since the stream was opened.  Do not race
+  // a queued commit of the same destination.
+  if (ActiveCommitQueue) {
+    ActiveCommitQueue->WaitFor(this->Name);
+  }
+#endif
+
   bool replaced = false;
 
   std::string resname = this->Name;
@@ -161,28 +320,32 @@ bool cmGeneratedFileStreamBase::Close()
 
   // Only consider replacing the destination file if no error
   // occurred.
-  if (!this->Name.empty() && this->Okay &&
-      (!this->CopyIfDifferent ||
-       cmSystemTools::FilesDiffer(this->TempName, resname))) {
-    // The destination is to be replaced.  Rename the temporary to the
-    // destination atomically.
+  if (!this->Name.empty() && this->Okay) {
     if (this->Compress) {
-      std::string gzname = this->TempName + ".temp.gz";
-      if (this->CompressFile(this->TempName, gzname)) {
-        this->RenameFile(gzname, resname);
+      if (!this->CopyIfDifferent ||
+          cmSystemTools::FilesDiffer(this->TempName, resname)) {
+        // The destination is to be replaced.  Rename the compressed
+        // temporary to the destination atomically.
+        std::string gzname = this->TempName + ".temp.gz";
+        if (this->CompressFile(this->TempName, gzname)) {
+          this->RenameFile(gzname, resname);
+        }
+        cmSystemTools::RemoveFile(gzname);
+        replaced = true;
       }
-      cmSystemTools::RemoveFile(gzname);
     } else {
-      this->RenameFile(this->TempName, resname);
+      replaced = cmGeneratedFileCommit(this->TempName, resname,
+                                       this->CopyIfDifferent);
+      this->TempName.clear();
+      return replaced;
     }
-
-    replaced = true;
   }
 
   // Else, the destination was not replaced.
   //
   // Always delete the temporary file. We never want it to stay around.
   cmSystemTools::RemoveFile(this->TempName);
+  this->TempName.clear();
 
   return replaced;
 }
@@ -231,3 +394,26 @@ void cmGeneratedFileStream::SetName(const std::string& fname)
 {
   this->Name = fname;
 }
+
+cmGeneratedFileStream::DeferredCommit::DeferredCommit(unsigned int threads)
+  : Owner(false)
+{
+#ifdef CMAKE_BUILD_WITH_CMAKE
+  if (!ActiveCommitQueue && threads > 0) {
+    ActiveCommitQueue = new cmGeneratedFileCommitQueue(threads);
+    this->Owner = true;
+  }
+#else
+  static_cast<void>(threads);
+#endif
+}
+
+cmGeneratedFileStream::DeferredCommit::~DeferredCommit()
+{
+#ifdef CMAKE_BUILD_WITH_CMAKE
+  if (this->Owner) {
+    delete ActiveCommitQueue;
+    ActiveCommitQueue = nullptr;
+  }
+#endif
+}
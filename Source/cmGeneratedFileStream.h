@@ -29,8 +29,11 @@ protected:
   // called before the real stream is opened.  Close is always called
   // after the real stream is closed and Okay is set to whether the
   // real stream was still valid for writing when it was closed.
+  // Close replaces the destination before it returns.  CloseDeferred
+  // may instead queue the replacement while a DeferredCommit is active.
   void Open(std::string const& name);
   bool Close();
+  void CloseDeferred();
 
   // Internal file replacement implementation.
   int RenameFile(std::string const& oldname, std::string const& newname);
@@ -110,10 +113,33 @@ public:
    * Close the output file.  This should be used only with an open
    * stream.  The temporary file is atomically renamed to the
    * destination file if the stream is still valid when this method
-   * is called.
+   * is called.  Returns whether the destination was replaced.
    */
   bool Close();
 
+  /** \class DeferredCommit
+   * \brief Replace destination files on worker threads.
+   *
+   * While an instance exists, destroying an uncompressed stream that
+   * was not closed explicitly hands the copy-if-different comparison
+   * and the rename of the temporary file to a pool of worker threads.
+   * An explicit Close still replaces the file before it returns.
+   * Opening a stream for a file whose commit is still pending waits
+   * for that commit first.  The destructor waits until all queued
+   * files have been replaced.  Nested instances have no effect.
+   */
+  class DeferredCommit
+  {
+  public:
+    DeferredCommit(unsigned int threads);
+    ~DeferredCommit();
+
+  private:
+    DeferredCommit(DeferredCommit const&); // not implemented
+    void operator=(DeferredCommit const&); // not implemented
+    bool Owner;
+  };
+
   /**
    * Set whether copy-if-different is done.
    */
@@ -135,6 +161,12 @@ public:
    */
   void SetName(const std::string& fname);
 
+  /**
+   * Get the name of the temporary file receiving the output until the
+   * stream is closed.
+   */
+  std::string const& GetTempName() const { return this->TempName; }
+
 private:
   cmGeneratedFileStream(cmGeneratedFileStream const&); // not implemented
 };
@@ -3,7 +3,11 @@
 #include "cmGeneratorExpression.h"
 
 #include "cmsys/RegularExpression.hxx"
+#include <algorithm>
+#include <chrono>
+#include <map>
 #include <memory> // IWYU pragma: keep
+#include <tuple>
 #include <utility>
 
 #include "assert.h"
@@ -13,7 +17,45 @@
 #include "cmGeneratorExpressionEvaluator.h"
 #include "cmGeneratorExpressionLexer.h"
 #include "cmGeneratorExpressionParser.h"
+#include "cmLocalGenerator.h"
+#include "cmMessenger.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
+
+namespace {
+// Everything an evaluation produces that callers may query afterwards.
+struct cmGeneratorExpressionCacheEntry
+{
+  std::string Output;
+  std::set<cmGeneratorTarget*> DependTargets;
+  std::set<cmGeneratorTarget const*> AllTargetsSeen;
+  std::set<std::string> SeenTargetProperties;
+  std::map<cmGeneratorTarget const*, std::map<std::string, std::string>>
+    MaxLanguageStandard;
+  std::set<cmGeneratorTarget const*> SourceSensitiveTargets;
+  bool HadContextSensitiveCondition;
+  bool HadHeadSensitiveCondition;
+};
+
+typedef std::tuple<cmLocalGenerator const*, cmGeneratorTarget const*,
+                   cmGeneratorTarget const*, bool, bool, std::string,
+                   std::string, std::string>
+  cmGeneratorExpressionCacheKey;
+
+struct cmGeneratorExpressionEvaluationCache
+{
+  bool Enabled = false;
+  unsigned int Depth = 0;
+  // Results of context independent expressions, keyed by input.
+  std::map<std::string, cmGeneratorExpressionCacheEntry> Constant;
+  // Results keyed by the evaluation context and input.
+  std::map<cmGeneratorExpressionCacheKey, cmGeneratorExpressionCacheEntry>
+    Results;
+  cmGeneratorExpression::EvaluationStatistics Statistics;
+};
+
+cmGeneratorExpressionEvaluationCache EvaluationCache;
+}
 
 cmGeneratorExpression::cmGeneratorExpression(
   const cmListFileBacktrace& backtrace)
@@ -38,6 +80,29 @@ cmGeneratorExpression::~cmGeneratorExpression()
 {
 }
 
+void cmGeneratorExpression::SetEvaluationCacheEnabled(bool enabled)
+{
+  EvaluationCache.Enabled = enabled;
+  InvalidateEvaluationCache();
+}
+
+void cmGeneratorExpression::InvalidateEvaluationCache()
+{
+  EvaluationCache.Constant.clear();
+  EvaluationCache.Results.clear();
+}
+
+cmGeneratorExpression::EvaluationStatistics const&
+cmGeneratorExpression::GetEvaluationStatistics()
+{
+  return EvaluationCache.Statistics;
+}
+
+void cmGeneratorExpression::ResetEvaluationStatistics()
+{
+  EvaluationCache.Statistics = EvaluationStatistics();
+}
+
 const std::string& cmCompiledGeneratorExpression::Evaluate(
   cmLocalGenerator* lg, const std::string& config, bool quiet,
   const cmGeneratorTarget* headTarget,
@@ -69,6 +134,62 @@ const std::string& cmCompiledGeneratorExpression::EvaluateWithContext(
     return this->Input;
   }
 
+  cmGeneratorExpressionEvaluationCache& cache = EvaluationCache;
+  ++cache.Statistics.Evaluations;
+
+  // The DAG checker records what has been seen during the outermost
+  // evaluation, so only results not depending on it may be reused.
+  cmGeneratorExpressionCacheEntry* cached = nullptr;
+  cmGeneratorExpressionCacheKey key;
+  bool const cacheable = cache.Enabled && context.LG &&
+    (this->ContextIndependent || !dagChecker);
+  if (cacheable) {
+    if (this->ContextIndependent) {
+      auto it = cache.Constant.find(this->Input);
+      if (it != cache.Constant.end()) {
+        cached = &it->second;
+      }
+    } else {
+      key = cmGeneratorExpressionCacheKey(
+        context.LG, context.HeadTarget, context.CurrentTarget, context.Quiet,
+        context.EvaluateForBuildsystem, context.Config, context.Language,
+        this->Input);
+      auto it = cache.Results.find(key);
+      if (it != cache.Results.end()) {
+        cached = &it->second;
+      }
+    }
+    if (cached) {
+      ++cache.Statistics.CacheHits;
+      this->Output = cached->Output;
+      this->SeenTargetProperties.insert(cached->SeenTargetProperties.begin(),
+                                        cached->SeenTargetProperties.end());
+      this->MaxLanguageStandard = cached->MaxLanguageStandard;
+      this->HadContextSensitiveCondition =
+        cached->HadContextSensitiveCondition;
+      this->HadHeadSensitiveCondition = cached->HadHeadSensitiveCondition;
+      this->SourceSensitiveTargets = cached->SourceSensitiveTargets;
+      this->DependTargets = cached->DependTargets;
+      this->AllTargetsSeen = cached->AllTargetsSeen;
+      return this->Output;
+    }
+    ++cache.Statistics.CacheMisses;
+  }
+
+  // Results that issued diagnostics are not memoized so that repeated
+  // evaluations report them again.
+  cmMessenger const* messenger =
+    cacheable ? context.LG->GetCMakeInstance()->GetMessenger() : nullptr;
+  unsigned long const messageCount =
+    messenger ? messenger->GetMessageCount() : 0;
+
+  bool const outermost = cache.Depth == 0;
+  std::chrono::steady_clock::time_point start;
+  if (outermost) {
+    start = std::chrono::steady_clock::now();
+  }
+  ++cache.Depth;
+
   this->Output.clear();
 
   std::vector<cmGeneratorExpressionEvaluator*>::const_iterator it =
@@ -97,6 +218,29 @@ const std::string& cmCompiledGeneratorExpression::EvaluateWithContext(
 
   this->DependTargets = context.DependTargets;
   this->AllTargetsSeen = context.AllTargets;
+
+  --cache.Depth;
+  if (outermost) {
+    cache.Statistics.Seconds += std::chrono::duration<double>(
+                                  std::chrono::steady_clock::now() - start)
+                                  .count();
+  }
+
+  // Evaluation may have invalidated the cache or disabled it.
+  if (cacheable && cache.Enabled && !context.HadError &&
+      messenger->GetMessageCount() == messageCount) {
+    cmGeneratorExpressionCacheEntry& entry = this->ContextIndependent
+      ? cache.Constant[this->Input]
+      : cache.Results[key];
+    entry.Output = this->Output;
+    entry.DependTargets = this->DependTargets;
+    entry.AllTargetsSeen = this->AllTargetsSeen;
+    entry.SeenTargetProperties = context.SeenTargetProperties;
+    entry.MaxLanguageStandard = this->MaxLanguageStandard;
+    entry.SourceSensitiveTargets = this->SourceSensitiveTargets;
+    entry.HadContextSensitiveCondition = this->HadContextSensitiveCondition;
+    entry.HadHeadSensitiveCondition = this->HadHeadSensitiveCondition;
+  }
   return this->Output;
 }
 
@@ -111,10 +255,16 @@ cmCompiledGeneratorExpression::cmCompiledGeneratorExpression(
   cmGeneratorExpressionLexer l;
   std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(this->Input);
   this->NeedsEvaluation = l.GetSawGeneratorExpression();
+  this->ContextIndependent = false;
 
   if (this->NeedsEvaluation) {
     cmGeneratorExpressionParser p(tokens);
     p.Parse(this->Evaluators);
+    this->ContextIndependent = std::all_of(
+      this->Evaluators.begin(), this->Evaluators.end(),
+      [](cmGeneratorExpressionEvaluator const* e) {
+        return e->IsContextIndependent();
+      });
   }
 }
 
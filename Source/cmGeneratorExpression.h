@@ -72,6 +72,31 @@ public:
     return input != nullptr && input[0] == '$' && input[1] == '<';
   }
 
+  /** Counters describing the cost of generator expression evaluation.  */
+  struct EvaluationStatistics
+  {
+    unsigned long Evaluations = 0;
+    unsigned long CacheHits = 0;
+    unsigned long CacheMisses = 0;
+    double Seconds = 0;
+  };
+
+  /**
+   * Enable or disable memoization of evaluation results.  While
+   * enabled, results of expressions that do not depend on the
+   * evaluation context, and results of expressions evaluated without a
+   * DAG checker, are reused when the same expression is evaluated again
+   * in the same context.  Disabling drops all memoized results.
+   */
+  static void SetEvaluationCacheEnabled(bool enabled);
+
+  /** Drop all memoized results.  Call when inputs of evaluation, such
+      as target properties, change while the cache is enabled.  */
+  static void InvalidateEvaluationCache();
+
+  static EvaluationStatistics const& GetEvaluationStatistics();
+  static void ResetEvaluationStatistics();
+
 private:
   cmListFileBacktrace Backtrace;
 };
@@ -149,6 +174,7 @@ private:
   std::vector<cmGeneratorExpressionEvaluator*> Evaluators;
   const std::string Input;
   bool NeedsEvaluation;
+  bool ContextIndependent;
 
   mutable std::set<cmGeneratorTarget*> DependTargets;
   mutable std::set<cmGeneratorTarget const*> AllTargetsSeen;
@@ -21,6 +21,31 @@ std::string GeneratorExpressionContent::GetOriginalExpression() const
   return std::string(this->StartContent, this->ContentLength);
 }
 
+bool GeneratorExpressionContent::IsContextIndependent() const
+{
+  // The node must be known without evaluating anything.
+  std::string identifier;
+  for (cmGeneratorExpressionEvaluator* child : this->IdentifierChildren) {
+    if (child->GetType() != cmGeneratorExpressionEvaluator::Text) {
+      return false;
+    }
+    identifier += child->Evaluate(nullptr, nullptr);
+  }
+  const cmGeneratorExpressionNode* node =
+    cmGeneratorExpressionNode::GetNode(identifier);
+  if (!node || !node->IsContextIndependent()) {
+    return false;
+  }
+  for (auto const& param : this->ParamChildren) {
+    for (cmGeneratorExpressionEvaluator* child : param) {
+      if (!child->IsContextIndependent()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 std::string GeneratorExpressionContent::ProcessArbitraryContent(
   const cmGeneratorExpressionNode* node, const std::string& identifier,
   cmGeneratorExpressionContext* context,
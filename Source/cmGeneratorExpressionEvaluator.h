@@ -27,6 +27,9 @@ struct cmGeneratorExpressionEvaluator
 
   virtual Type GetType() const = 0;
 
+  // Whether the result is the same in every evaluation context.
+  virtual bool IsContextIndependent() const = 0;
+
   virtual std::string Evaluate(cmGeneratorExpressionContext* context,
                                cmGeneratorExpressionDAGChecker*) const = 0;
 
@@ -53,6 +56,8 @@ struct TextContent : public cmGeneratorExpressionEvaluator
     return cmGeneratorExpressionEvaluator::Text;
   }
 
+  bool IsContextIndependent() const override { return true; }
+
   void Extend(size_t length) { this->Length += length; }
 
   size_t GetLength() { return this->Length; }
@@ -82,6 +87,8 @@ struct GeneratorExpressionContent : public cmGeneratorExpressionEvaluator
     return cmGeneratorExpressionEvaluator::Generator;
   }
 
+  bool IsContextIndependent() const override;
+
   std::string Evaluate(cmGeneratorExpressionContext* context,
                        cmGeneratorExpressionDAGChecker*) const override;
 
@@ -57,6 +57,8 @@ static const struct ZeroNode : public cmGeneratorExpressionNode
 {
   ZeroNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   bool GeneratesContent() const override { return false; }
 
   bool AcceptsArbitraryContentParameter() const override { return true; }
@@ -75,6 +77,8 @@ static const struct OneNode : public cmGeneratorExpressionNode
 {
   OneNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -95,6 +99,7 @@ static const struct ZeroNode installInterfaceNode;
   static const struct OP##Node : public cmGeneratorExpressionNode             \
   {                                                                           \
     OP##Node() {}                                                             \
+    bool IsContextIndependent() const override { return true; }               \
     virtual int NumExpectedParameters() const { return OneOrMoreParameters; } \
                                                                               \
     std::string Evaluate(const std::vector<std::string>& parameters,          \
@@ -128,6 +133,8 @@ static const struct NotNode : public cmGeneratorExpressionNode
 {
   NotNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   std::string Evaluate(
     const std::vector<std::string>& parameters,
     cmGeneratorExpressionContext* context,
@@ -148,6 +155,8 @@ static const struct BoolNode : public cmGeneratorExpressionNode
 {
   BoolNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 1; }
 
   std::string Evaluate(
@@ -164,6 +173,8 @@ static const struct IfNode : public cmGeneratorExpressionNode
 {
   IfNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 3; }
 
   std::string Evaluate(const std::vector<std::string>& parameters,
@@ -185,6 +196,8 @@ static const struct StrEqualNode : public cmGeneratorExpressionNode
 {
   StrEqualNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -201,6 +214,8 @@ static const struct EqualNode : public cmGeneratorExpressionNode
 {
   EqualNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -279,6 +294,8 @@ static const struct InListNode : public cmGeneratorExpressionNode
 {
   InListNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -476,6 +493,8 @@ static const struct LowerCaseNode : public cmGeneratorExpressionNode
 {
   LowerCaseNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -492,6 +511,8 @@ static const struct UpperCaseNode : public cmGeneratorExpressionNode
 {
   UpperCaseNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -508,6 +529,8 @@ static const struct MakeCIdentifierNode : public cmGeneratorExpressionNode
 {
   MakeCIdentifierNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   bool AcceptsArbitraryContentParameter() const override { return true; }
 
   std::string Evaluate(
@@ -524,6 +547,8 @@ static const struct Angle_RNode : public cmGeneratorExpressionNode
 {
   Angle_RNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 0; }
 
   std::string Evaluate(
@@ -540,6 +565,8 @@ static const struct CommaNode : public cmGeneratorExpressionNode
 {
   CommaNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 0; }
 
   std::string Evaluate(
@@ -556,6 +583,8 @@ static const struct SemicolonNode : public cmGeneratorExpressionNode
 {
   SemicolonNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 0; }
 
   std::string Evaluate(
@@ -780,6 +809,8 @@ static const struct VersionGreaterNode : public cmGeneratorExpressionNode
 {
   VersionGreaterNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -800,6 +831,8 @@ static const struct VersionGreaterEqNode : public cmGeneratorExpressionNode
 {
   VersionGreaterEqNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -820,6 +853,8 @@ static const struct VersionLessNode : public cmGeneratorExpressionNode
 {
   VersionLessNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -840,6 +875,8 @@ static const struct VersionLessEqNode : public cmGeneratorExpressionNode
 {
   VersionLessEqNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -860,6 +897,8 @@ static const struct VersionEqualNode : public cmGeneratorExpressionNode
 {
   VersionEqualNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   std::string Evaluate(
@@ -978,6 +1017,8 @@ static const struct JoinNode : public cmGeneratorExpressionNode
 {
   JoinNode() {}
 
+  bool IsContextIndependent() const override { return true; }
+
   int NumExpectedParameters() const override { return 2; }
 
   bool AcceptsArbitraryContentParameter() const override { return true; }
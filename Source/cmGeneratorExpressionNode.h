@@ -32,6 +32,9 @@ struct cmGeneratorExpressionNode
 
   virtual int NumExpectedParameters() const { return 1; }
 
+  // Whether the result depends only on the parameters.
+  virtual bool IsContextIndependent() const { return false; }
+
   virtual std::string Evaluate(
     const std::vector<std::string>& parameters,
     cmGeneratorExpressionContext* context,
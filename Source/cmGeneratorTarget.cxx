@@ -362,6 +362,7 @@ void cmGeneratorTarget::AddSourceCommon(const std::string& src)
   cge->SetEvaluateForBuildsystem(true);
   this->SourceEntries.push_back(new TargetPropertyEntry(std::move(cge)));
   this->ClearSourcesCache();
+  cmGeneratorExpression::InvalidateEvaluationCache();
 }
 
 void cmGeneratorTarget::AddSource(const std::string& src)
@@ -392,6 +393,7 @@ void cmGeneratorTarget::AddIncludeDirectory(const std::string& src,
     : this->IncludeDirectoriesEntries.end();
   this->IncludeDirectoriesEntries.insert(
     pos, new TargetPropertyEntry(std::move(cge)));
+  cmGeneratorExpression::InvalidateEvaluationCache();
 }
 
 std::vector<cmSourceFile*> const* cmGeneratorTarget::GetSourceDepends(
@@ -4690,6 +4692,13 @@ cmLinkInterface const* cmGeneratorTarget::GetLinkInterface(
   return iface.Exists ? &iface : nullptr;
 }
 
+bool cmGeneratorTarget::LinkInterfaceDependsOnHead(
+  const std::string& config) const
+{
+  cmHeadToLinkInterfaceMap& hm = this->GetHeadToLinkInterfaceMap(config);
+  return !hm.empty() && hm.begin()->second.HadHeadSensitiveCondition;
+}
+
 void cmGeneratorTarget::ComputeLinkInterface(
   const std::string& config, cmOptionalLinkInterface& iface,
   cmGeneratorTarget const* headTarget) const
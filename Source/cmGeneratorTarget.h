@@ -196,6 +196,10 @@ public:
 
   cmLinkInterface const* GetLinkInterface(
     const std::string& config, const cmGeneratorTarget* headTarget) const;
+
+  /** Return whether the link interface computed by GetLinkInterface for
+      the given configuration depends on the head target.  */
+  bool LinkInterfaceDependsOnHead(const std::string& config) const;
   void ComputeLinkInterface(const std::string& config,
                             cmOptionalLinkInterface& iface,
                             const cmGeneratorTarget* head) const;
@@ -11,6 +11,7 @@
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 #if defined(_WIN32) && !defined(__CYGWIN__)
 #  include <windows.h>
@@ -18,6 +19,7 @@
 
 #include "cmAlgorithms.h"
 #include "cmCPackPropertiesGenerator.h"
+#include "cmComputeLinkDepends.h"
 #include "cmComputeTargetDepends.h"
 #include "cmCustomCommand.h"
 #include "cmCustomCommandLines.h"
@@ -48,6 +50,8 @@
 #  include "cmCryptoHash.h"
 #  include "cm_jsoncpp_value.h"
 #  include "cm_jsoncpp_writer.h"
+
+#  include <thread>
 #endif
 
 #if defined(_MSC_VER) && _MSC_VER >= 1800
@@ -94,6 +98,8 @@ cmGlobalGenerator::cmGlobalGenerator(cmake* cm)
   this->ExtraGenerator = nullptr;
   this->CurrentConfigureMakefile = nullptr;
   this->TryCompileOuterMakefile = nullptr;
+  this->LinkDependsCache = nullptr;
+  this->FindPackageConfigSearchesChanged = false;
 
   this->ConfigureDoneCMP0026AndCMP0024 = false;
   this->FirstTimeProgress = 0.0f;
@@ -1153,6 +1159,19 @@ void cmGlobalGenerator::Configure()
   this->FirstTimeProgress = 0.0f;
   this->ClearGeneratorMembers();
 
+  // Start from the directory listings of the last configure step.
+  std::string const directoryContentFile =
+    this->CMakeInstance->GetHomeOutputDirectory() +
+    cmake::GetCMakeFilesDirectory() + "/CMakeDirectoryContent.txt";
+  bool const persistDirectoryContent =
+    !this->CMakeInstance->GetIsInTryCompile();
+  std::string findPackageCacheFile;
+  if (persistDirectoryContent) {
+    this->LoadDirectoryContent(directoryContentFile);
+    findPackageCacheFile = this->GetFindPackageCacheFile();
+    this->LoadFindPackageConfigSearches(findPackageCacheFile);
+  }
+
   cmStateSnapshot snapshot = this->CMakeInstance->GetCurrentSnapshot();
 
   snapshot.GetDirectory().SetCurrentSource(
@@ -1172,6 +1191,11 @@ void cmGlobalGenerator::Configure()
   dirMf->Configure();
   dirMf->EnforceDirectoryLevelRules();
 
+  if (persistDirectoryContent) {
+    this->WriteDirectoryContent(directoryContentFile);
+    this->WriteFindPackageConfigSearches(findPackageCacheFile);
+  }
+
   this->ConfigureDoneCMP0026AndCMP0024 = true;
 
   // Put a copy of each global target in every directory.
@@ -1384,19 +1408,31 @@ void cmGlobalGenerator::Generate()
 
   this->ProcessEvaluationFiles();
 
-  // Generate project files
-  for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i) {
-    this->SetCurrentMakefile(this->LocalGenerators[i]->GetMakefile());
-    this->LocalGenerators[i]->Generate();
-    if (!this->LocalGenerators[i]->GetMakefile()->IsOn(
-          "CMAKE_SKIP_INSTALL_RULES")) {
-      this->LocalGenerators[i]->GenerateInstallRules();
+  {
+    // Replace the generated files on worker threads while the next
+    // directories are being generated.
+    unsigned int commitThreads = 0;
+#ifdef CMAKE_BUILD_WITH_CMAKE
+    if (this->SupportsDeferredFileCommit()) {
+      commitThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+#endif
+    cmGeneratedFileStream::DeferredCommit deferredCommit(commitThreads);
+
+    // Generate project files
+    for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i) {
+      this->SetCurrentMakefile(this->LocalGenerators[i]->GetMakefile());
+      this->LocalGenerators[i]->Generate();
+      if (!this->LocalGenerators[i]->GetMakefile()->IsOn(
+            "CMAKE_SKIP_INSTALL_RULES")) {
+        this->LocalGenerators[i]->GenerateInstallRules();
+      }
+      this->LocalGenerators[i]->GenerateTestFiles();
+      this->CMakeInstance->UpdateProgress(
+        "Generating",
+        (static_cast<float>(i) + 1.0f) /
+          static_cast<float>(this->LocalGenerators.size()));
     }
-    this->LocalGenerators[i]->GenerateTestFiles();
-    this->CMakeInstance->UpdateProgress(
-      "Generating",
-      (static_cast<float>(i) + 1.0f) /
-        static_cast<float>(this->LocalGenerators.size()));
   }
   this->SetCurrentMakefile(nullptr);
 
@@ -1657,6 +1693,10 @@ void cmGlobalGenerator::ClearGeneratorMembers()
   cmDeleteAll(this->LocalGenerators);
   this->LocalGenerators.clear();
 
+  // The cache refers to the generator targets.
+  delete this->LinkDependsCache;
+  this->LinkDependsCache = nullptr;
+
   this->ExportSets.clear();
   this->TargetDependencies.clear();
   this->TargetSearchIndex.clear();
@@ -1666,6 +1706,8 @@ void cmGlobalGenerator::ClearGeneratorMembers()
   this->ProjectMap.clear();
   this->RuleHashes.clear();
   this->DirectoryContentMap.clear();
+  this->FindPackageConfigSearches.clear();
+  this->FindPackageConfigSearchesChanged = false;
   this->BinaryDirectories.clear();
 }
 
@@ -1755,7 +1797,8 @@ int cmGlobalGenerator::TryCompile(int jobs, const std::string& srcdir,
                                   const std::string& bindir,
                                   const std::string& projectName,
                                   const std::string& target, bool fast,
-                                  std::string& output, cmMakefile* mf)
+                                  bool keepGoing, std::string& output,
+                                  cmMakefile* mf)
 {
   // if this is not set, then this is a first time configure
   // and there is a good chance that the try compile stuff will
@@ -1792,8 +1835,13 @@ int cmGlobalGenerator::TryCompile(int jobs, const std::string& srcdir,
   }
   std::string config =
     mf->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
+  std::vector<std::string> nativeOptions;
+  if (keepGoing) {
+    nativeOptions = this->GetKeepGoingBuildOptions();
+  }
   return this->Build(jobs, srcdir, bindir, projectName, newTarget, output, "",
-                     config, false, fast, false, this->TryCompileTimeout);
+                     config, false, fast, false, this->TryCompileTimeout,
+                     cmSystemTools::OUTPUT_NONE, nativeOptions);
 }
 
 void cmGlobalGenerator::GenerateBuildCommand(
@@ -2805,28 +2853,255 @@ std::set<std::string> const& cmGlobalGenerator::GetDirectoryContent(
 {
   DirectoryContent& dc = this->DirectoryContentMap[dir];
   if (needDisk) {
+    dc.Unused = false;
+    // Check the modification time once per generation of the stat cache,
+    // which changes whenever CMake modifies files or runs processes.
+    unsigned long const generation = cmSystemTools::GetStatCacheGeneration();
+    if (generation != 0 && dc.LastDiskTime != -1 &&
+        dc.StatGeneration == generation) {
+      return dc.All;
+    }
+    dc.StatGeneration = generation;
     long mt = cmSystemTools::ModifiedTime(dir);
     if (mt != dc.LastDiskTime) {
       // Reset to non-loaded directory content.
       dc.All = dc.Generated;
+      dc.Folded.clear();
 
-      // Load the directory content from disk.
+      // Load the directory content from disk.  A missing directory has
+      // no entries, but one that cannot be read may have any.
       cmsys::Directory d;
+      dc.Complete = mt == 0;
       if (d.Load(dir)) {
+        dc.Complete = true;
         unsigned long n = d.GetNumberOfFiles();
         for (unsigned long i = 0; i < n; ++i) {
           const char* f = d.GetFile(i);
           if (strcmp(f, ".") != 0 && strcmp(f, "..") != 0) {
             dc.All.insert(f);
+#if defined(_WIN32) || defined(__APPLE__)
+            dc.Folded.insert(cmSystemTools::LowerCase(f));
+#endif
           }
         }
       }
       dc.LastDiskTime = mt;
+
+      // The modification time has a resolution of one second, so a
+      // listing read in the second of the last change may miss a later
+      // change in the same second.  Read it again next time.
+      if (mt >= static_cast<long>(time(nullptr))) {
+        dc.LastDiskTime = -1;
+      }
     }
   }
   return dc.All;
 }
 
+bool cmGlobalGenerator::DirectoryMayContain(std::string const& dir,
+                                            std::string const& name)
+{
+  // Only the first component of a relative name is in the listing.
+  std::string const first = name.substr(0, name.find('/'));
+  if (dir.empty() || first.empty() || first == "." || first == ".." ||
+      first.find('\\') != std::string::npos) {
+    return true;
+  }
+  std::string d = dir;
+  cmSystemTools::ConvertToUnixSlashes(d);
+  this->GetDirectoryContent(d);
+  DirectoryContent const& dc = this->DirectoryContentMap[d];
+  if (!dc.Complete || dc.All.count(first) > 0) {
+    return true;
+  }
+#if defined(_WIN32) || defined(__APPLE__)
+  return dc.Folded.count(cmSystemTools::LowerCase(first)) > 0;
+#else
+  return false;
+#endif
+}
+
+void cmGlobalGenerator::LoadDirectoryContent(std::string const& pfile)
+{
+  cmsys::ifstream fin(pfile.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return;
+  }
+  // A line with a modification time and a directory is followed by a
+  // line for each entry starting in a slash, which is the one character
+  // entry names cannot contain.
+  std::string line;
+  DirectoryContent* dc = nullptr;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    if (line[0] == '/') {
+      if (dc) {
+        dc->All.insert(line.substr(1));
+#if defined(_WIN32) || defined(__APPLE__)
+        dc->Folded.insert(cmSystemTools::LowerCase(line.substr(1)));
+#endif
+      }
+      continue;
+    }
+    char* end;
+    long const mt = strtol(line.c_str(), &end, 10);
+    if (*end != ' ') {
+      dc = nullptr;
+      continue;
+    }
+    dc = &this->DirectoryContentMap[end + 1];
+    dc->LastDiskTime = mt;
+    dc->Complete = true;
+    dc->Unused = true;
+  }
+}
+
+void cmGlobalGenerator::WriteDirectoryContent(std::string const& pfile)
+{
+  cmGeneratedFileStream fout(pfile);
+  fout.SetCopyIfDifferent(true);
+  fout << "# Directory listings of the find commands.\n";
+  for (auto const& dci : this->DirectoryContentMap) {
+    DirectoryContent const& dc = dci.second;
+    auto hasNewline = [](std::string const& f) {
+      return f.find('\n') != std::string::npos;
+    };
+    if (dc.LastDiskTime == -1 || !dc.Complete || dc.Unused ||
+        !dc.Generated.empty() ||
+        hasNewline(dci.first) ||
+        std::any_of(dc.All.begin(), dc.All.end(), hasNewline)) {
+      continue;
+    }
+    fout << dc.LastDiskTime << " " << dci.first << "\n";
+    for (std::string const& f : dc.All) {
+      fout << "/" << f << "\n";
+    }
+  }
+}
+
+cmGlobalGenerator::FindPackageConfigSearch const*
+cmGlobalGenerator::GetFindPackageConfigSearch(std::string const& key)
+{
+  auto i = this->FindPackageConfigSearches.find(key);
+  if (i == this->FindPackageConfigSearches.end()) {
+    return nullptr;
+  }
+  for (auto const& d : i->second.Directories) {
+    if (cmSystemTools::ModifiedTime(d.first) != d.second) {
+      this->FindPackageConfigSearches.erase(i);
+      this->FindPackageConfigSearchesChanged = true;
+      return nullptr;
+    }
+  }
+  return &i->second;
+}
+
+void cmGlobalGenerator::AddFindPackageConfigSearch(
+  std::string const& key, FindPackageConfigSearch search)
+{
+  this->FindPackageConfigSearches[key] = std::move(search);
+  this->FindPackageConfigSearchesChanged = true;
+}
+
+std::string cmGlobalGenerator::GetFindPackageCacheFile() const
+{
+  // A file outside the build tree may be shared by many of them.
+  std::string pfile;
+  if (std::string const* f =
+        this->CMakeInstance->GetState()->GetInitializedCacheValue(
+          "CMAKE_FIND_PACKAGE_CACHE_FILE")) {
+    pfile = *f;
+  }
+  if (pfile.empty()) {
+    cmSystemTools::GetEnv("CMAKE_FIND_PACKAGE_CACHE_FILE", pfile);
+  }
+  if (pfile.empty()) {
+    pfile = this->CMakeInstance->GetHomeOutputDirectory() +
+      cmake::GetCMakeFilesDirectory() + "/CMakeFindPackageCache.txt";
+  }
+  return cmSystemTools::CollapseFullPath(
+    pfile, this->CMakeInstance->GetHomeOutputDirectory());
+}
+
+void cmGlobalGenerator::LoadFindPackageConfigSearches(
+  std::string const& pfile)
+{
+  this->FindPackageConfigSearchesChanged = false;
+  cmsys::ifstream fin(pfile.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return;
+  }
+  // A line with a key and whether a configuration file was found is
+  // followed by a line for each directory with its modification time
+  // and a line for each candidate file.
+  std::string line;
+  FindPackageConfigSearch* search = nullptr;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    if (cmHasLiteralPrefix(line, "key ") && line.size() > 6 &&
+        line[line.size() - 2] == ' ') {
+      search = &this->FindPackageConfigSearches[line.substr(
+        4, line.size() - 6)];
+      *search = FindPackageConfigSearch();
+      search->Found = line[line.size() - 1] == '1';
+    } else if (search && cmHasLiteralPrefix(line, "dir ")) {
+      char* end;
+      long const mt = strtol(line.c_str() + 4, &end, 10);
+      if (*end == ' ') {
+        search->Directories.emplace_back(end + 1, mt);
+      }
+    } else if (search && cmHasLiteralPrefix(line, "config ")) {
+      search->Candidates.push_back(line.substr(7));
+    }
+  }
+}
+
+void cmGlobalGenerator::WriteFindPackageConfigSearches(
+  std::string const& pfile)
+{
+  // The file may be shared and prepared in advance in a location that
+  // cannot be written.  Leave it alone if no search changed, and skip
+  // it quietly if it cannot be written.
+  if (!this->FindPackageConfigSearchesChanged) {
+    return;
+  }
+  cmGeneratedFileStream fout(pfile, true);
+  if (!fout) {
+    return;
+  }
+  fout.SetCopyIfDifferent(true);
+  fout << "# Search results of find_package for configuration files.\n";
+  for (auto const& fi : this->FindPackageConfigSearches) {
+    FindPackageConfigSearch const& search = fi.second;
+    // Drop results that are out of date.
+    bool valid = fi.first.find_first_of(" \n") == std::string::npos;
+    for (auto const& d : search.Directories) {
+      if (!valid) {
+        break;
+      }
+      valid = d.first.find('\n') == std::string::npos &&
+        cmSystemTools::ModifiedTime(d.first) == d.second;
+    }
+    for (std::string const& c : search.Candidates) {
+      valid = valid && c.find('\n') == std::string::npos;
+    }
+    if (!valid) {
+      continue;
+    }
+    fout << "key " << fi.first << " " << (search.Found ? "1" : "0") << "\n";
+    for (auto const& d : search.Directories) {
+      fout << "dir " << d.second << " " << d.first << "\n";
+    }
+    for (std::string const& c : search.Candidates) {
+      fout << "config " << c << "\n";
+    }
+  }
+}
+
 void cmGlobalGenerator::AddRuleHash(const std::vector<std::string>& outputs,
                                     std::string const& content)
 {
@@ -3089,6 +3364,14 @@ cmGlobalGenerator::GetFilenameTargetDepends(cmSourceFile* sf) const
   return this->FilenameTargetDepends[sf];
 }
 
+cmComputeLinkDependsCache& cmGlobalGenerator::GetLinkDependsCache() const
+{
+  if (!this->LinkDependsCache) {
+    this->LinkDependsCache = new cmComputeLinkDependsCache;
+  }
+  return *this->LinkDependsCache;
+}
+
 void cmGlobalGenerator::CreateEvaluationSourceFiles(
   std::string const& config) const
 {
@@ -28,6 +28,7 @@
 
 #define CMAKE_DIRECTORY_ID_SEP "::@"
 
+class cmComputeLinkDependsCache;
 class cmDirectoryId;
 class cmExportBuildFileGenerator;
 class cmExternalMakefileProjectGenerator;
@@ -151,8 +152,8 @@ public:
    */
   int TryCompile(int jobs, const std::string& srcdir,
                  const std::string& bindir, const std::string& projectName,
-                 const std::string& targetName, bool fast, std::string& output,
-                 cmMakefile* mf);
+                 const std::string& targetName, bool fast, bool keepGoing,
+                 std::string& output, cmMakefile* mf);
 
   /**
    * Build a file given the following information. This is a more direct call
@@ -185,6 +186,13 @@ public:
 
   virtual void PrintBuildCommandAdvice(std::ostream& os, int jobs) const;
 
+  /** Get the native build tool options that make it build the remaining
+      targets after one of them fails, or none if it cannot.  */
+  virtual std::vector<std::string> GetKeepGoingBuildOptions() const
+  {
+    return std::vector<std::string>();
+  }
+
   /** Generate a "cmake --build" call for a given target and config.  */
   std::string GenerateCMakeBuildCommand(const std::string& target,
                                         const std::string& config,
@@ -304,6 +312,34 @@ public:
   std::set<std::string> const& GetDirectoryContent(std::string const& dir,
                                                    bool needDisk = true);
 
+  /** Check whether a directory may have an entry of the given name,
+      possibly below a subdirectory, according to its cached listing.
+      Only a false answer is certain, so the find commands use it to
+      skip checking files that cannot exist.  */
+  bool DirectoryMayContain(std::string const& dir, std::string const& name);
+
+  /** Result of a search of the find_package prefixes for package
+      configuration files: the files found in the order they were
+      considered, whether the last one was accepted, and the directories
+      looked into with their modification times.  */
+  struct FindPackageConfigSearch
+  {
+    std::vector<std::string> Candidates;
+    bool Found;
+    std::vector<std::pair<std::string, long>> Directories;
+    FindPackageConfigSearch()
+      : Found(false)
+    {
+    }
+  };
+
+  /** Get the stored result of the search with the given key, or null
+      if there is none or one of its directories changed since.  */
+  FindPackageConfigSearch const* GetFindPackageConfigSearch(
+    std::string const& key);
+  void AddFindPackageConfigSearch(std::string const& key,
+                                  FindPackageConfigSearch search);
+
   void IndexTarget(cmTarget* t);
   void IndexGeneratorTarget(cmGeneratorTarget* gt);
 
@@ -370,6 +406,22 @@ public:
 
   virtual bool IsIPOSupported() const { return false; }
 
+  /** Return whether generated files may be replaced on worker threads
+      while the local generators run.  Generators that check whether
+      Close() replaced a file must return false.  */
+  virtual bool SupportsDeferredFileCommit() const { return false; }
+
+  /** Return whether custom commands may run adjacent "cmake -E" steps
+      in one "cmake -E __run_sequence" process.  */
+  virtual bool SupportsCMakeCommandSequences() const { return false; }
+
+  /** Called from command-line hook to update dependencies of many
+      targets at once.  */
+  virtual bool UpdateDependencies(bool /*verbose*/, bool /*color*/)
+  {
+    return true;
+  }
+
   /** Return whether the generator can import external visual studio project
       using INCLUDE_EXTERNAL_MSPROJECT */
   virtual bool IsIncludeExternalMSProjectSupported() const { return false; }
@@ -415,6 +467,10 @@ public:
   const std::set<const cmGeneratorTarget*>& GetFilenameTargetDepends(
     cmSourceFile* sf) const;
 
+  /** Get the link items and interfaces shared by the link dependency
+      computations of all targets.  */
+  cmComputeLinkDependsCache& GetLinkDependsCache() const;
+
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   cmFileLockPool& GetFileLockPool() { return FileLockPool; }
 #endif
@@ -603,15 +659,39 @@ private:
   struct DirectoryContent
   {
     long LastDiskTime;
+    // Whether All lists every entry on disk.
+    bool Complete;
     std::set<std::string> All;
     std::set<std::string> Generated;
+    // Whether the listing was loaded from the previous configure step
+    // and not used since.
+    bool Unused;
+    // Lower-case names on platforms with case-insensitive file systems.
+    std::set<std::string> Folded;
+    // The stat cache generation in which LastDiskTime was last checked.
+    unsigned long StatGeneration;
     DirectoryContent()
       : LastDiskTime(-1)
+      , Complete(false)
+      , Unused(false)
+      , StatGeneration(0)
     {
     }
   };
   std::map<std::string, DirectoryContent> DirectoryContentMap;
 
+  // Keep the directory listings of the configure step for the next one.
+  void LoadDirectoryContent(std::string const& pfile);
+  void WriteDirectoryContent(std::string const& pfile);
+
+  // Searches of find_package, kept between configure steps in the file
+  // named by CMAKE_FIND_PACKAGE_CACHE_FILE or in the build tree.
+  std::map<std::string, FindPackageConfigSearch> FindPackageConfigSearches;
+  bool FindPackageConfigSearchesChanged;
+  std::string GetFindPackageCacheFile() const;
+  void LoadFindPackageConfigSearches(std::string const& pfile);
+  void WriteFindPackageConfigSearches(std::string const& pfile);
+
   // Set of binary directories on disk.
   std::set<std::string> BinaryDirectories;
 
@@ -623,6 +703,8 @@ private:
   mutable std::map<cmSourceFile*, std::set<cmGeneratorTarget const*>>
     FilenameTargetDepends;
 
+  mutable cmComputeLinkDependsCache* LinkDependsCache;
+
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   // Pool of file locks
   cmFileLockPool FileLockPool;
@@ -50,6 +50,11 @@ protected:
                             std::vector<std::string> const& makeOptions =
                               std::vector<std::string>()) override;
 
+  std::vector<std::string> GetKeepGoingBuildOptions() const override
+  {
+    return { "/K" };
+  }
+
 private:
   void PrintCompilerAdvice(std::ostream& os, std::string const& lang,
                            const char* envVar) const override;
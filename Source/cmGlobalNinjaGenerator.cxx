@@ -14,6 +14,7 @@
 #include <stdio.h>
 
 #include "cmAlgorithms.h"
+#include "cmCryptoHash.h"
 #include "cmDocumentationEntry.h"
 #include "cmFortranParser.h"
 #include "cmGeneratedFileStream.h"
@@ -38,6 +39,8 @@ class cmLinkLineComputer;
 
 const char* cmGlobalNinjaGenerator::NINJA_BUILD_FILE = "build.ninja";
 const char* cmGlobalNinjaGenerator::NINJA_RULES_FILE = "rules.ninja";
+const char* cmGlobalNinjaGenerator::NINJA_DIRECTORY_BUILD_FILE =
+  "directory.ninja";
 const char* cmGlobalNinjaGenerator::INDENT = "  ";
 #ifdef _WIN32
 std::string const cmGlobalNinjaGenerator::SHELL_NOOP = "cd .";
@@ -274,9 +277,9 @@ void cmGlobalNinjaGenerator::WriteCustomCommandBuild(
   if (!depfile.empty()) {
     vars["depfile"] = depfile;
   }
-  this->WriteBuild(*this->BuildFileStream, comment, "CUSTOM_COMMAND", outputs,
-                   /*implicitOuts=*/cmNinjaDeps(), deps, cmNinjaDeps(),
-                   orderOnly, vars);
+  this->WriteBuild(*this->GetBuildFileStream(), comment, "CUSTOM_COMMAND",
+                   outputs, /*implicitOuts=*/cmNinjaDeps(), deps,
+                   cmNinjaDeps(), orderOnly, vars);
 
   if (this->ComputingUnknownDependencies) {
     // we need to track every dependency that comes in, since we are trying
@@ -317,9 +320,9 @@ void cmGlobalNinjaGenerator::WriteMacOSXContentBuild(const std::string& input,
   deps.push_back(input);
   cmNinjaVars vars;
 
-  this->WriteBuild(*this->BuildFileStream, "", "COPY_OSX_CONTENT", outputs,
-                   /*implicitOuts=*/cmNinjaDeps(), deps, cmNinjaDeps(),
-                   cmNinjaDeps(), cmNinjaVars());
+  this->WriteBuild(*this->GetBuildFileStream(), "", "COPY_OSX_CONTENT",
+                   outputs, /*implicitOuts=*/cmNinjaDeps(), deps,
+                   cmNinjaDeps(), cmNinjaDeps(), cmNinjaVars());
 }
 
 void cmGlobalNinjaGenerator::WriteRule(
@@ -444,6 +447,8 @@ void cmGlobalNinjaGenerator::WriteDefault(std::ostream& os,
 cmGlobalNinjaGenerator::cmGlobalNinjaGenerator(cmake* cm)
   : cmGlobalCommonGenerator(cm)
   , BuildFileStream(nullptr)
+  , DirectoryBuildFileStream(nullptr)
+  , DirectoryBuildFiles(false)
   , RulesFileStream(nullptr)
   , CompileCommandsStream(nullptr)
   , Rules()
@@ -506,6 +511,8 @@ void cmGlobalNinjaGenerator::Generate()
     this->GetCMakeInstance()->IssueMessage(cmake::FATAL_ERROR, msg.str());
     return;
   }
+  this->DirectoryBuildFiles =
+    this->GlobalSettingIsOn("CMAKE_NINJA_DIRECTORY_BUILD_FILES");
   this->OpenBuildFileStream();
   this->OpenRulesFileStream();
 
@@ -752,6 +759,14 @@ void cmGlobalNinjaGenerator::ComputeTargetObjectDirectory(
 
 // Private methods
 
+// Compute a hash of the content written to a stream so far.
+static std::string cmNinjaStreamContentHash(cmGeneratedFileStream& os)
+{
+  os.flush();
+  cmCryptoHash md5(cmCryptoHash::AlgoMD5);
+  return md5.HashFile(os.GetTempName());
+}
+
 void cmGlobalNinjaGenerator::OpenBuildFileStream()
 {
   // Compute Ninja's build file path.
@@ -770,6 +785,7 @@ void cmGlobalNinjaGenerator::OpenBuildFileStream()
       return;
     }
   }
+  this->BuildFileStream->SetCopyIfDifferent(this->KeepUnchangedManifest());
 
   // Write the do not edit header.
   this->WriteDisclaimer(*this->BuildFileStream);
@@ -790,6 +806,61 @@ void cmGlobalNinjaGenerator::CloseBuildFileStream()
   }
 }
 
+void cmGlobalNinjaGenerator::OpenDirectoryBuildFileStream(
+  cmLocalGenerator* lg)
+{
+  if (!this->DirectoryBuildFiles || this->DirectoryBuildFileStream) {
+    return;
+  }
+
+  std::string dir = lg->GetCurrentBinaryDirectory();
+  dir += cmake::GetCMakeFilesDirectory();
+  cmSystemTools::MakeDirectory(dir);
+  this->DirectoryBuildFilePath =
+    dir + "/" + cmGlobalNinjaGenerator::NINJA_DIRECTORY_BUILD_FILE;
+
+  // Replace the file only if its content changes so that directories
+  // that did not change keep their files untouched.
+  this->DirectoryBuildFileStream = new cmGeneratedFileStream(
+    this->DirectoryBuildFilePath, false, this->GetMakefileEncoding());
+  this->DirectoryBuildFileStream->SetCopyIfDifferent(true);
+
+  // Write the do not edit header.
+  this->WriteDisclaimer(*this->DirectoryBuildFileStream);
+
+  // Write a comment about this file.
+  *this->DirectoryBuildFileStream
+    << "# This file contains the build statements of one directory.\n"
+    << "# It is included by the main '" << NINJA_BUILD_FILE << "'.\n\n";
+}
+
+void cmGlobalNinjaGenerator::CloseDirectoryBuildFileStream()
+{
+  if (this->DirectoryBuildFileStream) {
+    if (cmSystemTools::GetErrorOccuredFlag()) {
+      this->DirectoryBuildFileStream->setstate(std::ios::failbit);
+    } else {
+      // Reference the file from the main build file.  Ninja gives it a
+      // scope of its own that sees the rules and variables defined so
+      // far.  Its content hash makes build.ninja change with it.
+      *this->BuildFileStream
+        << "# Content hash: "
+        << cmNinjaStreamContentHash(*this->DirectoryBuildFileStream) << "\n"
+        << "subninja "
+        << this->EncodePath(
+             this->ConvertToNinjaPath(this->DirectoryBuildFilePath))
+        << "\n";
+    }
+    delete this->DirectoryBuildFileStream;
+    this->DirectoryBuildFileStream = nullptr;
+  }
+}
+
+bool cmGlobalNinjaGenerator::KeepUnchangedManifest() const
+{
+  return this->DirectoryBuildFiles && this->SupportsManifestRestat();
+}
+
 void cmGlobalNinjaGenerator::OpenRulesFileStream()
 {
   // Compute Ninja's build file path.
@@ -808,6 +879,7 @@ void cmGlobalNinjaGenerator::OpenRulesFileStream()
       return;
     }
   }
+  this->RulesFileStream->SetCopyIfDifferent(this->KeepUnchangedManifest());
 
   // Write the do not edit header.
   this->WriteDisclaimer(*this->RulesFileStream);
@@ -825,6 +897,12 @@ void cmGlobalNinjaGenerator::OpenRulesFileStream()
 void cmGlobalNinjaGenerator::CloseRulesFileStream()
 {
   if (this->RulesFileStream) {
+    if (this->DirectoryBuildFiles && this->BuildFileStream) {
+      // Make build.ninja change whenever the rules it includes change.
+      *this->BuildFileStream
+        << "# Content hash of " << NINJA_RULES_FILE << ": "
+        << cmNinjaStreamContentHash(*this->RulesFileStream) << "\n";
+    }
     delete this->RulesFileStream;
     this->RulesFileStream = nullptr;
   } else {
@@ -1433,6 +1511,11 @@ void cmGlobalNinjaGenerator::WriteTargetRebuildManifest(std::ostream& os)
   implicitDeps.erase(std::unique(implicitDeps.begin(), implicitDeps.end()),
                      implicitDeps.end());
 
+  // If regeneration leaves build.ninja unchanged Ninja need not reload it.
+  if (this->KeepUnchangedManifest()) {
+    variables["restat"] = "1";
+  }
+
   std::string const ninjaBuildFile = this->NinjaOutputPath(NINJA_BUILD_FILE);
   this->WriteBuild(os, "Re-run CMake if any of its inputs changed.",
                    "RERUN_CMAKE",
@@ -1620,6 +1703,62 @@ Compilation of source files within a target is split into the following steps:
    (because the latter consumes the module).
 */
 
+static void cmNinjaFortranWriteDepfile(std::string const& arg_dep,
+                                       std::string const& arg_pp,
+                                       std::set<std::string> const& includes)
+{
+  cmGeneratedFileStream depfile(arg_dep);
+  depfile << cmSystemTools::ConvertToUnixOutputPath(arg_pp) << ":";
+  for (std::string const& include : includes) {
+    depfile << " \\\n " << cmSystemTools::ConvertToUnixOutputPath(include);
+  }
+  depfile << "\n";
+}
+
+// Check whether the .ddi file left by a previous scan was produced from
+// the same content.  Its "includes" map stores the hash of every file
+// the source included, which must still match.  Its "missing-includes"
+// list names the paths checked before them, which must still not exist.
+static bool cmNinjaFortranCachedScan(std::string const& arg_ddi,
+                                     std::string const& scanHash,
+                                     cmCryptoHash& hasher,
+                                     std::set<std::string>& includes)
+{
+  cmsys::ifstream ddif(arg_ddi.c_str(), std::ios::in | std::ios::binary);
+  if (!ddif) {
+    return false;
+  }
+  Json::Value ddio;
+  Json::Value const& ddi = ddio;
+  Json::Reader reader;
+  if (!reader.parse(ddif, ddio, false) || !ddi.isObject() ||
+      ddi["scan-hash"].asString() != scanHash) {
+    return false;
+  }
+  Json::Value const& ddi_includes = ddi["includes"];
+  if (!ddi_includes.isObject()) {
+    return false;
+  }
+  for (Json::Value::const_iterator i = ddi_includes.begin();
+       i != ddi_includes.end(); ++i) {
+    std::string const include = i.key().asString();
+    if (hasher.HashFile(include) != i->asString()) {
+      return false;
+    }
+    includes.insert(include);
+  }
+  Json::Value const& ddi_missing = ddi["missing-includes"];
+  if (!ddi_missing.isArray()) {
+    return false;
+  }
+  for (Json::Value const& missing : ddi_missing) {
+    if (cmSystemTools::FileExists(missing.asString(), true)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 int cmcmd_cmake_ninja_depends(std::vector<std::string>::const_iterator argBeg,
                               std::vector<std::string>::const_iterator argEnd)
 {
@@ -1690,7 +1829,28 @@ int cmcmd_cmake_ninja_depends(std::vector<std::string>::const_iterator argBeg,
     }
   }
 
+  // Key the scan results on the content of the preprocessed source, the
+  // include path used to find the files it includes, and the object.
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  std::string scanHash = hasher.HashFile(arg_pp);
+  if (scanHash.empty()) {
+    cmSystemTools::Error("-E cmake_ninja_depends failed to open ",
+                         arg_pp.c_str());
+    return 1;
+  }
+  for (std::string const& include : includes) {
+    scanHash += "\n" + include;
+  }
+  scanHash = hasher.HashString(scanHash + "\n" + arg_obj);
+
   cmFortranSourceInfo info;
+  if (cmNinjaFortranCachedScan(arg_ddi, scanHash, hasher, info.Includes)) {
+    // Leave the .ddi file untouched so that the restat binding of the
+    // preprocessing rule does not re-run the dyndep collation.
+    cmNinjaFortranWriteDepfile(arg_dep, arg_pp, info.Includes);
+    return 0;
+  }
+
   std::set<std::string> defines;
   cmFortranParser parser(includes, defines, info);
   if (!cmFortranParser_FilePush(&parser, arg_pp.c_str())) {
@@ -1703,17 +1863,19 @@ int cmcmd_cmake_ninja_depends(std::vector<std::string>::const_iterator argBeg,
     return 1;
   }
 
-  {
-    cmGeneratedFileStream depfile(arg_dep);
-    depfile << cmSystemTools::ConvertToUnixOutputPath(arg_pp) << ":";
-    for (std::string const& include : info.Includes) {
-      depfile << " \\\n " << cmSystemTools::ConvertToUnixOutputPath(include);
-    }
-    depfile << "\n";
-  }
+  cmNinjaFortranWriteDepfile(arg_dep, arg_pp, info.Includes);
 
   Json::Value ddi(Json::objectValue);
   ddi["object"] = arg_obj;
+  ddi["scan-hash"] = scanHash;
+  Json::Value& ddi_includes = ddi["includes"] = Json::objectValue;
+  for (std::string const& include : info.Includes) {
+    ddi_includes[include] = hasher.HashFile(include);
+  }
+  Json::Value& ddi_missing = ddi["missing-includes"] = Json::arrayValue;
+  for (std::string const& missing : info.MissingIncludes) {
+    ddi_missing.append(missing);
+  }
 
   Json::Value& ddi_provides = ddi["provides"] = Json::arrayValue;
   for (std::string const& provide : info.Provides) {
@@ -60,6 +60,11 @@ public:
   /// It is included in the main build.ninja file.
   static const char* NINJA_RULES_FILE;
 
+  /// The name of the file holding the build statements of one directory
+  /// when they are split out of the main build.ninja file.  It is placed
+  /// in the CMakeFiles directory of the directory's build tree.
+  static const char* NINJA_DIRECTORY_BUILD_FILE;
+
   /// The indentation string used when generating Ninja's build file.
   static const char* INDENT;
 
@@ -100,6 +105,9 @@ public:
 
   bool IsIPOSupported() const override { return true; }
 
+  bool SupportsDeferredFileCommit() const override { return true; }
+  bool SupportsCMakeCommandSequences() const override { return true; }
+
   /**
    * Write a build statement to @a os with the @a comment using
    * the @a rule the list of @a outputs files and inputs.
@@ -212,6 +220,11 @@ public:
                             std::vector<std::string> const& makeOptions =
                               std::vector<std::string>()) override;
 
+  std::vector<std::string> GetKeepGoingBuildOptions() const override
+  {
+    return { "-k", "0" };
+  }
+
   // Setup target names
   const char* GetAllTargetName() const override { return "all"; }
   const char* GetInstallTargetName() const override { return "install"; }
@@ -236,11 +249,21 @@ public:
   }
   const char* GetCleanTargetName() const override { return "clean"; }
 
+  /// The stream receiving build statements: the build file of the
+  /// directory being generated if one is open, or else build.ninja.
   cmGeneratedFileStream* GetBuildFileStream() const
   {
-    return this->BuildFileStream;
+    return this->DirectoryBuildFileStream ? this->DirectoryBuildFileStream
+                                          : this->BuildFileStream;
   }
 
+  /// Write the build statements of the given directory to its own file
+  /// referenced from build.ninja by a subninja statement, if the
+  /// CMAKE_NINJA_DIRECTORY_BUILD_FILES variable is enabled.
+  void OpenDirectoryBuildFileStream(cmLocalGenerator* lg);
+  void CloseDirectoryBuildFileStream();
+  bool HasDirectoryBuildFiles() const { return this->DirectoryBuildFiles; }
+
   cmGeneratedFileStream* GetRulesFileStream() const
   {
     return this->RulesFileStream;
@@ -385,6 +408,11 @@ private:
   void OpenRulesFileStream();
   void CloseRulesFileStream();
 
+  /// Whether build.ninja and rules.ninja are replaced only when their
+  /// content changes.  Ninja then reloads them only if regeneration
+  /// changed something.
+  bool KeepUnchangedManifest() const;
+
   /// Write the common disclaimer text at the top of each build file.
   void WriteDisclaimer(std::ostream& os);
 
@@ -409,6 +437,11 @@ private:
   /// The file containing the build statement. (the relationship of the
   /// compilation DAG).
   cmGeneratedFileStream* BuildFileStream;
+  /// The file containing the build statements of the directory currently
+  /// being generated, if they are written separately.
+  cmGeneratedFileStream* DirectoryBuildFileStream;
+  std::string DirectoryBuildFilePath;
+  bool DirectoryBuildFiles;
   /// The file containing the rule statements. (The action attached to each
   /// edge of the compilation DAG).
   cmGeneratedFileStream* RulesFileStream;
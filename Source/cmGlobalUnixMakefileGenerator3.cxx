@@ -4,9 +4,17 @@
 
 #include <algorithm>
 #include <functional>
+#include <memory> // IWYU pragma: keep
 #include <sstream>
 #include <utility>
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#  include <atomic>
+#  include <thread>
+#endif
+
+#include "cmAlgorithms.h"
+#include "cmDependsC.h"
 #include "cmDocumentationEntry.h"
 #include "cmGeneratedFileStream.h"
 #include "cmGeneratorTarget.h"
@@ -16,8 +24,10 @@
 #include "cmMakefile.h"
 #include "cmMakefileTargetGenerator.h"
 #include "cmOutputConverter.h"
+#include "cmSourceFile.h"
 #include "cmState.h"
 #include "cmStateDirectory.h"
+#include "cmStateSnapshot.h"
 #include "cmStateTypes.h"
 #include "cmSystemTools.h"
 #include "cmTargetDepend.h"
@@ -37,6 +47,8 @@ cmGlobalUnixMakefileGenerator3::cmGlobalUnixMakefileGenerator3(cmake* cm)
   this->UseLinkScript = true;
 #endif
   this->CommandDatabase = nullptr;
+  this->BatchDependScan = false;
+  this->CompilerDepends = false;
 
   this->IncludeDirective = "include";
   this->DefineWindowsNULL = false;
@@ -122,6 +134,15 @@ void cmGlobalUnixMakefileGenerator3::Configure()
 
 void cmGlobalUnixMakefileGenerator3::Generate()
 {
+  // The batch is scanned by the cmake_check_build_system rule.
+  this->BatchDependScan =
+    this->GlobalSettingIsOn("CMAKE_DEPENDS_BATCH_SCAN") &&
+    !this->GlobalSettingIsOn("CMAKE_SUPPRESS_REGENERATION");
+  this->BatchDependScanTargets.clear();
+  this->TargetMayGenerateFilesMap.clear();
+  this->CompilerDepends =
+    this->GlobalSettingIsOn("CMAKE_DEPENDS_USE_COMPILER");
+
   // first do superclass method
   this->cmGlobalGenerator::Generate();
 
@@ -403,6 +424,212 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefileLanguageRules(
     }
   }
   cmakefileStream << "  )\n";
+
+  if (this->BatchDependScan) {
+    cmakefileStream
+      << "\n# Dependency information for targets scanned in one batch:\n";
+    cmakefileStream << "set(CMAKE_DEPEND_INFO_FILES_BATCH\n";
+    for (cmLocalGenerator* lGenerator : lGenerators) {
+      lg = static_cast<cmLocalUnixMakefileGenerator3*>(lGenerator);
+      for (cmGeneratorTarget* tgt : lg->GetGeneratorTargets()) {
+        if (this->BatchDependScanTargets.count(tgt)) {
+          std::string tname = lg->GetRelativeTargetDirectory(tgt);
+          tname += "/DependInfo.cmake";
+          cmSystemTools::ConvertToUnixSlashes(tname);
+          cmakefileStream << "  \"" << tname << "\"\n";
+        }
+      }
+    }
+    cmakefileStream << "  )\n";
+  }
+}
+
+bool cmGlobalUnixMakefileGenerator3::AddBatchDependScanTarget(
+  cmGeneratorTarget const* target)
+{
+  if (!this->BatchDependScan) {
+    return false;
+  }
+
+  // Only the C-like scanners are independent of the scans of other
+  // targets.
+  cmLocalUnixMakefileGenerator3* lg =
+    static_cast<cmLocalUnixMakefileGenerator3*>(target->GetLocalGenerator());
+  for (auto const& l : lg->GetImplicitDepends(target)) {
+    std::string const& lang = l.first;
+    if (lang != "C" && lang != "CXX" && lang != "RC" && lang != "ASM" &&
+        lang != "CUDA") {
+      return false;
+    }
+  }
+
+  // A batch runs before the build, so it would not see the files
+  // generated by the target or by the targets it depends on.
+  if (this->TargetMayGenerateFiles(target)) {
+    return false;
+  }
+
+  this->BatchDependScanTargets.insert(target);
+  return true;
+}
+
+bool cmGlobalUnixMakefileGenerator3::TargetMayGenerateFiles(
+  cmGeneratorTarget const* target)
+{
+  auto i = this->TargetMayGenerateFilesMap.find(target);
+  if (i != this->TargetMayGenerateFilesMap.end()) {
+    return i->second;
+  }
+  // Assume the worst while a dependency cycle is visited.
+  this->TargetMayGenerateFilesMap[target] = true;
+
+  bool generates = false;
+  switch (target->GetType()) {
+    case cmStateEnums::EXECUTABLE:
+    case cmStateEnums::STATIC_LIBRARY:
+    case cmStateEnums::SHARED_LIBRARY:
+    case cmStateEnums::MODULE_LIBRARY:
+    case cmStateEnums::OBJECT_LIBRARY: {
+      std::vector<cmSourceFile const*> customCommands;
+      target->GetCustomCommands(
+        customCommands,
+        target->GetLocalGenerator()->GetMakefile()->GetSafeDefinition(
+          "CMAKE_BUILD_TYPE"));
+      generates = !customCommands.empty() ||
+        !target->GetPreBuildCommands().empty() ||
+        !target->GetPreLinkCommands().empty() ||
+        !target->GetPostBuildCommands().empty();
+    } break;
+    case cmStateEnums::INTERFACE_LIBRARY:
+      break;
+    default:
+      generates = true;
+      break;
+  }
+  if (!generates) {
+    for (cmTargetDepend const& dep : this->GetTargetDirectDepends(target)) {
+      if (this->TargetMayGenerateFiles(dep)) {
+        generates = true;
+        break;
+      }
+    }
+  }
+
+  this->TargetMayGenerateFilesMap[target] = generates;
+  return generates;
+}
+
+namespace {
+struct cmBatchDependScanTarget
+{
+  std::unique_ptr<cmMakefile> Makefile;
+  std::unique_ptr<cmLocalUnixMakefileGenerator3> LocalGenerator;
+  cmLocalUnixMakefileGenerator3::DependScan Scan;
+};
+}
+
+bool cmGlobalUnixMakefileGenerator3::UpdateDependencies(bool verbose,
+                                                        bool color)
+{
+  cmake* cm = this->GetCMakeInstance();
+  std::string const homeOutDir = cm->GetHomeOutputDirectory();
+  cmStateSnapshot const base = cm->GetCurrentSnapshot();
+
+  // Every target is loaded into a directory scope of its own.
+  auto createMakefile = [this, cm, &base](std::string const& dir) {
+    cmStateSnapshot snapshot =
+      cm->GetState()->CreateBuildsystemDirectorySnapshot(base);
+    snapshot.GetDirectory().SetCurrentBinary(dir);
+    snapshot.GetDirectory().SetCurrentSource(dir);
+    return cm::make_unique<cmMakefile>(this, snapshot);
+  };
+
+  // Read the list of targets scanned in a batch.
+  std::vector<std::string> infoFiles;
+  {
+    std::unique_ptr<cmMakefile> mf = createMakefile(homeOutDir);
+    std::string makefileCMake = homeOutDir;
+    makefileCMake += cmake::GetCMakeFilesDirectory();
+    makefileCMake += "/Makefile.cmake";
+    if (!mf->ReadListFile(makefileCMake.c_str()) ||
+        cmSystemTools::GetErrorOccuredFlag()) {
+      cmSystemTools::Error("Makefile.cmake file not found");
+      return false;
+    }
+    cmSystemTools::ExpandListArgument(
+      mf->GetSafeDefinition("CMAKE_DEPEND_INFO_FILES_BATCH"), infoFiles);
+  }
+
+  // Check all targets and create the scanners of the out of date ones
+  // on this thread.  They share one in-memory include cache.
+  bool result = true;
+  cmDependsC::SharedCacheSet sharedCaches;
+  std::vector<std::unique_ptr<cmBatchDependScanTarget>> targets;
+  for (std::string const& info : infoFiles) {
+    // The file is <dir>/CMakeFiles/<target>.dir/DependInfo.cmake.
+    std::string const infoFile =
+      cmSystemTools::CollapseFullPath(info, homeOutDir);
+    std::string const targetDir = cmSystemTools::GetFilenamePath(infoFile);
+    std::string const dir = cmSystemTools::GetFilenamePath(
+      cmSystemTools::GetFilenamePath(targetDir));
+
+    std::unique_ptr<cmBatchDependScanTarget> t =
+      cm::make_unique<cmBatchDependScanTarget>();
+    t->Makefile = createMakefile(dir);
+    t->LocalGenerator.reset(static_cast<cmLocalUnixMakefileGenerator3*>(
+      this->CreateLocalGenerator(t->Makefile.get())));
+    if (t->LocalGenerator->CheckDependencies(infoFile.c_str(), verbose,
+                                             t->Scan.ValidDeps)) {
+      continue;
+    }
+    cmLocalUnixMakefileGenerator3::EchoDependScan(targetDir, color);
+    t->Scan.TargetDirectory = targetDir;
+    if (!t->LocalGenerator->PrepareDependScan(t->Scan, &sharedCaches)) {
+      result = false;
+      continue;
+    }
+    targets.push_back(std::move(t));
+  }
+
+  // Run the scanners that allow it on worker threads and the others
+  // on this thread in order.
+  std::vector<cmBatchDependScanTarget*> threaded;
+  std::vector<cmBatchDependScanTarget*> ordered;
+  for (auto const& t : targets) {
+    (t->Scan.ThreadSafe ? threaded : ordered).push_back(t.get());
+  }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  std::atomic<size_t> next(0);
+  std::atomic<bool> threadedResult(true);
+  auto work = [&threaded, &next, &threadedResult]() {
+    for (size_t i = next++; i < threaded.size(); i = next++) {
+      cmBatchDependScanTarget* t = threaded[i];
+      if (!t->LocalGenerator->RunDependScan(t->Scan)) {
+        threadedResult = false;
+      }
+    }
+  };
+  size_t const threads = std::min<size_t>(
+    std::max(std::thread::hardware_concurrency(), 1u), threaded.size());
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  result = threadedResult && result;
+#else
+  ordered.insert(ordered.begin(), threaded.begin(), threaded.end());
+#endif
+  for (cmBatchDependScanTarget* t : ordered) {
+    if (!t->LocalGenerator->RunDependScan(t->Scan)) {
+      result = false;
+    }
+  }
+
+  return result;
 }
 
 void cmGlobalUnixMakefileGenerator3::WriteDirectoryRule2(
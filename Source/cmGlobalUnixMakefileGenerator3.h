@@ -107,6 +107,22 @@ public:
    */
   void Generate() override;
 
+  /** Called from command-line hook to bring dependencies up to date
+      for all targets scanned in one batch.  */
+  bool UpdateDependencies(bool verbose, bool color) override;
+
+  /** Return whether the dependencies of a target are scanned in one
+      batch with those of other targets before the build starts.  If
+      so, the target is added to the batch.  */
+  bool AddBatchDependScanTarget(cmGeneratorTarget const* target);
+
+  /** Return whether batch dependency scanning is enabled.  */
+  bool GetBatchDependScan() const { return this->BatchDependScan; }
+
+  /** Return whether compile rules should write dependency files that
+      are used instead of scanning the sources.  */
+  bool GetCompilerDepends() const { return this->CompilerDepends; }
+
   void WriteMainCMakefileLanguageRules(cmGeneratedFileStream& cmakefileStream,
                                        std::vector<cmLocalGenerator*>&);
 
@@ -137,6 +153,11 @@ public:
                             std::vector<std::string> const& makeOptions =
                               std::vector<std::string>()) override;
 
+  std::vector<std::string> GetKeepGoingBuildOptions() const override
+  {
+    return { "-k" };
+  }
+
   /** Record per-target progress information.  */
   void RecordTargetProgress(cmMakefileTargetGenerator* tg);
 
@@ -152,6 +173,9 @@ public:
 
   bool IsIPOSupported() const override { return true; }
 
+  bool SupportsDeferredFileCommit() const override { return true; }
+  bool SupportsCMakeCommandSequences() const override { return true; }
+
   void ComputeTargetObjectDirectory(cmGeneratorTarget* gt) const override;
 
   std::string IncludeDirective;
@@ -238,6 +262,14 @@ protected:
 
   cmGeneratedFileStream* CommandDatabase;
 
+  // Batch dependency scanning state.
+  bool BatchDependScan;
+  std::set<cmGeneratorTarget const*> BatchDependScanTargets;
+  std::map<cmGeneratorTarget const*, bool> TargetMayGenerateFilesMap;
+  bool TargetMayGenerateFiles(cmGeneratorTarget const* target);
+
+  bool CompilerDepends;
+
 private:
   const char* GetBuildIgnoreErrorsFlag() const override { return "-i"; }
   std::string GetEditCacheCommand() const override;
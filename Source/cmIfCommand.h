@@ -47,6 +47,8 @@ public:
    */
   cmCommand* Clone() override { return new cmIfCommand; }
 
+  bool IsReusable() const override { return true; }
+
   /**
    * This overrides the default InvokeInitialPass implementation.
    * It records the arguments before expansion.
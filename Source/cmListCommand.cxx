@@ -92,46 +92,70 @@ bool cmListCommand::GetListString(std::string& listString,
   return true;
 }
 
+std::string cmListCommand::ListView::Get(size_t i) const
+{
+  return cmSystemTools::GetListElement(*this->Value, (*this->Elements)[i]);
+}
+
+bool cmListCommand::ListView::Equals(size_t i, std::string const& value) const
+{
+  return cmSystemTools::ListElementEquals(*this->Value, (*this->Elements)[i],
+                                          value);
+}
+
 bool cmListCommand::GetList(std::vector<std::string>& list,
                             const std::string& var)
 {
-  std::string listString;
-  if (!this->GetListString(listString, var)) {
+  ListView view;
+  if (!this->GetListView(view, var)) {
+    return false;
+  }
+  list.reserve(list.size() + view.Size());
+  for (size_t i = 0; i < view.Size(); ++i) {
+    list.push_back(view.Get(i));
+  }
+  return true;
+}
+
+bool cmListCommand::GetListView(ListView& list, const std::string& var)
+{
+  // get the old value along with the positions of its elements
+  list.Value = this->Makefile->GetDefList(var, list.Elements, list.Storage);
+  if (!list.Value) {
+    list.Storage.clear();
+    list.Elements = &list.Storage;
     return false;
   }
   // if the size of the list
-  if (listString.empty()) {
+  if (list.Value->empty()) {
+    list.Storage.clear();
+    list.Elements = &list.Storage;
     return true;
   }
-  // expand the variable into a list
-  cmSystemTools::ExpandListArgument(listString, list, true);
   // if no empty elements then just return
-  if (std::find(list.begin(), list.end(), std::string()) == list.end()) {
+  if (std::none_of(list.Elements->begin(), list.Elements->end(),
+                   [](cmListElement const& e) { return e.Length == 0; })) {
     return true;
   }
   // if we have empty elements we need to check policy CMP0007
   switch (this->Makefile->GetPolicyStatus(cmPolicies::CMP0007)) {
-    case cmPolicies::WARN: {
+    case cmPolicies::WARN:
       // Default is to warn and use old behavior
-      // OLD behavior is to allow compatibility, so recall
-      // ExpandListArgument without the true which will remove
-      // empty values
-      list.clear();
-      cmSystemTools::ExpandListArgument(listString, list);
-      std::string warn = cmPolicies::GetPolicyWarning(cmPolicies::CMP0007);
-      warn += " List has value = [";
-      warn += listString;
-      warn += "].";
-      this->Makefile->IssueMessage(cmake::AUTHOR_WARNING, warn);
+      this->Makefile->IssueMessage(
+        cmake::AUTHOR_WARNING,
+        cmPolicies::GetPolicyWarning(cmPolicies::CMP0007) +
+          " List has value = [" + *list.Value + "].");
+      CM_FALLTHROUGH;
+    case cmPolicies::OLD: {
+      // OLD behavior is to allow compatibility, so remove empty values
+      cmListElements nonEmpty;
+      std::copy_if(list.Elements->begin(), list.Elements->end(),
+                   std::back_inserter(nonEmpty),
+                   [](cmListElement const& e) { return e.Length != 0; });
+      list.Storage = std::move(nonEmpty);
+      list.Elements = &list.Storage;
       return true;
     }
-    case cmPolicies::OLD:
-      // OLD behavior is to allow compatibility, so recall
-      // ExpandListArgument without the true which will remove
-      // empty values
-      list.clear();
-      cmSystemTools::ExpandListArgument(listString, list);
-      return true;
     case cmPolicies::NEW:
       return true;
     case cmPolicies::REQUIRED_IF_USED:
@@ -153,12 +177,12 @@ bool cmListCommand::HandleLengthCommand(std::vector<std::string> const& args)
 
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
-  std::vector<std::string> varArgsExpanded;
+  ListView list;
   // do not check the return value here
-  // if the list var is not found varArgsExpanded will have size 0
+  // if the list var is not found the list will have size 0
   // and we will return 0
-  this->GetList(varArgsExpanded, listName);
-  size_t length = varArgsExpanded.size();
+  this->GetListView(list, listName);
+  size_t length = list.Size();
   char buffer[1024];
   sprintf(buffer, "%d", static_cast<int>(length));
 
@@ -175,14 +199,14 @@ bool cmListCommand::HandleGetCommand(std::vector<std::string> const& args)
 
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
-  // expand the variable
-  std::vector<std::string> varArgsExpanded;
-  if (!this->GetList(varArgsExpanded, listName)) {
+  // find the elements of the variable
+  ListView list;
+  if (!this->GetListView(list, listName)) {
     this->Makefile->AddDefinition(variableName, "NOTFOUND");
     return true;
   }
   // FIXME: Add policy to make non-existing lists an error like empty lists.
-  if (varArgsExpanded.empty()) {
+  if (list.Size() == 0) {
     this->SetError("GET given empty list");
     return false;
   }
@@ -190,7 +214,7 @@ bool cmListCommand::HandleGetCommand(std::vector<std::string> const& args)
   std::string value;
   size_t cc;
   const char* sep = "";
-  size_t nitem = varArgsExpanded.size();
+  size_t nitem = list.Size();
   for (cc = 2; cc < args.size() - 1; cc++) {
     int item = atoi(args[cc].c_str());
     value += sep;
@@ -205,7 +229,7 @@ bool cmListCommand::HandleGetCommand(std::vector<std::string> const& args)
       this->SetError(str.str());
       return false;
     }
-    value += varArgsExpanded[item];
+    value += list.Get(item);
   }
 
   this->Makefile->AddDefinition(variableName, value.c_str());
@@ -244,20 +268,20 @@ bool cmListCommand::HandleFindCommand(std::vector<std::string> const& args)
 
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
-  // expand the variable
-  std::vector<std::string> varArgsExpanded;
-  if (!this->GetList(varArgsExpanded, listName)) {
+  // find the elements of the variable
+  ListView list;
+  if (!this->GetListView(list, listName)) {
     this->Makefile->AddDefinition(variableName, "-1");
     return true;
   }
 
-  std::vector<std::string>::iterator it =
-    std::find(varArgsExpanded.begin(), varArgsExpanded.end(), args[2]);
-  if (it != varArgsExpanded.end()) {
-    std::ostringstream indexStream;
-    indexStream << std::distance(varArgsExpanded.begin(), it);
-    this->Makefile->AddDefinition(variableName, indexStream.str().c_str());
-    return true;
+  for (size_t index = 0; index < list.Size(); ++index) {
+    if (list.Equals(index, args[2])) {
+      std::ostringstream indexStream;
+      indexStream << index;
+      this->Makefile->AddDefinition(variableName, indexStream.str().c_str());
+      return true;
+    }
   }
 
   this->Makefile->AddDefinition(variableName, "-1");
@@ -343,23 +367,30 @@ bool cmListCommand::HandleRemoveItemCommand(
   }
 
   const std::string& listName = args[1];
-  // expand the variable
-  std::vector<std::string> varArgsExpanded;
-  if (!this->GetList(varArgsExpanded, listName)) {
+  // find the elements of the variable
+  ListView list;
+  if (!this->GetListView(list, listName)) {
     this->SetError("sub-command REMOVE_ITEM requires list to be present.");
     return false;
   }
 
   std::vector<std::string> remove(args.begin() + 2, args.end());
   std::sort(remove.begin(), remove.end());
-  std::vector<std::string>::const_iterator remEnd =
-    std::unique(remove.begin(), remove.end());
-  std::vector<std::string>::const_iterator remBegin = remove.begin();
+  remove.erase(std::unique(remove.begin(), remove.end()), remove.end());
 
-  std::vector<std::string>::const_iterator argsEnd =
-    cmRemoveMatching(varArgsExpanded, cmMakeRange(remBegin, remEnd));
-  std::vector<std::string>::const_iterator argsBegin = varArgsExpanded.begin();
-  std::string value = cmJoin(cmMakeRange(argsBegin, argsEnd), ";");
+  // Copy the elements to keep straight from the old value.
+  std::string value;
+  std::string element;
+  const char* sep = "";
+  for (size_t i = 0; i < list.Size(); ++i) {
+    element = list.Get(i);
+    if (std::binary_search(remove.begin(), remove.end(), element)) {
+      continue;
+    }
+    value += sep;
+    value += element;
+    sep = ";";
+  }
   this->Makefile->AddDefinition(listName, value.c_str());
   return true;
 }
@@ -1183,9 +1214,9 @@ bool cmListCommand::HandleSublistCommand(std::vector<std::string> const& args)
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
 
-  // expand the variable
-  std::vector<std::string> varArgsExpanded;
-  if (!this->GetList(varArgsExpanded, listName) || varArgsExpanded.empty()) {
+  // find the elements of the variable
+  ListView list;
+  if (!this->GetListView(list, listName) || list.Size() == 0) {
     this->Makefile->AddDefinition(variableName, "");
     return true;
   }
@@ -1193,12 +1224,10 @@ bool cmListCommand::HandleSublistCommand(std::vector<std::string> const& args)
   const int start = atoi(args[2].c_str());
   const int length = atoi(args[3].c_str());
 
-  using size_type = decltype(varArgsExpanded)::size_type;
-
-  if (start < 0 || size_type(start) >= varArgsExpanded.size()) {
+  if (start < 0 || size_t(start) >= list.Size()) {
     std::ostringstream error;
     error << "begin index: " << start << " is out of range 0 - "
-          << varArgsExpanded.size() - 1;
+          << list.Size() - 1;
     this->SetError(error.str());
     return false;
   }
@@ -1209,13 +1238,17 @@ bool cmListCommand::HandleSublistCommand(std::vector<std::string> const& args)
     return false;
   }
 
-  const size_type end =
-    (length == -1 || size_type(start + length) > varArgsExpanded.size())
-    ? varArgsExpanded.size()
-    : size_type(start + length);
-  std::vector<std::string> sublist(varArgsExpanded.begin() + start,
-                                   varArgsExpanded.begin() + end);
-  this->Makefile->AddDefinition(variableName, cmJoin(sublist, ";").c_str());
+  const size_t end = (length == -1 || size_t(start + length) > list.Size())
+    ? list.Size()
+    : size_t(start + length);
+  std::string value;
+  const char* sep = "";
+  for (size_t i = size_t(start); i < end; ++i) {
+    value += sep;
+    value += list.Get(i);
+    sep = ";";
+  }
+  this->Makefile->AddDefinition(variableName, value.c_str());
   return true;
 }
 
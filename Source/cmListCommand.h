@@ -5,10 +5,12 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <stddef.h>
 #include <string>
 #include <vector>
 
 #include "cmCommand.h"
+#include "cmListElement.h"
 
 class cmExecutionStatus;
 
@@ -24,6 +26,8 @@ public:
    */
   cmCommand* Clone() override { return new cmListCommand; }
 
+  bool IsReusable() const override { return true; }
+
   /**
    * This is called when the command is first encountered in
    * the CMakeLists.txt file.
@@ -50,7 +54,22 @@ protected:
                    std::string const& listName,
                    std::vector<std::string>& varArgsExpanded);
 
+  /** The value of a list variable and the positions of its elements.
+      Sub-commands that only read a list use it to avoid allocating a
+      string for every element.  */
+  struct ListView
+  {
+    std::string const* Value = nullptr;
+    cmListElements const* Elements = nullptr;
+    cmListElements Storage;
+
+    size_t Size() const { return this->Elements->size(); }
+    std::string Get(size_t i) const;
+    bool Equals(size_t i, std::string const& value) const;
+  };
+
   bool GetList(std::vector<std::string>& list, const std::string& var);
+  bool GetListView(ListView& list, const std::string& var);
   bool GetListString(std::string& listString, const std::string& var);
 };
 
@@ -0,0 +1,26 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmListElement_h
+#define cmListElement_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <stddef.h>
+#include <vector>
+
+/** \class cmListElement
+ * \brief Position of one element of a ;-separated list in its string.
+ *
+ * An element that contains escaped semicolons must be unescaped by
+ * cmSystemTools::GetListElement before its value is used.
+ */
+struct cmListElement
+{
+  size_t Begin;
+  size_t Length;
+  bool Escaped;
+};
+
+typedef std::vector<cmListElement> cmListElements;
+
+#endif
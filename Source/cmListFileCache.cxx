@@ -2,23 +2,33 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmListFileCache.h"
 
+#include "cmGeneratedFileStream.h"
 #include "cmListFileLexer.h"
 #include "cmMessenger.h"
 #include "cmOutputConverter.h"
 #include "cmState.h"
 #include "cmSystemTools.h"
+#include "cmVersion.h"
 #include "cmake.h"
 
+#include "cmsys/FStream.hxx"
+#include "cmsys/SystemTools.hxx"
+
 #include <algorithm>
 #include <assert.h>
+#include <iterator>
 #include <memory>
 #include <sstream>
+#include <time.h>
+#include <utility>
 
 cmCommandContext::cmCommandName& cmCommandContext::cmCommandName::operator=(
   std::string const& name)
 {
   this->Original = name;
   this->Lower = cmSystemTools::LowerCase(name);
+  this->Command = nullptr;
+  this->CommandGeneration = 0;
   return *this;
 }
 
@@ -39,6 +49,7 @@ struct cmListFileParser
   const char* FileName;
   cmListFileLexer* Lexer;
   cmListFileFunction Function;
+  bool IssuedWarning;
   enum
   {
     SeparationOkay,
@@ -56,6 +67,7 @@ cmListFileParser::cmListFileParser(cmListFile* lf,
   , Messenger(messenger)
   , FileName(filename)
   , Lexer(cmListFileLexer_New())
+  , IssuedWarning(false)
 {
 }
 
@@ -142,18 +154,31 @@ bool cmListFileParser::ParseFile()
 }
 
 bool cmListFile::ParseFile(const char* filename, cmMessenger* messenger,
-                           cmListFileBacktrace const& lfbt)
+                           cmListFileBacktrace const& lfbt,
+                           cmListFileCache* cache)
 {
   if (!cmSystemTools::FileExists(filename) ||
       cmSystemTools::FileIsDirectory(filename)) {
     return false;
   }
 
+  if (cache && cache->Lookup(filename, this->Functions)) {
+    return true;
+  }
+
   bool parseError = false;
+  bool issuedWarning = false;
 
   {
     cmListFileParser parser(this, lfbt, messenger, filename);
     parseError = !parser.ParseFile();
+    issuedWarning = parser.IssuedWarning;
+  }
+
+  // Files that produce diagnostics are re-parsed every time so that
+  // the diagnostics are not lost.
+  if (cache && !parseError && !issuedWarning) {
+    cache->Store(filename, this->Functions);
   }
 
   return !parseError;
@@ -283,6 +308,7 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
     return false;
   }
   this->Messenger->IssueMessage(cmake::AUTHOR_WARNING, m.str(), lfbt);
+  this->IssuedWarning = true;
   return true;
 }
 
@@ -474,3 +500,356 @@ bool operator!=(const cmListFileContext& lhs, const cmListFileContext& rhs)
 {
   return !(lhs == rhs);
 }
+
+namespace {
+
+// Increment when the encoding below changes.
+unsigned int const cmListFileCacheFormat = 1;
+char const cmListFileCacheMagic[] = "CMakeListFileCache";
+
+class cmListFileCacheWriter
+{
+public:
+  explicit cmListFileCacheWriter(std::string& out)
+    : Out(out)
+  {
+  }
+
+  void WriteU32(unsigned long v)
+  {
+    for (int i = 0; i < 4; ++i) {
+      this->Out += static_cast<char>((v >> (8 * i)) & 0xFF);
+    }
+  }
+
+  void WriteU64(unsigned long long v)
+  {
+    for (int i = 0; i < 8; ++i) {
+      this->Out += static_cast<char>((v >> (8 * i)) & 0xFF);
+    }
+  }
+
+  void WriteString(std::string const& s)
+  {
+    this->WriteU32(static_cast<unsigned long>(s.size()));
+    this->Out += s;
+  }
+
+private:
+  std::string& Out;
+};
+
+class cmListFileCacheReader
+{
+public:
+  cmListFileCacheReader(char const* begin, char const* end)
+    : Cur(begin)
+    , End(end)
+  {
+  }
+
+  bool ReadU32(unsigned long& v)
+  {
+    if (this->End - this->Cur < 4) {
+      return false;
+    }
+    v = 0;
+    for (int i = 0; i < 4; ++i) {
+      v |= static_cast<unsigned long>(
+             static_cast<unsigned char>(this->Cur[i]))
+        << (8 * i);
+    }
+    this->Cur += 4;
+    return true;
+  }
+
+  bool ReadU64(unsigned long long& v)
+  {
+    if (this->End - this->Cur < 8) {
+      return false;
+    }
+    v = 0;
+    for (int i = 0; i < 8; ++i) {
+      v |= static_cast<unsigned long long>(
+             static_cast<unsigned char>(this->Cur[i]))
+        << (8 * i);
+    }
+    this->Cur += 8;
+    return true;
+  }
+
+  bool ReadString(std::string& s)
+  {
+    unsigned long n;
+    if (!this->ReadU32(n) ||
+        static_cast<unsigned long>(this->End - this->Cur) < n) {
+      return false;
+    }
+    s.assign(this->Cur, n);
+    this->Cur += n;
+    return true;
+  }
+
+  bool AtEnd() const { return this->Cur == this->End; }
+  char const* Position() const { return this->Cur; }
+
+private:
+  char const* Cur;
+  char const* End;
+};
+
+void EncodeFunctions(std::vector<cmListFileFunction> const& functions,
+                     std::string& data)
+{
+  cmListFileCacheWriter w(data);
+  w.WriteU32(static_cast<unsigned long>(functions.size()));
+  for (cmListFileFunction const& func : functions) {
+    w.WriteString(func.Name.Original);
+    w.WriteU64(static_cast<unsigned long long>(func.Line));
+    w.WriteU32(static_cast<unsigned long>(func.Arguments.size()));
+    for (cmListFileArgument const& arg : func.Arguments) {
+      w.WriteString(arg.Value);
+      w.WriteU32(static_cast<unsigned long>(arg.Delim));
+      w.WriteU64(static_cast<unsigned long long>(arg.Line));
+    }
+  }
+}
+
+bool DecodeFunctions(char const* begin, char const* end,
+                     std::vector<cmListFileFunction>& functions)
+{
+  cmListFileCacheReader r(begin, end);
+  unsigned long nfuncs;
+  if (!r.ReadU32(nfuncs)) {
+    return false;
+  }
+  std::string name;
+  for (unsigned long i = 0; i < nfuncs; ++i) {
+    functions.emplace_back();
+    cmListFileFunction& func = functions.back();
+    unsigned long long line;
+    unsigned long nargs;
+    if (!r.ReadString(name) || !r.ReadU64(line) || !r.ReadU32(nargs)) {
+      return false;
+    }
+    func.Name = name;
+    func.Line = static_cast<long>(line);
+    func.Arguments.reserve(nargs);
+    for (unsigned long j = 0; j < nargs; ++j) {
+      cmListFileArgument arg;
+      unsigned long delim;
+      if (!r.ReadString(arg.Value) || !r.ReadU32(delim) ||
+          delim > cmListFileArgument::Bracket || !r.ReadU64(line)) {
+        return false;
+      }
+      arg.Delim = static_cast<cmListFileArgument::Delimiter>(delim);
+      arg.Line = static_cast<long>(line);
+      func.Arguments.push_back(std::move(arg));
+    }
+  }
+  return r.AtEnd();
+}
+
+std::string GetListFileCacheHeader()
+{
+  std::string header;
+  cmListFileCacheWriter w(header);
+  w.WriteString(cmListFileCacheMagic);
+  w.WriteU32(cmListFileCacheFormat);
+  w.WriteString(cmVersion::GetCMakeVersion());
+  return header;
+}
+}
+
+cmListFileCache::cmListFileCache()
+  : Modified(false)
+{
+}
+
+bool cmListFileCache::GetFileStamp(std::string const& path, long long& mtime,
+                                   unsigned long long& size)
+{
+  cmsys::SystemTools::Stat_t st;
+  if (cmsys::SystemTools::Stat(path, &st) != 0) {
+    return false;
+  }
+  mtime = static_cast<long long>(st.st_mtime);
+  size = static_cast<unsigned long long>(st.st_size);
+  return true;
+}
+
+bool cmListFileCache::Load(std::string const& cacheFile)
+{
+  this->Entries.clear();
+  this->Buffer.clear();
+  this->Modified = false;
+
+  cmsys::ifstream fin(cacheFile.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  this->Buffer.assign(std::istreambuf_iterator<char>(fin),
+                      std::istreambuf_iterator<char>());
+
+  std::string const header = GetListFileCacheHeader();
+  if (this->Buffer.compare(0, header.size(), header) != 0) {
+    this->Buffer.clear();
+    this->Modified = true;
+    return false;
+  }
+
+  char const* begin = this->Buffer.data();
+  cmListFileCacheReader r(begin + header.size(),
+                          begin + this->Buffer.size());
+  unsigned long count;
+  if (!r.ReadU32(count)) {
+    this->Buffer.clear();
+    this->Modified = true;
+    return false;
+  }
+
+  // Read the index.  The encoded functions of each entry follow it
+  // contiguously in the same order.
+  std::vector<std::unordered_map<std::string, Entry>::iterator> order;
+  std::string path;
+  for (unsigned long i = 0; i < count; ++i) {
+    Entry e;
+    unsigned long long mtime;
+    unsigned long long length;
+    if (!r.ReadString(path) || !r.ReadU64(mtime) || !r.ReadU64(e.Size) ||
+        !r.ReadU64(length)) {
+      this->Entries.clear();
+      this->Buffer.clear();
+      this->Modified = true;
+      return false;
+    }
+    e.MTime = static_cast<long long>(mtime);
+    e.Length = static_cast<size_t>(length);
+    order.push_back(this->Entries.emplace(path, std::move(e)).first);
+  }
+
+  size_t offset = static_cast<size_t>(r.Position() - begin);
+  for (auto const& it : order) {
+    it->second.Offset = offset;
+    offset += it->second.Length;
+  }
+  if (offset != this->Buffer.size()) {
+    this->Entries.clear();
+    this->Buffer.clear();
+    this->Modified = true;
+    return false;
+  }
+  return true;
+}
+
+bool cmListFileCache::Save(std::string const& cacheFile)
+{
+  std::vector<std::pair<std::string const*, Entry const*>> used;
+  for (auto const& entry : this->Entries) {
+    if (entry.second.Used) {
+      used.emplace_back(&entry.first, &entry.second);
+    }
+  }
+  if (!this->Modified && used.size() == this->Entries.size()) {
+    return true;
+  }
+
+  // Write the entries in a deterministic order.
+  std::sort(used.begin(), used.end(),
+            [](std::pair<std::string const*, Entry const*> const& l,
+               std::pair<std::string const*, Entry const*> const& r) {
+              return *l.first < *r.first;
+            });
+
+  std::string out = GetListFileCacheHeader();
+  cmListFileCacheWriter w(out);
+  w.WriteU32(static_cast<unsigned long>(used.size()));
+  for (auto const& u : used) {
+    Entry const& e = *u.second;
+    w.WriteString(*u.first);
+    w.WriteU64(static_cast<unsigned long long>(e.MTime));
+    w.WriteU64(e.Size);
+    w.WriteU64(e.Data.empty() ? e.Length : e.Data.size());
+  }
+  for (auto const& u : used) {
+    Entry const& e = *u.second;
+    if (e.Data.empty()) {
+      out.append(this->Buffer, e.Offset, e.Length);
+    } else {
+      out += e.Data;
+    }
+  }
+
+  cmGeneratedFileStream fout;
+  fout.Open(cacheFile, true, true);
+  fout.write(out.data(), static_cast<std::streamsize>(out.size()));
+  if (!fout.Close()) {
+    return false;
+  }
+  this->Modified = false;
+  return true;
+}
+
+bool cmListFileCache::Lookup(std::string const& path,
+                             std::vector<cmListFileFunction>& functions)
+{
+  auto it = this->Entries.find(path);
+  if (it == this->Entries.end()) {
+    return false;
+  }
+  Entry& e = it->second;
+
+  long long mtime;
+  unsigned long long size;
+  if (!GetFileStamp(path, mtime, size) || mtime != e.MTime ||
+      size != e.Size) {
+    return false;
+  }
+
+  char const* begin;
+  char const* end;
+  if (e.Data.empty()) {
+    begin = this->Buffer.data() + e.Offset;
+    end = begin + e.Length;
+  } else {
+    begin = e.Data.data();
+    end = begin + e.Data.size();
+  }
+
+  size_t const oldSize = functions.size();
+  if (!DecodeFunctions(begin, end, functions)) {
+    functions.resize(oldSize);
+    this->Entries.erase(it);
+    this->Modified = true;
+    return false;
+  }
+  e.Used = true;
+  return true;
+}
+
+void cmListFileCache::Store(std::string const& path,
+                            std::vector<cmListFileFunction> const& functions)
+{
+  long long mtime;
+  unsigned long long size;
+  if (!GetFileStamp(path, mtime, size)) {
+    return;
+  }
+
+  // A file modified within the current second may be modified again
+  // without changing its stamp.  Do not cache it until it settles.
+  if (mtime >= static_cast<long long>(time(nullptr))) {
+    if (this->Entries.erase(path)) {
+      this->Modified = true;
+    }
+    return;
+  }
+
+  Entry& e = this->Entries[path];
+  e = Entry();
+  e.MTime = mtime;
+  e.Size = size;
+  EncodeFunctions(functions, e.Data);
+  e.Used = true;
+  this->Modified = true;
+}
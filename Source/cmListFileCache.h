@@ -9,17 +9,13 @@
 #include <memory> // IWYU pragma: keep
 #include <stddef.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cmStateSnapshot.h"
 
-/** \class cmListFileCache
- * \brief A class to cache list file contents.
- *
- * cmListFileCache is a class used to cache the contents of parsed
- * cmake list files.
- */
-
+class cmCommand;
+class cmListFileCache;
 class cmMessenger;
 
 struct cmCommandContext
@@ -28,6 +24,11 @@ struct cmCommandContext
   {
     std::string Lower;
     std::string Original;
+    // The command resolved by cmMakefile::ExecuteCommand the last time
+    // a function of this name ran.  It is valid while the generation of
+    // the commands in the cmState matches.
+    mutable cmCommand* Command = nullptr;
+    mutable unsigned long CommandGeneration = 0;
     cmCommandName() {}
     cmCommandName(std::string const& name) { *this = name; }
     cmCommandName& operator=(std::string const& name);
@@ -172,9 +173,60 @@ private:
 struct cmListFile
 {
   bool ParseFile(const char* path, cmMessenger* messenger,
-                 cmListFileBacktrace const& lfbt);
+                 cmListFileBacktrace const& lfbt,
+                 cmListFileCache* cache = nullptr);
 
   std::vector<cmListFileFunction> Functions;
 };
 
+/** \class cmListFileCache
+ * \brief A class to cache list file contents.
+ *
+ * cmListFileCache is a class used to cache the contents of parsed
+ * cmake list files across cmake runs.  Entries are keyed by the full
+ * path of the list file and validated against its size and modification
+ * time.  The cache file is read into memory once and an entry is decoded
+ * only when its list file is actually requested.
+ */
+class cmListFileCache
+{
+public:
+  cmListFileCache();
+
+  /** Read the cache file.  Returns false if it is missing or invalid.  */
+  bool Load(std::string const& cacheFile);
+
+  /** Write the entries used since Load back to the cache file, if they
+      differ from what was loaded.  */
+  bool Save(std::string const& cacheFile);
+
+  /** Get the functions of an unchanged list file.  */
+  bool Lookup(std::string const& path,
+              std::vector<cmListFileFunction>& functions);
+
+  /** Record the functions parsed from a list file.  */
+  void Store(std::string const& path,
+             std::vector<cmListFileFunction> const& functions);
+
+private:
+  struct Entry
+  {
+    long long MTime = 0;
+    unsigned long long Size = 0;
+    // Location of the encoded functions within Buffer, if loaded.
+    size_t Offset = 0;
+    size_t Length = 0;
+    // Encoded functions, if stored during this run.
+    std::string Data;
+    bool Used = false;
+  };
+
+  static bool GetFileStamp(std::string const& path, long long& mtime,
+                           unsigned long long& size);
+
+  std::string Buffer;
+  std::unordered_map<std::string, Entry> Entries;
+  bool Modified;
+};
+
 #endif
@@ -60,10 +60,16 @@ void cmLocalNinjaGenerator::Generate()
     this->HomeRelativeOutputPath.clear();
   }
 
-  this->WriteProcessedMakefile(this->GetBuildFileStream());
+  // The processed makefile comment goes first in the build file that
+  // holds the statements of this directory.
+  bool const directoryBuildFile =
+    this->GetGlobalNinjaGenerator()->HasDirectoryBuildFiles();
+  if (!directoryBuildFile) {
+    this->WriteProcessedMakefile(this->GetBuildFileStream());
 #ifdef NINJA_GEN_VERBOSE_FILES
-  this->WriteProcessedMakefile(this->GetRulesFileStream());
+    this->WriteProcessedMakefile(this->GetRulesFileStream());
 #endif
+  }
 
   // We do that only once for the top CMakeLists.txt file.
   if (this->IsRootMakefile()) {
@@ -81,6 +87,16 @@ void cmLocalNinjaGenerator::Generate()
     }
   }
 
+  // The build statements of this directory may go to a file of its own.
+  this->GetGlobalNinjaGenerator()->OpenDirectoryBuildFileStream(this);
+
+  if (directoryBuildFile) {
+    this->WriteProcessedMakefile(this->GetBuildFileStream());
+#ifdef NINJA_GEN_VERBOSE_FILES
+    this->WriteProcessedMakefile(this->GetRulesFileStream());
+#endif
+  }
+
   const std::vector<cmGeneratorTarget*>& targets = this->GetGeneratorTargets();
   for (cmGeneratorTarget* target : targets) {
     if (target->GetType() == cmStateEnums::INTERFACE_LIBRARY) {
@@ -100,6 +116,8 @@ void cmLocalNinjaGenerator::Generate()
   }
 
   this->WriteCustomCommandBuildStatements();
+
+  this->GetGlobalNinjaGenerator()->CloseDirectoryBuildFileStream();
 }
 
 // TODO: Picked up from cmLocalUnixMakefileGenerator3.  Refactor it.
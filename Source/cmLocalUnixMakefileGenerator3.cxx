@@ -778,9 +778,36 @@ void cmLocalUnixMakefileGenerator3::WriteSpecialTargetsBottom(
     runRule +=
       this->ConvertToOutputFormat(cmakefileName, cmOutputConverter::SHELL);
     runRule += " 0";
+    commands.push_back(std::move(runRule));
+
+    // Scan the dependencies of the targets scanned in one batch with a
+    // call of this signature:
+    //
+    //   cmake -E cmake_depends_batch <generator>
+    //                                <home-src-dir> <home-out-dir>
+    //                                --color=$(COLOR)
+    //
+    // The targets to scan are listed in Makefile.cmake.
+    cmGlobalUnixMakefileGenerator3* gg =
+      static_cast<cmGlobalUnixMakefileGenerator3*>(this->GlobalGenerator);
+    if (gg->GetBatchDependScan()) {
+      std::string depRule = "$(CMAKE_COMMAND) -E cmake_depends_batch \"";
+      depRule += gg->GetName();
+      depRule += "\" ";
+      depRule += this->ConvertToOutputFormat(
+        cmSystemTools::CollapseFullPath(this->GetSourceDirectory()),
+        cmOutputConverter::SHELL);
+      depRule += " ";
+      depRule += this->ConvertToOutputFormat(
+        cmSystemTools::CollapseFullPath(this->GetBinaryDirectory()),
+        cmOutputConverter::SHELL);
+      if (this->GetColorMakefile()) {
+        depRule += " --color=$(COLOR)";
+      }
+      commands.push_back(std::move(depRule));
+    }
 
     std::vector<std::string> no_depends;
-    commands.push_back(std::move(runRule));
     if (!this->IsRootMakefile()) {
       this->CreateCDCommand(commands, this->GetBinaryDirectory(),
                             this->GetCurrentBinaryDirectory());
@@ -1256,6 +1283,22 @@ std::string cmLocalUnixMakefileGenerator3::CreateMakeVariable(
 bool cmLocalUnixMakefileGenerator3::UpdateDependencies(const char* tgtInfo,
                                                        bool verbose,
                                                        bool color)
+{
+  std::map<std::string, cmDepends::DependencyVector> validDependencies;
+  if (this->CheckDependencies(tgtInfo, verbose, validDependencies)) {
+    // The dependencies are already up-to-date.
+    return true;
+  }
+
+  // The dependencies must be regenerated.
+  std::string dir = cmSystemTools::GetFilenamePath(tgtInfo);
+  EchoDependScan(dir, color);
+  return this->ScanDependencies(dir.c_str(), validDependencies);
+}
+
+bool cmLocalUnixMakefileGenerator3::CheckDependencies(
+  const char* tgtInfo, bool verbose,
+  std::map<std::string, cmDepends::DependencyVector>& validDependencies)
 {
   // read in the target info file
   if (!this->Makefile->ReadListFile(tgtInfo) ||
@@ -1270,53 +1313,52 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(const char* tgtInfo,
   std::string internalDependFile = dir + "/depend.internal";
   std::string dependFile = dir + "/depend.make";
 
+  std::string dirInfoFile = this->GetCurrentBinaryDirectory();
+  dirInfoFile += cmake::GetCMakeFilesDirectory();
+  dirInfoFile += "/CMakeDirectoryInformation.cmake";
+
+  // Compare depend.internal to both information files at once.
+  cmFileTimeComparison* ftc =
+    this->GlobalGenerator->GetCMakeInstance()->GetFileComparison();
+  cmFileTimeComparison::FilePairs pairs;
+  pairs.emplace_back(internalDependFile, tgtInfo);
+  pairs.emplace_back(internalDependFile, dirInfoFile);
+  std::vector<int> results;
+  ftc->FileTimeCompare(pairs, results);
+
   // If the target DependInfo.cmake file has changed since the last
   // time dependencies were scanned then force rescanning.  This may
   // happen when a new source file is added and CMake regenerates the
   // project but no other sources were touched.
   bool needRescanDependInfo = false;
-  cmFileTimeComparison* ftc =
-    this->GlobalGenerator->GetCMakeInstance()->GetFileComparison();
-  {
-    int result;
-    if (!ftc->FileTimeCompare(internalDependFile.c_str(), tgtInfo, &result) ||
-        result < 0) {
-      if (verbose) {
-        std::ostringstream msg;
-        msg << "Dependee \"" << tgtInfo << "\" is newer than depender \""
-            << internalDependFile << "\"." << std::endl;
-        cmSystemTools::Stdout(msg.str().c_str());
-      }
-      needRescanDependInfo = true;
+  if (results[0] < 0 || results[0] >= cmFileTimeComparison::FirstMissing) {
+    if (verbose) {
+      std::ostringstream msg;
+      msg << "Dependee \"" << tgtInfo << "\" is newer than depender \""
+          << internalDependFile << "\"." << std::endl;
+      cmSystemTools::Stdout(msg.str().c_str());
     }
+    needRescanDependInfo = true;
   }
 
   // If the directory information is newer than depend.internal, include dirs
   // may have changed. In this case discard all old dependencies.
   bool needRescanDirInfo = false;
-  std::string dirInfoFile = this->GetCurrentBinaryDirectory();
-  dirInfoFile += cmake::GetCMakeFilesDirectory();
-  dirInfoFile += "/CMakeDirectoryInformation.cmake";
-  {
-    int result;
-    if (!ftc->FileTimeCompare(internalDependFile.c_str(), dirInfoFile.c_str(),
-                              &result) ||
-        result < 0) {
-      if (verbose) {
-        std::ostringstream msg;
-        msg << "Dependee \"" << dirInfoFile << "\" is newer than depender \""
-            << internalDependFile << "\"." << std::endl;
-        cmSystemTools::Stdout(msg.str().c_str());
-      }
-      needRescanDirInfo = true;
+  if (results[1] < 0 || results[1] >= cmFileTimeComparison::FirstMissing) {
+    if (verbose) {
+      std::ostringstream msg;
+      msg << "Dependee \"" << dirInfoFile << "\" is newer than depender \""
+          << internalDependFile << "\"." << std::endl;
+      cmSystemTools::Stdout(msg.str().c_str());
     }
+    needRescanDirInfo = true;
   }
 
   // Check the implicit dependencies to see if they are up to date.
   // The build.make file may have explicit dependencies for the object
   // files but these will not affect the scanning process so they need
   // not be considered.
-  std::map<std::string, cmDepends::DependencyVector> validDependencies;
+  validDependencies.clear();
   bool needRescanDependencies = false;
   if (!needRescanDirInfo) {
     cmDependsC checker;
@@ -1336,26 +1378,34 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(const char* tgtInfo,
       dependFile.c_str(), internalDependFile.c_str(), validDependencies);
   }
 
-  if (needRescanDependInfo || needRescanDirInfo || needRescanDependencies) {
-    // The dependencies must be regenerated.
-    std::string targetName = cmSystemTools::GetFilenameName(dir);
-    targetName = targetName.substr(0, targetName.length() - 4);
-    std::string message = "Scanning dependencies of target ";
-    message += targetName;
-    cmSystemTools::MakefileColorEcho(cmsysTerminal_Color_ForegroundMagenta |
-                                       cmsysTerminal_Color_ForegroundBold,
-                                     message.c_str(), true, color);
-
-    return this->ScanDependencies(dir.c_str(), validDependencies);
-  }
+  return !(needRescanDependInfo || needRescanDirInfo ||
+           needRescanDependencies);
+}
 
-  // The dependencies are already up-to-date.
-  return true;
+void cmLocalUnixMakefileGenerator3::EchoDependScan(
+  std::string const& targetDir, bool color)
+{
+  std::string targetName = cmSystemTools::GetFilenameName(targetDir);
+  targetName = targetName.substr(0, targetName.length() - 4);
+  std::string message = "Scanning dependencies of target ";
+  message += targetName;
+  cmSystemTools::MakefileColorEcho(cmsysTerminal_Color_ForegroundMagenta |
+                                     cmsysTerminal_Color_ForegroundBold,
+                                   message.c_str(), true, color);
 }
 
 bool cmLocalUnixMakefileGenerator3::ScanDependencies(
   const char* targetDir,
   std::map<std::string, cmDepends::DependencyVector>& validDeps)
+{
+  DependScan scan;
+  scan.TargetDirectory = targetDir;
+  scan.ValidDeps.swap(validDeps);
+  return this->PrepareDependScan(scan, nullptr) && this->RunDependScan(scan);
+}
+
+bool cmLocalUnixMakefileGenerator3::PrepareDependScan(
+  DependScan& scan, cmDependsC::SharedCacheSet* sharedCaches)
 {
   // Read the directory information file.
   cmMakefile* mf = this->Makefile;
@@ -1392,8 +1442,49 @@ bool cmLocalUnixMakefileGenerator3::ScanDependencies(
     cmSystemTools::Error("Directory Information file not found");
   }
 
-  // create the file stream for the depends file
-  std::string dir = targetDir;
+  // for each language we need to scan, create its scanner
+  std::string const& dir = scan.TargetDirectory;
+  std::string const& langStr =
+    mf->GetSafeDefinition("CMAKE_DEPENDS_LANGUAGES");
+  std::vector<std::string> langs;
+  cmSystemTools::ExpandListArgument(langStr, langs);
+  for (std::string const& lang : langs) {
+    // Create the scanner for this language
+    cmDepends* scanner = nullptr;
+    if (lang == "C" || lang == "CXX" || lang == "RC" || lang == "ASM" ||
+        lang == "CUDA") {
+      // TODO: Handle RC (resource files) dependencies correctly.
+      scanner = new cmDependsC(this, dir.c_str(), lang, &scan.ValidDeps,
+                               sharedCaches);
+    }
+#ifdef CMAKE_BUILD_WITH_CMAKE
+    else if (lang == "Fortran") {
+      // Fortran scanning reads the results of other targets' scans
+      // and must run in the order given by the build.
+      scanner = new cmDependsFortran(this);
+      scan.ThreadSafe = false;
+    } else if (lang == "Java") {
+      scanner = new cmDependsJava();
+      scan.ThreadSafe = false;
+    }
+#endif
+
+    if (scanner) {
+      scanner->SetLocalGenerator(this);
+      scanner->SetFileComparison(
+        this->GlobalGenerator->GetCMakeInstance()->GetFileComparison());
+      scanner->SetLanguage(lang);
+      scanner->SetTargetDirectory(dir.c_str());
+      scan.Scanners.emplace_back(lang, std::unique_ptr<cmDepends>(scanner));
+    }
+  }
+
+  return true;
+}
+
+bool cmLocalUnixMakefileGenerator3::RunDependScan(DependScan& scan)
+{
+  std::string const& dir = scan.TargetDirectory;
 
   // Open the make depends file.  This should be copy-if-different
   // because the make tool may try to reload it needlessly otherwise.
@@ -1422,40 +1513,15 @@ bool cmLocalUnixMakefileGenerator3::ScanDependencies(
   this->WriteDisclaimer(internalRuleFileStream);
 
   // for each language we need to scan, scan it
-  std::string const& langStr =
-    mf->GetSafeDefinition("CMAKE_DEPENDS_LANGUAGES");
-  std::vector<std::string> langs;
-  cmSystemTools::ExpandListArgument(langStr, langs);
-  for (std::string const& lang : langs) {
-    // construct the checker
-    // Create the scanner for this language
-    cmDepends* scanner = nullptr;
-    if (lang == "C" || lang == "CXX" || lang == "RC" || lang == "ASM" ||
-        lang == "CUDA") {
-      // TODO: Handle RC (resource files) dependencies correctly.
-      scanner = new cmDependsC(this, targetDir, lang, &validDeps);
-    }
-#ifdef CMAKE_BUILD_WITH_CMAKE
-    else if (lang == "Fortran") {
+  for (auto& scanner : scan.Scanners) {
+    if (scanner.first == "Fortran") {
       ruleFileStream << "# Note that incremental build could trigger "
                      << "a call to cmake_copy_f90_mod on each re-build\n";
-      scanner = new cmDependsFortran(this);
-    } else if (lang == "Java") {
-      scanner = new cmDependsJava();
     }
-#endif
-
-    if (scanner) {
-      scanner->SetLocalGenerator(this);
-      scanner->SetFileComparison(
-        this->GlobalGenerator->GetCMakeInstance()->GetFileComparison());
-      scanner->SetLanguage(lang);
-      scanner->SetTargetDirectory(dir.c_str());
-      scanner->Write(ruleFileStream, internalRuleFileStream);
+    scanner.second->Write(ruleFileStream, internalRuleFileStream);
 
-      // free the scanner for this language
-      delete scanner;
-    }
+    // free the scanner for this language
+    scanner.second.reset();
   }
 
   return true;
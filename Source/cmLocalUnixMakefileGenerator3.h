@@ -6,12 +6,15 @@
 #include "cmConfigure.h" // IWYU pragma: keep
 
 #include "cmDepends.h"
+#include "cmDependsC.h"
 #include "cmLocalCommonGenerator.h"
 
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 class cmCustomCommand;
@@ -131,6 +134,37 @@ public:
   bool UpdateDependencies(const char* tgtInfo, bool verbose,
                           bool color) override;
 
+  /** Scanners for the implicit dependencies of one target.  They are
+      created on the main thread and, if ThreadSafe, may be run on any
+      other.  */
+  struct DependScan
+  {
+    std::string TargetDirectory;
+    std::map<std::string, cmDepends::DependencyVector> ValidDeps;
+    std::vector<std::pair<std::string, std::unique_ptr<cmDepends>>>
+      Scanners;
+    bool ThreadSafe = true;
+  };
+
+  /** Load the DependInfo.cmake file of a target and check whether its
+      dependencies are up to date.  If not, validDeps receives the ones
+      that are still valid and false is returned.  */
+  bool CheckDependencies(
+    const char* tgtInfo, bool verbose,
+    std::map<std::string, cmDepends::DependencyVector>& validDeps);
+
+  /** Print the message announcing a scan of a target's dependencies.  */
+  static void EchoDependScan(std::string const& targetDir, bool color);
+
+  /** Create the scanners for a target whose DependInfo.cmake file was
+      loaded by CheckDependencies.  */
+  bool PrepareDependScan(DependScan& scan,
+                         cmDependsC::SharedCacheSet* sharedCaches);
+
+  /** Run the scanners and write the depend.make and depend.internal
+      files of the target.  */
+  bool RunDependScan(DependScan& scan);
+
   /** Called from command-line hook to clear dependencies.  */
   void ClearDependencies(cmMakefile* mf, bool verbose) override;
 
@@ -10,6 +10,7 @@
 #include <ctype.h>
 #include <iterator>
 #include <memory> // IWYU pragma: keep
+#include <set>
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -44,6 +45,7 @@
 #include "cmake.h"
 
 #ifdef CMAKE_BUILD_WITH_CMAKE
+#  include "cmMakefileProfilingData.h"
 #  include "cmVariableWatch.h"
 #endif
 
@@ -359,11 +361,25 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
   cmMakefileCall stack_manager(this, lff, status);
   static_cast<void>(stack_manager);
 
-  // Lookup the command prototype.
-  if (cmCommand* proto =
-        this->GetState()->GetCommandByExactName(lff.Name.Lower)) {
-    // Clone the prototype.
-    std::unique_ptr<cmCommand> pcmd(proto->Clone());
+  // Lookup the command prototype.  Reuse the one found by the previous
+  // execution of this function unless the set of commands changed.
+  cmState* state = this->GetState();
+  cmCommandContext::cmCommandName const& name = lff.Name;
+  if (name.CommandGeneration != state->GetCommandsGeneration()) {
+    name.Command = state->GetCommandByExactName(name.Lower);
+    name.CommandGeneration = state->GetCommandsGeneration();
+  }
+  if (cmCommand* proto = name.Command) {
+    // Invoke a reusable command on its prototype unless an invocation
+    // is already running on it, e.g. one that triggered a variable watch.
+    std::unique_ptr<cmCommand> clone;
+    cmCommand* pcmd = proto;
+    if (proto->IsReusable() && !proto->IsInvoking()) {
+      proto->SetError(std::string());
+    } else {
+      clone.reset(proto->Clone());
+      pcmd = clone.get();
+    }
     pcmd->SetMakefile(this);
 
     // Decide whether to invoke the command.
@@ -372,8 +388,16 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
       if (this->GetCMakeInstance()->GetTrace()) {
         this->PrintCommandTrace(lff);
       }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+      cmMakefileProfilingData::RAII profilingScope(
+        this->GetCMakeInstance()->GetProfilingOutput(), lff,
+        this->Backtrace.Top());
+      static_cast<void>(profilingScope);
+#endif
       // Try invoking the command.
+      pcmd->SetInvoking(true);
       bool invokeSucceeded = pcmd->InvokeInitialPass(lff.Arguments, status);
+      pcmd->SetInvoking(false);
       bool hadNestedError = status.GetNestedError();
       if (!invokeSucceeded || hadNestedError) {
         if (!hadNestedError) {
@@ -386,9 +410,9 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
         if (this->GetCMakeInstance()->GetWorkingMode() != cmake::NORMAL_MODE) {
           cmSystemTools::SetFatalErrorOccured();
         }
-      } else if (pcmd->HasFinalPass()) {
+      } else if (clone && clone->HasFinalPass()) {
         // use the command
-        this->FinalPassCommands.push_back(pcmd.release());
+        this->FinalPassCommands.push_back(clone.release());
       }
     }
   } else {
@@ -542,7 +566,8 @@ bool cmMakefile::ReadDependentFile(const char* filename, bool noPolicyScope)
 
   cmListFile listFile;
   if (!listFile.ParseFile(filenametoread.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+                          this->Backtrace,
+                          this->GetCMakeInstance()->GetListFileCache())) {
     return false;
   }
 
@@ -593,7 +618,8 @@ bool cmMakefile::ReadListFile(const char* filename)
 
   cmListFile listFile;
   if (!listFile.ParseFile(filenametoread.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+                          this->Backtrace,
+                          this->GetCMakeInstance()->GetListFileCache())) {
     return false;
   }
 
@@ -1498,7 +1524,8 @@ void cmMakefile::Configure()
 
   cmListFile listFile;
   if (!listFile.ParseFile(currentStart.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+                          this->Backtrace,
+                          this->GetCMakeInstance()->GetListFileCache())) {
     return;
   }
   if (this->IsRootMakefile()) {
@@ -2457,6 +2484,24 @@ const std::string& cmMakefile::GetSafeDefinition(const std::string& name) const
   return *def;
 }
 
+const std::string* cmMakefile::GetDefList(const std::string& name,
+                                          cmListElements const*& elements,
+                                          cmListElements& storage) const
+{
+  elements = nullptr;
+  const std::string* def = this->GetDef(name);
+  if (!def) {
+    return nullptr;
+  }
+  if (this->StateSnapshot.GetDefinitionList(name, elements) != def) {
+    // The value is that of a cache entry.
+    storage.clear();
+    cmSystemTools::ExpandListElements(*def, storage);
+    elements = &storage;
+  }
+  return def;
+}
+
 std::vector<std::string> cmMakefile::GetDefinitions() const
 {
   std::vector<std::string> res = this->StateSnapshot.ClosureKeys();
@@ -3331,6 +3376,7 @@ int cmMakefile::TryCompile(const std::string& srcdir,
                            const std::string& bindir,
                            const std::string& projectName,
                            const std::string& targetName, bool fast, int jobs,
+                           bool keepGoing,
                            const std::vector<std::string>* cmakeArgs,
                            std::string& output)
 {
@@ -3443,7 +3489,8 @@ int cmMakefile::TryCompile(const std::string& srcdir,
 
   // finally call the generator to actually build the resulting project
   int ret = this->GetGlobalGenerator()->TryCompile(
-    jobs, srcdir, bindir, projectName, targetName, fast, output, this);
+    jobs, srcdir, bindir, projectName, targetName, fast, keepGoing, output,
+    this);
 
   this->IsSourceFileTryCompile = false;
   return ret;
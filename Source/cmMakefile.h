@@ -108,11 +108,12 @@ public:
 
   /**
    * Try running cmake and building a file. This is used for dynalically
-   * loaded commands, not as part of the usual build process.
+   * loaded commands, not as part of the usual build process.  With
+   * keepGoing the build tool continues with other targets after one fails.
    */
   int TryCompile(const std::string& srcdir, const std::string& bindir,
                  const std::string& projectName, const std::string& targetName,
-                 bool fast, int jobs,
+                 bool fast, int jobs, bool keepGoing,
                  const std::vector<std::string>* cmakeArgs,
                  std::string& output);
 
@@ -435,6 +436,15 @@ public:
   const char* GetDefinition(const std::string&) const;
   const std::string* GetDef(const std::string&) const;
   const std::string& GetSafeDefinition(const std::string&) const;
+  /**
+   * Given a variable name, return its value along with the positions of
+   * its elements as a ;-separated list.  The positions are computed once
+   * per value of a variable and shared with later lookups.  Those of a
+   * cache entry are computed into the given storage.
+   */
+  const std::string* GetDefList(const std::string& name,
+                                cmListElements const*& elements,
+                                cmListElements& storage) const;
   std::string GetRequiredDefinition(const std::string& name) const;
   bool IsDefinitionSet(const std::string&) const;
   /**
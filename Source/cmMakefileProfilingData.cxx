@@ -0,0 +1,251 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmMakefileProfilingData.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+
+#include "cm_jsoncpp_value.h"
+#include "cm_jsoncpp_writer.h"
+#include "cm_uv.h"
+
+#include "cmListFileCache.h"
+#include "cmSystemTools.h"
+
+cmMakefileProfilingData::cmMakefileProfilingData(
+  std::string const& traceFile, std::string const& summaryFile)
+  : StartTime(Clock::now())
+  , SummaryFile(summaryFile)
+  , Pid(static_cast<long long>(uv_os_getpid()))
+{
+  if (!traceFile.empty()) {
+    this->TraceStream.open(traceFile.c_str());
+    if (!this->TraceStream) {
+      cmSystemTools::Error("Unable to open profiling output file: ",
+                           traceFile.c_str());
+    } else {
+      this->TraceStream << "[\n";
+    }
+  }
+}
+
+cmMakefileProfilingData::~cmMakefileProfilingData()
+{
+  // Close entries left open by an early exit.
+  while (!this->Stack.empty()) {
+    this->StopEntry();
+  }
+  if (this->TraceStream) {
+    this->TraceStream << "]\n";
+    this->TraceStream.close();
+  }
+  if (!this->SummaryFile.empty()) {
+    this->WriteSummary();
+  }
+}
+
+long long cmMakefileProfilingData::Timestamp(Clock::time_point t) const
+{
+  return static_cast<long long>(
+    std::chrono::duration_cast<std::chrono::microseconds>(t - this->StartTime)
+      .count());
+}
+
+void cmMakefileProfilingData::WriteEvent(std::string const& json)
+{
+  if (!this->TraceStream) {
+    return;
+  }
+  if (!this->FirstEvent) {
+    this->TraceStream << ",";
+  }
+  this->FirstEvent = false;
+  this->TraceStream << json;
+}
+
+void cmMakefileProfilingData::StartEntry(cmListFileFunction const& lff,
+                                         cmListFileContext const& lfc)
+{
+  Entry entry;
+  entry.Name = lff.Name.Lower;
+  entry.File = lfc.FilePath;
+  entry.IsCommand = true;
+  entry.Children = Clock::duration::zero();
+
+  Cost& command = this->Commands[entry.Name];
+  ++command.Calls;
+  ++command.Active;
+  Cost& listFile = this->ListFiles[entry.File];
+  ++listFile.Calls;
+  ++listFile.Active;
+  ++this->Invocations;
+
+  if (this->TraceStream) {
+    std::string args;
+    for (cmListFileArgument const& arg : lff.Arguments) {
+      if (!args.empty()) {
+        args += ' ';
+      }
+      args += arg.Value;
+    }
+    Json::Value event(Json::objectValue);
+    event["cat"] = "cmake";
+    event["ph"] = "B";
+    event["name"] = lff.Name.Original;
+    event["pid"] = static_cast<Json::Int64>(this->Pid);
+    event["tid"] = 0;
+    Json::Value& eventArgs = event["args"] = Json::objectValue;
+    eventArgs["functionArgs"] = args;
+    eventArgs["location"] = lfc.FilePath + ":" + std::to_string(lfc.Line);
+
+    entry.Start = Clock::now();
+    event["ts"] = static_cast<Json::Int64>(this->Timestamp(entry.Start));
+    this->WriteEvent(Json::FastWriter().write(event));
+  } else {
+    entry.Start = Clock::now();
+  }
+  this->Stack.push_back(std::move(entry));
+}
+
+void cmMakefileProfilingData::StartEntry(std::string const& phase)
+{
+  Entry entry;
+  entry.Name = phase;
+  entry.IsCommand = false;
+  entry.Children = Clock::duration::zero();
+
+  Cost& cost = this->Phases[phase];
+  ++cost.Calls;
+  ++cost.Active;
+
+  entry.Start = Clock::now();
+  if (this->TraceStream) {
+    Json::Value event(Json::objectValue);
+    event["cat"] = "cmake";
+    event["ph"] = "B";
+    event["name"] = phase;
+    event["pid"] = static_cast<Json::Int64>(this->Pid);
+    event["tid"] = 0;
+    event["ts"] = static_cast<Json::Int64>(this->Timestamp(entry.Start));
+    this->WriteEvent(Json::FastWriter().write(event));
+  }
+  this->Stack.push_back(std::move(entry));
+}
+
+void cmMakefileProfilingData::StopEntry()
+{
+  if (this->Stack.empty()) {
+    return;
+  }
+  Clock::time_point const now = Clock::now();
+  Entry const& entry = this->Stack.back();
+  Clock::duration const elapsed = now - entry.Start;
+  Clock::duration const self = elapsed - entry.Children;
+
+  auto account = [elapsed, self](Cost& cost) {
+    cost.Self += self;
+    if (--cost.Active == 0) {
+      cost.Inclusive += elapsed;
+    }
+  };
+  if (entry.IsCommand) {
+    account(this->Commands[entry.Name]);
+    account(this->ListFiles[entry.File]);
+  } else {
+    account(this->Phases[entry.Name]);
+  }
+
+  if (this->TraceStream) {
+    Json::Value event(Json::objectValue);
+    event["ph"] = "E";
+    event["pid"] = static_cast<Json::Int64>(this->Pid);
+    event["tid"] = 0;
+    event["ts"] = static_cast<Json::Int64>(this->Timestamp(now));
+    this->WriteEvent(Json::FastWriter().write(event));
+  }
+
+  this->Stack.pop_back();
+  if (!this->Stack.empty()) {
+    this->Stack.back().Children += elapsed;
+  }
+}
+
+void cmMakefileProfilingData::WriteCostTable(std::ostream& os,
+                                             char const* title,
+                                             char const* keyTitle,
+                                             CostMap const& costs)
+{
+  // Sort by decreasing inclusive time, then by name.
+  std::vector<CostMap::value_type const*> sorted;
+  sorted.reserve(costs.size());
+  for (auto const& c : costs) {
+    sorted.push_back(&c);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](CostMap::value_type const* l,
+                      CostMap::value_type const* r) {
+                     return l->second.Inclusive > r->second.Inclusive;
+                   });
+
+  os << title << ":\n\n"
+     << std::setw(14) << "Inclusive [s]" << std::setw(14) << "Self [s]"
+     << std::setw(10) << "Calls"
+     << "  " << keyTitle << "\n";
+  for (CostMap::value_type const* c : sorted) {
+    os << std::setw(14)
+       << std::chrono::duration<double>(c->second.Inclusive).count()
+       << std::setw(14)
+       << std::chrono::duration<double>(c->second.Self).count()
+       << std::setw(10) << c->second.Calls << "  " << c->first << "\n";
+  }
+  os << "\n";
+}
+
+void cmMakefileProfilingData::WriteSummary() const
+{
+  cmsys::ofstream fout(this->SummaryFile.c_str());
+  if (!fout) {
+    cmSystemTools::Error("Unable to open profiling summary file: ",
+                         this->SummaryFile.c_str());
+    return;
+  }
+  fout << std::fixed << std::setprecision(6);
+  fout << "CMake profile: "
+       << std::chrono::duration<double>(Clock::now() - this->StartTime)
+            .count()
+       << " s, " << this->Invocations << " command invocations\n\n";
+  if (!this->Phases.empty()) {
+    WriteCostTable(fout, "Phases", "Phase", this->Phases);
+  }
+  WriteCostTable(fout, "Commands, functions and macros", "Command",
+                 this->Commands);
+  WriteCostTable(fout, "Listfiles", "Listfile", this->ListFiles);
+}
+
+cmMakefileProfilingData::RAII::RAII(cmMakefileProfilingData* data,
+                                    cmListFileFunction const& lff,
+                                    cmListFileContext const& lfc)
+  : Data(data)
+{
+  if (this->Data) {
+    this->Data->StartEntry(lff, lfc);
+  }
+}
+
+cmMakefileProfilingData::RAII::RAII(cmMakefileProfilingData* data,
+                                    std::string const& phase)
+  : Data(data)
+{
+  if (this->Data) {
+    this->Data->StartEntry(phase);
+  }
+}
+
+cmMakefileProfilingData::RAII::~RAII()
+{
+  if (this->Data) {
+    this->Data->StopEntry();
+  }
+}
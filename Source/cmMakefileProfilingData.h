@@ -0,0 +1,107 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmMakefileProfilingData_h
+#define cmMakefileProfilingData_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include "cmsys/FStream.hxx"
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+class cmListFileContext;
+struct cmListFileFunction;
+
+/** \class cmMakefileProfilingData
+ * \brief Record the time spent executing commands during a cmake run.
+ *
+ * Every command invocation is written as a pair of begin/end events to a
+ * file in the Chrome trace event format, which can be loaded into
+ * chrome://tracing or Perfetto.  Aggregate costs per command, including
+ * user-defined functions and macros, and per listfile are collected and
+ * written as a plain text summary table when the object is destroyed.
+ */
+class cmMakefileProfilingData
+{
+public:
+  /** Either file name may be empty to skip that output.  */
+  cmMakefileProfilingData(std::string const& traceFile,
+                          std::string const& summaryFile);
+  ~cmMakefileProfilingData();
+
+  cmMakefileProfilingData(cmMakefileProfilingData const&) = delete;
+  cmMakefileProfilingData& operator=(cmMakefileProfilingData const&) =
+    delete;
+
+  /** Start the entry for a command invoked at the given context.  */
+  void StartEntry(cmListFileFunction const& lff,
+                  cmListFileContext const& lfc);
+
+  /** Start the entry for a phase of the run, such as "configure".  */
+  void StartEntry(std::string const& phase);
+
+  /** Stop the most recently started entry.  */
+  void StopEntry();
+
+  /** Start an entry on construction and stop it on destruction.
+      A null profiler makes this a no-op.  */
+  class RAII
+  {
+  public:
+    RAII(cmMakefileProfilingData* data, cmListFileFunction const& lff,
+         cmListFileContext const& lfc);
+    RAII(cmMakefileProfilingData* data, std::string const& phase);
+    ~RAII();
+
+    RAII(RAII const&) = delete;
+    RAII& operator=(RAII const&) = delete;
+
+  private:
+    cmMakefileProfilingData* Data;
+  };
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Entry
+  {
+    std::string Name;
+    std::string File;
+    bool IsCommand;
+    Clock::time_point Start;
+    Clock::duration Children;
+  };
+
+  struct Cost
+  {
+    Clock::duration Inclusive = Clock::duration::zero();
+    Clock::duration Self = Clock::duration::zero();
+    unsigned long Calls = 0;
+    // Number of entries with this key currently on the stack, so that
+    // recursive invocations count their inclusive time only once.
+    unsigned int Active = 0;
+  };
+  typedef std::map<std::string, Cost> CostMap;
+
+  void WriteEvent(std::string const& json);
+  long long Timestamp(Clock::time_point t) const;
+  void WriteSummary() const;
+  static void WriteCostTable(std::ostream& os, char const* title,
+                             char const* keyTitle, CostMap const& costs);
+
+  Clock::time_point StartTime;
+  cmsys::ofstream TraceStream;
+  bool FirstEvent = true;
+  std::string SummaryFile;
+  std::vector<Entry> Stack;
+  CostMap Phases;
+  CostMap Commands;
+  CostMap ListFiles;
+  unsigned long long Invocations = 0;
+  long long Pid = 0;
+};
+
+#endif
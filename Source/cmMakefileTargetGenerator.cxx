@@ -432,8 +432,22 @@ void cmMakefileTargetGenerator::WriteObjectRuleFiles(
   objFullPath = cmSystemTools::CollapseFullPath(objFullPath);
   std::string srcFullPath =
     cmSystemTools::CollapseFullPath(source.GetFullPath());
-  this->LocalGenerator->AddImplicitDepends(
-    this->GeneratorTarget, lang, objFullPath.c_str(), srcFullPath.c_str());
+  if (!this->UseCompilerDepends(lang)) {
+    this->LocalGenerator->AddImplicitDepends(
+      this->GeneratorTarget, lang, objFullPath.c_str(), srcFullPath.c_str());
+  }
+}
+
+bool cmMakefileTargetGenerator::UseCompilerDepends(
+  const std::string& lang) const
+{
+  // Only dependency files in make syntax can be merged.
+  return this->GlobalGenerator->GetCompilerDepends() &&
+    (lang == "C" || lang == "CXX") &&
+    !this->Makefile->GetSafeDefinition("CMAKE_DEPFILE_FLAGS_" + lang)
+       .empty() &&
+    this->Makefile->GetSafeDefinition("CMAKE_" + lang + "_DEPFILE_FORMAT") ==
+    "gcc";
 }
 
 void cmMakefileTargetGenerator::WriteObjectBuildFile(
@@ -768,12 +782,36 @@ void cmMakefileTargetGenerator::WriteObjectBuildFile(
       }
     }
 
+    // Let the compiler write the dependencies of the object.
+    std::string compileFlags = flags;
+    if (this->UseCompilerDepends(lang)) {
+      std::string const depFile = obj + ".d";
+      std::string depFileFlags =
+        this->Makefile->GetSafeDefinition("CMAKE_DEPFILE_FLAGS_" + lang);
+      cmSystemTools::ReplaceString(
+        depFileFlags, "<DEPFILE>",
+        this->LocalGenerator->ConvertToOutputFormat(
+          depFile, cmOutputConverter::SHELL));
+      cmSystemTools::ReplaceString(depFileFlags, "<OBJECT>", shellObj);
+      this->LocalGenerator->AppendFlags(compileFlags, depFileFlags);
+
+      std::string depFileFull =
+        this->LocalGenerator->GetCurrentBinaryDirectory();
+      depFileFull += "/";
+      depFileFull += depFile;
+      this->CompilerDependFiles.emplace_back(
+        relativeObj, cmSystemTools::CollapseFullPath(depFileFull));
+      this->CleanFiles.push_back(depFile);
+    }
+    vars.Flags = compileFlags.c_str();
+
     // Expand placeholders in the commands.
     for (std::string& compileCommand : compileCommands) {
       compileCommand = launcher + compileCommand;
       rulePlaceholderExpander->ExpandRuleVariables(this->LocalGenerator,
                                                    compileCommand, vars);
     }
+    vars.Flags = flags.c_str();
 
     // Change the command working directory to the local build tree.
     this->LocalGenerator->CreateCDCommand(
@@ -1116,7 +1154,71 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
   if (this->LocalGenerator->GetColorMakefile()) {
     depCmd << " --color=$(COLOR)";
   }
-  commands.push_back(depCmd.str());
+
+  // Merge the dependency files written by the compiler.  Scanning is
+  // still needed for other languages and for multiple output pairs.
+  bool scan = true;
+  if (!this->CompilerDependFiles.empty()) {
+    std::string const targetDir = cmSystemTools::CollapseFullPath(
+      this->LocalGenerator->ConvertToFullPath(dir));
+    cmDependsCompiler::WriteList(
+      targetDir,
+      cmSystemTools::CollapseFullPath(
+        this->LocalGenerator->GetCurrentBinaryDirectory()),
+      this->CompilerDependFiles);
+
+    // Include the merged dependencies.
+    std::string const compilerDependFile =
+      targetDir + "/compiler_depend.make";
+    if (!cmSystemTools::FileExists(compilerDependFile)) {
+      cmGeneratedFileStream depFileStream(
+        compilerDependFile, false,
+        this->GlobalGenerator->GetMakefileEncoding());
+      depFileStream << "# Empty compiler generated dependencies file for "
+                    << this->GeneratorTarget->GetName() << ".\n"
+                    << "# This may be replaced when dependencies are built."
+                    << std::endl;
+    }
+    *this->BuildFileStream
+      << "# Include the dependencies written by the compiler.\n"
+      << this->GlobalGenerator->IncludeDirective << " "
+      << (this->Makefile->IsOn("CMAKE_MAKE_INCLUDE_FROM_ROOT")
+            ? "$(CMAKE_BINARY_DIR)/"
+            : "")
+      << cmSystemTools::ConvertToOutputPath(
+           this->LocalGenerator->MaybeConvertToRelativePath(
+             this->LocalGenerator->GetBinaryDirectory(), compilerDependFile))
+      << "\n\n";
+
+    commands.push_back(
+      "$(CMAKE_COMMAND) -E cmake_depends_compiler " +
+      this->LocalGenerator->ConvertToOutputFormat(targetDir,
+                                                  cmOutputConverter::SHELL));
+    scan = !this->LocalGenerator->GetImplicitDepends(this->GeneratorTarget)
+              .empty() ||
+      !this->MultipleOutputPairs.empty();
+  }
+
+  if (!scan) {
+    // Nothing is scanned, so previously scanned dependencies are stale.
+    cmGeneratedFileStream depFileStream(
+      this->LocalGenerator->ConvertToFullPath(dir + "/depend.make"), false,
+      this->GlobalGenerator->GetMakefileEncoding());
+    depFileStream.SetCopyIfDifferent(true);
+    depFileStream << "# Empty dependencies file for "
+                  << this->GeneratorTarget->GetName() << ".\n"
+                  << "# This may be replaced when dependencies are built."
+                  << std::endl;
+  } else if (!this->GlobalGenerator->AddBatchDependScanTarget(
+               this->GeneratorTarget)) {
+    commands.push_back(depCmd.str());
+  } else if (commands.empty()) {
+    // Targets scanned in one batch before the build need no command.
+    std::string hack = this->GlobalGenerator->GetEmptyRuleHackCommand();
+    if (!hack.empty()) {
+      commands.push_back(std::move(hack));
+    }
+  }
 
   // Make sure all custom command outputs in this target are built.
   if (this->CustomCommandDriver == OnDepends) {
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "cmCommonTargetGenerator.h"
+#include "cmDependsCompiler.h"
 #include "cmLocalUnixMakefileGenerator3.h"
 #include "cmOSXBundleGenerator.h"
 
@@ -95,6 +96,10 @@ protected:
                             cmSourceFile const& source,
                             std::vector<std::string>& depends);
 
+  // return whether compiling a source in the given language writes a
+  // dependency file used instead of scanning the source
+  bool UseCompilerDepends(const std::string& lang) const;
+
   // write the depend.make file for an object
   void WriteObjectDependRules(cmSourceFile const& source,
                               std::vector<std::string>& depends);
@@ -224,6 +229,9 @@ protected:
 
   typedef std::map<std::string, std::string> MultipleOutputPairsType;
   MultipleOutputPairsType MultipleOutputPairs;
+
+  // Dependency files written by the compiler for objects.
+  cmDependsCompiler::FileList CompilerDependFiles;
   bool WriteMakeRule(std::ostream& os, const char* comment,
                      const std::vector<std::string>& outputs,
                      const std::vector<std::string>& depends,
@@ -21,6 +21,8 @@ public:
    */
   cmCommand* Clone() override { return new cmMathCommand; }
 
+  bool IsReusable() const override { return true; }
+
   /**
    * This is called when the command is first encountered in
    * the CMakeLists.txt file.
@@ -24,6 +24,8 @@ public:
    */
   cmCommand* Clone() override { return new cmMessageCommand; }
 
+  bool IsReusable() const override { return true; }
+
   /**
    * This is called when the command is first encountered in
    * the CMakeLists.txt file.
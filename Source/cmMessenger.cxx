@@ -133,12 +133,14 @@ void displayMessage(cmake::MessageType t, std::ostringstream& msg)
 
 cmMessenger::cmMessenger(cmState* state)
   : State(state)
+  , MessageCount(0)
 {
 }
 
 void cmMessenger::IssueMessage(cmake::MessageType t, const std::string& text,
                                const cmListFileBacktrace& backtrace) const
 {
+  ++this->MessageCount;
   bool force = false;
   if (!force) {
     // override the message type, if needed, for warnings and errors
@@ -24,6 +24,9 @@ public:
   void DisplayMessage(cmake::MessageType t, std::string const& text,
                       cmListFileBacktrace const& backtrace) const;
 
+  /** Number of messages issued so far, including suppressed ones.  */
+  unsigned long GetMessageCount() const { return this->MessageCount; }
+
   bool GetSuppressDevWarnings() const;
   bool GetSuppressDeprecatedWarnings() const;
   bool GetDevWarningsAsErrors() const;
@@ -34,6 +37,7 @@ private:
   cmake::MessageType ConvertMessageType(cmake::MessageType t) const;
 
   cmState* State;
+  mutable unsigned long MessageCount;
 };
 
 #endif
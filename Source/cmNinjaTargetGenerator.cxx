@@ -544,10 +544,12 @@ void cmNinjaTargetGenerator::WriteCompileRule(const std::string& lang)
     ppComment << "Rule for preprocessing " << lang << " files.";
     std::ostringstream ppDesc;
     ppDesc << "Building " << lang << " preprocessed $out";
+    // The scanner leaves the .ddi file untouched when its content would
+    // not change, so restat to avoid re-running the dyndep collation.
     this->GetGlobalGenerator()->AddRule(
       this->LanguagePreprocessRule(lang), ppCmdLine, ppDesc.str(),
       ppComment.str(), ppDepfile, ppDeptype, ppRspFile, ppRspContent,
-      /*restat*/ "",
+      /*restat*/ needDyndep ? "1" : "",
       /*generator*/ false);
   }
 
@@ -188,7 +188,7 @@ std::string cmOutputConverter::ForceToRelativePath(
   return relative;
 }
 
-static bool cmOutputConverterIsShellOperator(const std::string& str)
+bool cmOutputConverter::IsShellOperator(const std::string& str)
 {
   static std::set<std::string> shellOperators;
   if (shellOperators.empty()) {
@@ -213,7 +213,7 @@ std::string cmOutputConverter::EscapeForShell(const std::string& str,
                                               bool useWatcomQuote) const
 {
   // Do not escape shell operators.
-  if (cmOutputConverterIsShellOperator(str)) {
+  if (IsShellOperator(str)) {
     return str;
   }
 
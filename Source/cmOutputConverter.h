@@ -79,6 +79,10 @@ public:
 
   static std::string EscapeForCMake(const std::string& str);
 
+  /** Return whether the argument is a shell operator, such as "|" or
+      "&&", that EscapeForShell leaves unquoted.  */
+  static bool IsShellOperator(const std::string& str);
+
   /** Compute an escaped version of the given argument for use in a
       windows shell.  */
   static std::string EscapeWindowsShellArgument(const char* arg,
@@ -495,6 +495,7 @@ bool cmOutputRequiredFilesCommand::InitialPass(
     std::set<cmDependInformation const*> visited;
     this->ListDependencies(info, fout, &visited);
     fclose(fout);
+    cmSystemTools::InvalidateStatCache(this->OutputFile);
   }
 
   return true;
@@ -5,6 +5,7 @@
 #include "cmsys/RegularExpression.hxx"
 #include <algorithm>
 #include <assert.h>
+#include <atomic>
 #include <string.h>
 #include <utility>
 
@@ -33,6 +34,7 @@ cmState::cmState()
 {
   this->CacheManager = new cmCacheManager;
   this->GlobVerificationManager = new cmGlobVerificationManager;
+  this->UpdateCommandsGeneration();
 }
 
 cmState::~cmState()
@@ -420,11 +422,20 @@ void cmState::SetIsGeneratorMultiConfig(bool b)
   this->IsGeneratorMultiConfig = b;
 }
 
+void cmState::UpdateCommandsGeneration()
+{
+  // Generations are drawn from a process-wide counter so that a command
+  // resolved by one instance is never taken as valid by another.
+  static std::atomic<unsigned long> lastGeneration(0);
+  this->CommandsGeneration = ++lastGeneration;
+}
+
 void cmState::AddBuiltinCommand(std::string const& name, cmCommand* command)
 {
   assert(name == cmSystemTools::LowerCase(name));
   assert(this->BuiltinCommands.find(name) == this->BuiltinCommands.end());
   this->BuiltinCommands.insert(std::make_pair(name, command));
+  this->UpdateCommandsGeneration();
 }
 
 void cmState::AddDisallowedCommand(std::string const& name, cmCommand* command,
@@ -464,6 +475,7 @@ void cmState::AddScriptedCommand(std::string const& name, cmCommand* command)
     this->ScriptedCommands.erase(pos);
   }
   this->ScriptedCommands.insert(std::make_pair(sName, command));
+  this->UpdateCommandsGeneration();
 }
 
 cmCommand* cmState::GetCommand(std::string const& name) const
@@ -510,12 +522,14 @@ void cmState::RemoveBuiltinCommand(std::string const& name)
   assert(i != this->BuiltinCommands.end());
   delete i->second;
   this->BuiltinCommands.erase(i);
+  this->UpdateCommandsGeneration();
 }
 
 void cmState::RemoveUserDefinedCommands()
 {
   cmDeleteAll(this->ScriptedCommands);
   this->ScriptedCommands.clear();
+  this->UpdateCommandsGeneration();
 }
 
 void cmState::SetGlobalProperty(const std::string& prop, const char* value)
@@ -137,6 +137,13 @@ public:
   void AddScriptedCommand(std::string const& name, cmCommand* command);
   void RemoveBuiltinCommand(std::string const& name);
   void RemoveUserDefinedCommands();
+  /** Identify the current set of commands.  The value changes whenever
+      a command is added or removed, and is never shared by two cmState
+      instances.  */
+  unsigned long GetCommandsGeneration() const
+  {
+    return this->CommandsGeneration;
+  }
   std::vector<std::string> GetCommandNames() const;
 
   void SetGlobalProperty(const std::string& prop, const char* value);
@@ -187,6 +194,8 @@ private:
   std::vector<std::string> EnabledLanguages;
   std::map<std::string, cmCommand*> BuiltinCommands;
   std::map<std::string, cmCommand*> ScriptedCommands;
+  unsigned long CommandsGeneration;
+  void UpdateCommandsGeneration();
   cmPropertyMap GlobalProperties;
   cmCacheManager* CacheManager;
   cmGlobVerificationManager* GlobVerificationManager;
@@ -211,6 +211,14 @@ std::string const* cmStateSnapshot::GetDefinition(
   return cmDefinitions::Get(name, this->Position->Vars, this->Position->Root);
 }
 
+std::string const* cmStateSnapshot::GetDefinitionList(
+  std::string const& name, cmListElements const*& elements) const
+{
+  assert(this->Position->Vars.IsValid());
+  return cmDefinitions::GetList(name, this->Position->Vars,
+                                this->Position->Root, elements);
+}
+
 bool cmStateSnapshot::IsInitialized(std::string const& name) const
 {
   return cmDefinitions::HasKey(name, this->Position->Vars,
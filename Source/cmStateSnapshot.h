@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "cmLinkedTree.h"
+#include "cmListElement.h"
 #include "cmPolicies.h"
 #include "cmStateTypes.h"
 
@@ -23,6 +24,8 @@ public:
   cmStateSnapshot(cmState* state, cmStateDetail::PositionType position);
 
   std::string const* GetDefinition(std::string const& name) const;
+  std::string const* GetDefinitionList(std::string const& name,
+                                       cmListElements const*& elements) const;
   bool IsInitialized(std::string const& name) const;
   void SetDefinition(std::string const& name, std::string const& value);
   void RemoveDefinition(std::string const& name);
@@ -43,6 +43,8 @@
 #include <ctype.h>
 #include <errno.h>
 #include <iostream>
+#include <map>
+#include <set>
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -50,6 +52,10 @@
 #include <time.h>
 #include <utility>
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#  include <mutex>
+#endif
+
 #if defined(_WIN32)
 #  include <windows.h>
 // include wincrypt.h after windows.h
@@ -738,6 +744,10 @@ bool cmSystemTools::RunSingleCommand(std::vector<std::string> const& command,
                                      const char* dir, OutputOption outputflag,
                                      cmDuration timeout, Encoding encoding)
 {
+  // The command may change any file, so do not trust cached results.
+  cmSystemTools::StatCacheBypass statCacheBypass;
+  static_cast<void>(statCacheBypass);
+
   std::vector<const char*> argv;
   argv.reserve(command.size() + 1);
   for (std::string const& cmd : command) {
@@ -943,13 +953,15 @@ std::string cmSystemTools::FileExistsInParentDirectories(const char* fname,
 
 bool cmSystemTools::cmCopyFile(const char* source, const char* destination)
 {
-  return Superclass::CopyFileAlways(source, destination);
+  return cmSystemTools::CopyFileAlways(source, destination);
 }
 
 bool cmSystemTools::CopyFileIfDifferent(const char* source,
                                         const char* destination)
 {
-  return Superclass::CopyFileIfDifferent(source, destination);
+  bool const result = Superclass::CopyFileIfDifferent(source, destination);
+  cmSystemTools::InvalidateStatCache(destination);
+  return result;
 }
 
 #ifdef _WIN32
@@ -1036,8 +1048,404 @@ void cmSystemTools::InitializeLibUV()
 #endif
 }
 
+namespace {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+/** Results of file system queries by path.  Unknown results are -1.  */
+struct cmStatCacheEntry
+{
+  signed char Exists = -1;
+  signed char IsDirectory = -1;
+  bool HaveRealPath = false;
+  std::string RealPath;
+};
+
+struct cmStatCache
+{
+  std::mutex Mutex;
+  bool Enabled = false;
+  // Incremented on every invalidation so that a query racing with a
+  // modification on another thread does not store a stale result.
+  unsigned long Generation = 1;
+  std::map<std::string, cmStatCacheEntry> Entries;
+  // Keys that are not in normal form and so may name a modified path
+  // without sharing its spelling.  They are dropped on every change.
+  std::set<std::string> IrregularKeys;
+  cmSystemTools::StatCacheStatistics Statistics = { 0, 0 };
+
+  static cmStatCache& Instance()
+  {
+    static cmStatCache instance;
+    return instance;
+  }
+
+  // Look up the entry for a path while holding the lock.  Returns null
+  // if the cache does not apply to the path.
+  cmStatCacheEntry* Find(std::string const& path)
+  {
+    if (!this->Enabled || !cmSystemTools::FileIsFullPath(path)) {
+      return nullptr;
+    }
+    ++this->Statistics.Lookups;
+    std::map<std::string, cmStatCacheEntry>::iterator i =
+      this->Entries.find(path);
+    if (i == this->Entries.end()) {
+      return nullptr;
+    }
+    return &i->second;
+  }
+
+  // Store a result computed without the lock, unless the cache was
+  // invalidated or disabled since the lookup began.
+  cmStatCacheEntry* Store(std::string const& path, unsigned long generation)
+  {
+    if (!this->Enabled || generation != this->Generation) {
+      return nullptr;
+    }
+    if (path.find("/.") != std::string::npos ||
+        path.find("//") != std::string::npos ||
+        path.find('\\') != std::string::npos) {
+      this->IrregularKeys.insert(path);
+    }
+    return &this->Entries[path];
+  }
+
+  void Invalidate(std::string path)
+  {
+    ++this->Generation;
+    if (this->Entries.empty()) {
+      return;
+    }
+    for (std::string const& key : this->IrregularKeys) {
+      this->Entries.erase(key);
+    }
+    this->IrregularKeys.clear();
+
+    while (path.size() > 1 && path.back() == '/') {
+      path.pop_back();
+    }
+    // Drop everything inside the path, e.g. after removing a directory.
+    std::string const prefix = path + "/";
+    std::map<std::string, cmStatCacheEntry>::iterator i =
+      this->Entries.lower_bound(prefix);
+    while (i != this->Entries.end() &&
+           i->first.compare(0, prefix.size(), prefix) == 0) {
+      i = this->Entries.erase(i);
+    }
+    // Drop the path and its parents, which may have been created.
+    for (;;) {
+      this->Entries.erase(path);
+      this->Entries.erase(path + "/");
+      std::string parent = cmSystemTools::GetFilenamePath(path);
+      if (parent.empty() || parent == path) {
+        break;
+      }
+      path.swap(parent);
+    }
+  }
+};
+#endif
+
+/** Drop the cached results of both paths when a rename completes.  */
+class cmStatCacheRenameGuard
+{
+public:
+  cmStatCacheRenameGuard(const char* oldname, const char* newname)
+    : OldName(oldname)
+    , NewName(newname)
+  {
+  }
+  ~cmStatCacheRenameGuard()
+  {
+    cmSystemTools::InvalidateStatCache(this->OldName);
+    cmSystemTools::InvalidateStatCache(this->NewName);
+  }
+
+private:
+  const char* OldName;
+  const char* NewName;
+};
+}
+
+bool cmSystemTools::FileExists(const char* filename)
+{
+  if (!filename) {
+    return false;
+  }
+  return cmSystemTools::FileExists(std::string(filename));
+}
+
+bool cmSystemTools::FileExists(const std::string& filename)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmStatCache& cache = cmStatCache::Instance();
+  unsigned long generation;
+  {
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    cmStatCacheEntry* entry = cache.Find(filename);
+    if (entry && entry->Exists >= 0) {
+      ++cache.Statistics.Hits;
+      return entry->Exists != 0;
+    }
+    generation = cache.Generation;
+  }
+  bool const exists = Superclass::FileExists(filename);
+  {
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    if (cmStatCacheEntry* entry = cache.Store(filename, generation)) {
+      entry->Exists = exists ? 1 : 0;
+    }
+  }
+  return exists;
+#else
+  return Superclass::FileExists(filename);
+#endif
+}
+
+bool cmSystemTools::FileExists(const char* filename, bool isFile)
+{
+  if (!filename) {
+    return false;
+  }
+  return cmSystemTools::FileExists(std::string(filename), isFile);
+}
+
+bool cmSystemTools::FileExists(const std::string& filename, bool isFile)
+{
+  if (cmSystemTools::FileExists(filename)) {
+    // If isFile is set return not FileIsDirectory,
+    // so this will only be true if it is a file
+    return !isFile || !cmSystemTools::FileIsDirectory(filename);
+  }
+  return false;
+}
+
+bool cmSystemTools::FileIsDirectory(const std::string& name)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmStatCache& cache = cmStatCache::Instance();
+  unsigned long generation;
+  {
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    cmStatCacheEntry* entry = cache.Find(name);
+    if (entry && entry->IsDirectory >= 0) {
+      ++cache.Statistics.Hits;
+      return entry->IsDirectory != 0;
+    }
+    generation = cache.Generation;
+  }
+  bool const isDirectory = Superclass::FileIsDirectory(name);
+  {
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    if (cmStatCacheEntry* entry = cache.Store(name, generation)) {
+      entry->IsDirectory = isDirectory ? 1 : 0;
+    }
+  }
+  return isDirectory;
+#else
+  return Superclass::FileIsDirectory(name);
+#endif
+}
+
+std::string cmSystemTools::GetRealPath(const std::string& path,
+                                       std::string* errorMessage)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmStatCache& cache = cmStatCache::Instance();
+  unsigned long generation;
+  {
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    cmStatCacheEntry* entry = cache.Find(path);
+    if (entry && entry->HaveRealPath) {
+      ++cache.Statistics.Hits;
+      return entry->RealPath;
+    }
+    generation = cache.Generation;
+  }
+  std::string error;
+  std::string const realPath = Superclass::GetRealPath(path, &error);
+  if (!error.empty()) {
+    // Failures are not cached so that the error is reported each time.
+    // Without a place to report it the path is returned unchanged.
+    if (!errorMessage) {
+      return path;
+    }
+    *errorMessage = error;
+    return realPath;
+  }
+  {
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    if (cmStatCacheEntry* entry = cache.Store(path, generation)) {
+      entry->HaveRealPath = true;
+      entry->RealPath = realPath;
+    }
+  }
+  return realPath;
+#else
+  return Superclass::GetRealPath(path, errorMessage);
+#endif
+}
+
+bool cmSystemTools::MakeDirectory(const char* path, const mode_t* mode)
+{
+  if (!path) {
+    return false;
+  }
+  return cmSystemTools::MakeDirectory(std::string(path), mode);
+}
+
+bool cmSystemTools::MakeDirectory(const std::string& path,
+                                  const mode_t* mode)
+{
+  bool const result = Superclass::MakeDirectory(path, mode);
+  cmSystemTools::InvalidateStatCache(path);
+  return result;
+}
+
+bool cmSystemTools::CopyFileIfDifferent(const std::string& source,
+                                        const std::string& destination)
+{
+  bool const result = Superclass::CopyFileIfDifferent(source, destination);
+  cmSystemTools::InvalidateStatCache(destination);
+  return result;
+}
+
+bool cmSystemTools::CopyFileAlways(const std::string& source,
+                                   const std::string& destination)
+{
+  bool const result = Superclass::CopyFileAlways(source, destination);
+  cmSystemTools::InvalidateStatCache(destination);
+  return result;
+}
+
+bool cmSystemTools::CopyAFile(const std::string& source,
+                              const std::string& destination, bool always)
+{
+  bool const result = Superclass::CopyAFile(source, destination, always);
+  cmSystemTools::InvalidateStatCache(destination);
+  return result;
+}
+
+bool cmSystemTools::RemoveFile(const std::string& source)
+{
+  bool const result = Superclass::RemoveFile(source);
+  cmSystemTools::InvalidateStatCache(source);
+  return result;
+}
+
+bool cmSystemTools::RemoveADirectory(const std::string& source)
+{
+  bool const result = Superclass::RemoveADirectory(source);
+  cmSystemTools::InvalidateStatCache(source);
+  return result;
+}
+
+bool cmSystemTools::Touch(const std::string& filename, bool create)
+{
+  bool const result = Superclass::Touch(filename, create);
+  cmSystemTools::InvalidateStatCache(filename);
+  return result;
+}
+
+void cmSystemTools::SetStatCacheEnabled(bool enable)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmStatCache& cache = cmStatCache::Instance();
+  std::lock_guard<std::mutex> lock(cache.Mutex);
+  cache.Enabled = enable;
+  ++cache.Generation;
+  cache.Entries.clear();
+  cache.IrregularKeys.clear();
+#else
+  static_cast<void>(enable);
+#endif
+}
+
+bool cmSystemTools::GetStatCacheEnabled()
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmStatCache& cache = cmStatCache::Instance();
+  std::lock_guard<std::mutex> lock(cache.Mutex);
+  return cache.Enabled;
+#else
+  return false;
+#endif
+}
+
+void cmSystemTools::InvalidateStatCache(std::string const& path)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmStatCache& cache = cmStatCache::Instance();
+  std::lock_guard<std::mutex> lock(cache.Mutex);
+  cache.Invalidate(path);
+#else
+  static_cast<void>(path);
+#endif
+}
+
+void cmSystemTools::InvalidateStatCache()
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmStatCache& cache = cmStatCache::Instance();
+  std::lock_guard<std::mutex> lock(cache.Mutex);
+  ++cache.Generation;
+  cache.Entries.clear();
+  cache.IrregularKeys.clear();
+#endif
+}
+
+cmSystemTools::StatCacheStatistics cmSystemTools::GetStatCacheStatistics()
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmStatCache& cache = cmStatCache::Instance();
+  std::lock_guard<std::mutex> lock(cache.Mutex);
+  return cache.Statistics;
+#else
+  StatCacheStatistics const none = { 0, 0 };
+  return none;
+#endif
+}
+
+unsigned long cmSystemTools::GetStatCacheGeneration()
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmStatCache& cache = cmStatCache::Instance();
+  std::lock_guard<std::mutex> lock(cache.Mutex);
+  return cache.Enabled ? cache.Generation : 0;
+#else
+  return 0;
+#endif
+}
+
+void cmSystemTools::ResetStatCacheStatistics()
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmStatCache& cache = cmStatCache::Instance();
+  std::lock_guard<std::mutex> lock(cache.Mutex);
+  cache.Statistics.Lookups = 0;
+  cache.Statistics.Hits = 0;
+#endif
+}
+
+cmSystemTools::StatCacheBypass::StatCacheBypass(bool bypass)
+  : WasEnabled(bypass && cmSystemTools::GetStatCacheEnabled())
+{
+  if (this->WasEnabled) {
+    cmSystemTools::SetStatCacheEnabled(false);
+  }
+}
+
+cmSystemTools::StatCacheBypass::~StatCacheBypass()
+{
+  if (this->WasEnabled) {
+    cmSystemTools::SetStatCacheEnabled(true);
+  }
+}
+
 bool cmSystemTools::RenameFile(const char* oldname, const char* newname)
 {
+  // Forget the cached results for both names however the rename ends.
+  cmStatCacheRenameGuard guard(oldname, newname);
+  static_cast<void>(guard);
 #ifdef _WIN32
 #  ifndef INVALID_FILE_ATTRIBUTES
 #    define INVALID_FILE_ATTRIBUTES ((DWORD)-1)
@@ -1296,6 +1704,73 @@ void cmSystemTools::ExpandListArgument(const std::string& arg,
   }
 }
 
+void cmSystemTools::ExpandListElements(const std::string& arg,
+                                       cmListElements& elementsOut)
+{
+  // Break the string at non-escaped semicolons not nested in [], as
+  // ExpandListArgument does.
+  cmListElement element = { 0, 0, false };
+  int squareNesting = 0;
+  size_t const n = arg.size();
+  for (size_t i = 0; i < n; ++i) {
+    switch (arg[i]) {
+      case '\\':
+        if (i + 1 < n && arg[i + 1] == ';') {
+          element.Escaped = true;
+          ++i;
+        }
+        break;
+      case '[':
+        ++squareNesting;
+        break;
+      case ']':
+        --squareNesting;
+        break;
+      case ';':
+        if (squareNesting == 0) {
+          element.Length = i - element.Begin;
+          elementsOut.push_back(element);
+          element.Begin = i + 1;
+          element.Escaped = false;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  element.Length = n - element.Begin;
+  elementsOut.push_back(element);
+}
+
+std::string cmSystemTools::GetListElement(const std::string& arg,
+                                          cmListElement const& element)
+{
+  if (!element.Escaped) {
+    return arg.substr(element.Begin, element.Length);
+  }
+  std::string value;
+  value.reserve(element.Length);
+  size_t const end = element.Begin + element.Length;
+  for (size_t i = element.Begin; i < end; ++i) {
+    if (arg[i] == '\\' && i + 1 < end && arg[i + 1] == ';') {
+      continue;
+    }
+    value += arg[i];
+  }
+  return value;
+}
+
+bool cmSystemTools::ListElementEquals(const std::string& arg,
+                                      cmListElement const& element,
+                                      const std::string& value)
+{
+  if (!element.Escaped) {
+    return element.Length == value.size() &&
+      arg.compare(element.Begin, element.Length, value) == 0;
+  }
+  return cmSystemTools::GetListElement(arg, element) == value;
+}
+
 bool cmSystemTools::SimpleGlob(const std::string& glob,
                                std::vector<std::string>& files,
                                int type /* = 0 */)
@@ -1575,7 +2050,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
                               const std::vector<std::string>& files,
                               cmTarCompression compressType, bool verbose,
                               std::string const& mtime,
-                              std::string const& format)
+                              std::string const& format, int threads)
 {
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   std::string cwd = cmSystemTools::GetCurrentWorkingDirectory();
@@ -1604,7 +2079,8 @@ bool cmSystemTools::CreateTar(const char* outFileName,
       break;
   }
 
-  cmArchiveWrite a(fout, compress, format.empty() ? "paxr" : format);
+  cmArchiveWrite a(fout, compress, format.empty() ? "paxr" : format,
+                   threads);
 
   a.SetMTime(mtime);
   a.SetVerbose(verbose);
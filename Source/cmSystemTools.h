@@ -7,6 +7,7 @@
 
 #include "cmCryptoHash.h"
 #include "cmDuration.h"
+#include "cmListElement.h"
 #include "cmProcessOutput.h"
 #include "cmsys/Process.h"
 #include "cmsys/SystemTools.hxx" // IWYU pragma: export
@@ -38,6 +39,18 @@ public:
                                  std::vector<std::string>& argsOut,
                                  bool emptyArgs = false);
 
+  /** Find the elements of a ;-separated list, keeping empty elements,
+   *  as ExpandListArgument does with emptyArgs.  No string is allocated
+   *  for the elements.
+   */
+  static void ExpandListElements(const std::string& arg,
+                                 cmListElements& elementsOut);
+  static std::string GetListElement(const std::string& arg,
+                                    cmListElement const& element);
+  static bool ListElementEquals(const std::string& arg,
+                                cmListElement const& element,
+                                const std::string& value);
+
   /**
    * Look for and replace registry values in a string
    */
@@ -183,6 +196,82 @@ public:
       if possible).  */
   static bool RenameFile(const char* oldname, const char* newname);
 
+  /**
+   * Variants of the cmsys::SystemTools file system queries that consult
+   * the stat cache.  While the cache is enabled the results for full
+   * paths are remembered until CMake modifies the path or the cache is
+   * flushed.
+   */
+  static bool FileExists(const char* filename);
+  static bool FileExists(const std::string& filename);
+  static bool FileExists(const char* filename, bool isFile);
+  static bool FileExists(const std::string& filename, bool isFile);
+  static bool FileIsDirectory(const std::string& name);
+  static std::string GetRealPath(const std::string& path,
+                                 std::string* errorMessage = nullptr);
+
+  /**
+   * Variants of the cmsys::SystemTools file system modifications that
+   * drop the stat cache entries of the paths they change.
+   */
+  static bool MakeDirectory(const char* path, const mode_t* mode = nullptr);
+  static bool MakeDirectory(const std::string& path,
+                            const mode_t* mode = nullptr);
+  static bool CopyFileIfDifferent(const std::string& source,
+                                  const std::string& destination);
+  static bool CopyFileAlways(const std::string& source,
+                             const std::string& destination);
+  static bool CopyAFile(const std::string& source,
+                        const std::string& destination, bool always = true);
+  static bool RemoveFile(const std::string& source);
+  static bool RemoveADirectory(const std::string& source);
+  static bool Touch(const std::string& filename, bool create);
+
+  /**
+   * Enable or disable the process-wide stat cache.  Either way the
+   * cached results are discarded.
+   */
+  static void SetStatCacheEnabled(bool enable);
+  static bool GetStatCacheEnabled();
+
+  /** Drop the cached results for a path, its parents and its contents. */
+  static void InvalidateStatCache(std::string const& path);
+  /** Drop all cached results.  */
+  static void InvalidateStatCache();
+
+  struct StatCacheStatistics
+  {
+    size_t Lookups;
+    size_t Hits;
+  };
+  static StatCacheStatistics GetStatCacheStatistics();
+
+  /**
+   * Get a number that changes whenever cached results are dropped, or 0
+   * if the cache is disabled.  Results derived from the file system may
+   * be kept until it changes.
+   */
+  static unsigned long GetStatCacheGeneration();
+  static void ResetStatCacheStatistics();
+
+  /**
+   * Bypass the stat cache while in scope and flush it afterwards.  Used
+   * around operations that may change the file system in ways CMake
+   * does not track, such as running processes.
+   */
+  class StatCacheBypass
+  {
+  public:
+    explicit StatCacheBypass(bool bypass = true);
+    ~StatCacheBypass();
+
+    StatCacheBypass(StatCacheBypass const&) = delete;
+    StatCacheBypass& operator=(StatCacheBypass const&) = delete;
+
+  private:
+    bool WasEnabled;
+  };
+
   ///! Compute the hash of a file
   static std::string ComputeFileHash(const std::string& source,
                                      cmCryptoHash::Algo algo);
@@ -424,7 +513,8 @@ public:
                         const std::vector<std::string>& files,
                         cmTarCompression compressType, bool verbose,
                         std::string const& mtime = std::string(),
-                        std::string const& format = std::string());
+                        std::string const& format = std::string(),
+                        int threads = 1);
   static bool ExtractTar(const char* inFileName, bool verbose);
   // This should be called first thing in main
   // it will keep child processes from inheriting the
@@ -927,6 +927,7 @@ void cmTarget::SetProperty(const std::string& prop, const char* value)
         this->Makefile->GetBacktrace())) {
     return;
   }
+  cmGeneratorExpression::InvalidateEvaluationCache();
 #define MAKE_STATIC_PROP(PROP) static const std::string prop##PROP = #PROP
   MAKE_STATIC_PROP(COMPILE_DEFINITIONS);
   MAKE_STATIC_PROP(COMPILE_FEATURES);
@@ -1084,6 +1085,7 @@ void cmTarget::AppendProperty(const std::string& prop, const char* value,
         this->Makefile->GetBacktrace())) {
     return;
   }
+  cmGeneratorExpression::InvalidateEvaluationCache();
   if (prop == "NAME") {
     std::ostringstream e;
     e << "NAME property is read-only\n";
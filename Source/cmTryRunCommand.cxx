@@ -341,6 +341,7 @@ void cmTryRunCommand::DoNotRunExecutable(const std::string& runArgs,
              << "\"\n     CACHE STRING \"Output from TRY_RUN\" FORCE)\n\n";
       }
       file.close();
+      cmSystemTools::InvalidateStatCache(resultFileName);
     }
     firstTryRun = false;
 
@@ -41,6 +41,8 @@ public:
    */
   cmCommand* Clone() override { return new cmWhileCommand; }
 
+  bool IsReusable() const override { return true; }
+
   /**
    * This overrides the default InvokeInitialPass implementation.
    * It records the arguments before expansion.
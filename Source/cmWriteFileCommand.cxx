@@ -73,6 +73,7 @@ bool cmWriteFileCommand::InitialPass(std::vector<std::string> const& args,
   }
   file << message << std::endl;
   file.close();
+  cmSystemTools::InvalidateStatCache(fileName);
   if (mode && !writable) {
     cmSystemTools::SetPermissions(fileName.c_str(), mode);
   }
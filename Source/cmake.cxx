@@ -10,6 +10,7 @@
 #include "cmDuration.h"
 #include "cmExternalMakefileProjectGenerator.h"
 #include "cmFileTimeComparison.h"
+#include "cmGeneratorExpression.h"
 #include "cmGeneratorTarget.h"
 #include "cmGlobalGenerator.h"
 #include "cmGlobalGeneratorFactory.h"
@@ -31,6 +32,7 @@
 #  include "cm_jsoncpp_writer.h"
 
 #  include "cmGraphVizWriter.h"
+#  include "cmMakefileProfilingData.h"
 #  include "cmVariableWatch.h"
 #  include <unordered_map>
 #endif
@@ -137,6 +139,7 @@ cmake::cmake(Role role)
   this->DebugTryCompile = false;
   this->ClearBuildSystem = false;
   this->FileComparison = new cmFileTimeComparison;
+  this->ListFileCache = nullptr;
 
   this->State = new cmState;
   this->CurrentSnapshot = this->State->CreateBaseSnapshot();
@@ -711,6 +714,18 @@ void cmake::SetArgs(const std::vector<std::string>& args,
       cmSystemTools::ConvertToUnixSlashes(file);
       this->AddTraceSource(file);
       this->SetTrace(true);
+    } else if (arg.find("--profiling-output=", 0) == 0) {
+      std::string path = arg.substr(strlen("--profiling-output="));
+      this->ProfilingOutputFile = cmSystemTools::CollapseFullPath(path);
+      if (path.empty()) {
+        cmSystemTools::Error("No file specified for --profiling-output");
+      }
+    } else if (arg.find("--profiling-summary=", 0) == 0) {
+      std::string path = arg.substr(strlen("--profiling-summary="));
+      this->ProfilingSummaryFile = cmSystemTools::CollapseFullPath(path);
+      if (path.empty()) {
+        cmSystemTools::Error("No file specified for --profiling-summary");
+      }
     } else if (arg.find("--trace", 0) == 0) {
       std::cout << "Running with trace output on.\n";
       this->SetTrace(true);
@@ -1428,8 +1443,25 @@ int cmake::ActualConfigure()
     this->TruncateOutputLog("CMakeError.log");
   }
 
+  // Reuse list files parsed by previous runs in this build tree.
+  // The project of a try_compile is thrown away so do not bother.
+  std::string listFileCacheFile;
+  if (!this->State->GetIsInTryCompile()) {
+    listFileCacheFile = this->GetHomeOutputDirectory();
+    listFileCacheFile += cmake::GetCMakeFilesDirectory();
+    listFileCacheFile += "/ListFileCache.bin";
+    this->ListFileCache = new cmListFileCache;
+    this->ListFileCache->Load(listFileCacheFile);
+  }
+
   // actually do the configure
   this->GlobalGenerator->Configure();
+
+  if (this->ListFileCache) {
+    this->ListFileCache->Save(listFileCacheFile);
+    delete this->ListFileCache;
+    this->ListFileCache = nullptr;
+  }
   // Before saving the cache
   // if the project did not define one of the entries below, add them now
   // so users can edit the values in the cache:
@@ -1561,6 +1593,16 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
     return -1;
   }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Start profiling before any CMake code runs.  The results are written
+  // when this instance is destroyed.
+  if (!this->ProfilingOutputFile.empty() ||
+      !this->ProfilingSummaryFile.empty()) {
+    this->ProfilingOutput = cm::make_unique<cmMakefileProfilingData>(
+      this->ProfilingOutputFile, this->ProfilingSummaryFile);
+  }
+#endif
+
   // If we are given a stamp list file check if it is really out of date.
   if (!this->CheckStampList.empty() &&
       cmakeCheckStampList(this->CheckStampList.c_str())) {
@@ -1618,8 +1660,21 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
     return 0;
   }
 
-  int ret = this->Configure();
+  // Configure and generate query the same files many times, so cache
+  // the results.  CMake itself drops them when it modifies a file.
+  cmSystemTools::ResetStatCacheStatistics();
+  cmSystemTools::SetStatCacheEnabled(true);
+  int ret;
+  {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    cmMakefileProfilingData::RAII profilingScope(this->GetProfilingOutput(),
+                                                 "configure");
+    static_cast<void>(profilingScope);
+#endif
+    ret = this->Configure();
+  }
   if (ret) {
+    cmSystemTools::SetStatCacheEnabled(false);
 #if defined(CMAKE_HAVE_VS_GENERATORS)
     if (!this->VSSolutionFile.empty() && this->GlobalGenerator) {
       // CMake is running to regenerate a Visual Studio build tree
@@ -1636,7 +1691,21 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
 #endif
     return ret;
   }
-  ret = this->Generate();
+  {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    cmMakefileProfilingData::RAII profilingScope(this->GetProfilingOutput(),
+                                                 "generate");
+    static_cast<void>(profilingScope);
+#endif
+    ret = this->Generate();
+  }
+  cmSystemTools::SetStatCacheEnabled(false);
+  if (this->GetDebugOutput()) {
+    cmSystemTools::StatCacheStatistics const stats =
+      cmSystemTools::GetStatCacheStatistics();
+    std::cout << "File system query cache: " << stats.Lookups
+              << " lookups, " << stats.Hits << " hits" << std::endl;
+  }
   std::string message = "Build files have been written to: ";
   message += this->GetHomeOutputDirectory();
   this->UpdateProgress(message.c_str(), -1);
@@ -1651,7 +1720,18 @@ int cmake::Generate()
   if (!this->GlobalGenerator->Compute()) {
     return -1;
   }
+  cmGeneratorExpression::ResetEvaluationStatistics();
+  cmGeneratorExpression::SetEvaluationCacheEnabled(true);
   this->GlobalGenerator->Generate();
+  cmGeneratorExpression::SetEvaluationCacheEnabled(false);
+  if (this->GetDebugOutput()) {
+    cmGeneratorExpression::EvaluationStatistics const& stats =
+      cmGeneratorExpression::GetEvaluationStatistics();
+    std::cout << "Generator expression evaluation: " << stats.Evaluations
+              << " evaluations, " << stats.CacheHits << " cache hits, "
+              << stats.CacheMisses << " cache misses, " << stats.Seconds
+              << " seconds" << std::endl;
+  }
   if (!this->GraphVizFile.empty()) {
     std::cout << "Generate graphviz: " << this->GraphVizFile << std::endl;
     this->GenerateGraphViz(this->GraphVizFile.c_str());
@@ -6,6 +6,7 @@
 #include "cmConfigure.h" // IWYU pragma: keep
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <unordered_set>
@@ -25,6 +26,7 @@ class cmFileTimeComparison;
 class cmGlobalGenerator;
 class cmGlobalGeneratorFactory;
 class cmMakefile;
+class cmMakefileProfilingData;
 class cmMessenger;
 class cmState;
 class cmVariableWatch;
@@ -343,6 +345,12 @@ public:
    */
   cmFileTimeComparison* GetFileComparison() { return this->FileComparison; }
 
+  /**
+   * Get the persistent cache of parsed list files, if one is in use
+   * by the current configure step.
+   */
+  cmListFileCache* GetListFileCache() { return this->ListFileCache; }
+
   // Do we want debug output during the cmake run.
   bool GetDebugOutput() { return this->DebugOutput; }
   void SetDebugOutputOn(bool b) { this->DebugOutput = b; }
@@ -360,6 +368,17 @@ public:
   {
     return this->TraceOnlyThisSources;
   }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  /**
+   * Get the profiler recording command execution times, or null if
+   * profiling was not requested.
+   */
+  cmMakefileProfilingData* GetProfilingOutput()
+  {
+    return this->ProfilingOutput.get();
+  }
+#endif
+
   bool GetWarnUninitialized() { return this->WarnUninitialized; }
   void SetWarnUninitialized(bool b) { this->WarnUninitialized = b; }
   bool GetWarnUnused() { return this->WarnUnused; }
@@ -523,11 +542,15 @@ private:
   bool ClearBuildSystem;
   bool DebugTryCompile;
   cmFileTimeComparison* FileComparison;
+  cmListFileCache* ListFileCache;
   std::string GraphVizFile;
+  std::string ProfilingOutputFile;
+  std::string ProfilingSummaryFile;
   InstalledFilesMap InstalledFiles;
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   cmVariableWatch* VariableWatch;
+  std::unique_ptr<cmMakefileProfilingData> ProfilingOutput;
 #endif
 
   cmState* State;
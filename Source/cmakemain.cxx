@@ -91,6 +91,12 @@ static const char* cmDocumentationOptions[][2] = {
   { "--trace-expand", "Put cmake in trace mode with variable expansion." },
   { "--trace-source=<file>",
     "Trace only this CMake file/module. Multiple options allowed." },
+  { "--profiling-output=<file>",
+    "Write the time spent in each command to <file> in the "
+    "Chrome trace event format." },
+  { "--profiling-summary=<file>",
+    "Write the total time spent per command and per listfile to "
+    "<file>." },
   { "--warn-uninitialized", "Warn about uninitialized values." },
   { "--warn-unused-vars", "Warn about unused variables." },
   { "--no-warn-unused-cli", "Don't warn about command line options." },
@@ -108,6 +114,13 @@ static int do_command(int ac, char const* const* av)
   args.reserve(ac - 1);
   args.push_back(av[0]);
   args.insert(args.end(), av + 2, av + ac);
+
+  // Skip the lookup of the resources of cmake, such as its modules and
+  // the other tools, for commands that work on files only.  These run
+  // many times during a build.
+  if (cmcmd::NeedsResources(args)) {
+    cmSystemTools::FindCMakeResources(av[0]);
+  }
   return cmcmd::ExecuteCMakeCommand(args);
 }
 
@@ -184,6 +197,9 @@ int main(int ac, char const* const* av)
 
   cmSystemTools::EnableMSVCDebugHook();
   cmSystemTools::InitializeLibUV();
+  if (ac > 1 && strcmp(av[1], "-E") == 0) {
+    return do_command(ac, av);
+  }
   cmSystemTools::FindCMakeResources(av[0]);
   if (ac > 1) {
     if (strcmp(av[1], "--build") == 0) {
@@ -192,9 +208,6 @@ int main(int ac, char const* const* av)
     if (strcmp(av[1], "--open") == 0) {
       return do_open(ac, av);
     }
-    if (strcmp(av[1], "-E") == 0) {
-      return do_command(ac, av);
-    }
   }
   int ret = do_cmake(ac, av);
 #ifdef CMAKE_BUILD_WITH_CMAKE
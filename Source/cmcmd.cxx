@@ -3,6 +3,7 @@
 #include "cmcmd.h"
 
 #include "cmAlgorithms.h"
+#include "cmDependsCompiler.h"
 #include "cmDuration.h"
 #include "cmGlobalGenerator.h"
 #include "cmLocalGenerator.h"
@@ -455,6 +456,102 @@ int cmcmd::HandleCoCompileCommands(std::vector<std::string>& args)
   return ret;
 }
 
+bool cmcmd::SplitSequence(std::vector<std::string> const& args,
+                          std::vector<std::vector<std::string>>& steps)
+{
+  // Signature:
+  //
+  //   -E __run_sequence -E <command> [args...] [-E <command> [args...]]...
+  if (args.size() < 4 || args[2] != "-E") {
+    return false;
+  }
+  for (auto a = args.begin() + 2; a != args.end(); ++a) {
+    if (*a == "-E") {
+      steps.emplace_back(1, args[0]);
+    } else {
+      steps.back().push_back(*a);
+    }
+  }
+  for (std::vector<std::string> const& step : steps) {
+    if (step.size() < 2 || step[1] == "__run_sequence") {
+      return false;
+    }
+  }
+  return true;
+}
+
+int cmcmd::RunSequence(std::vector<std::string> const& args)
+{
+  std::vector<std::vector<std::string>> steps;
+  if (!cmcmd::SplitSequence(args, steps)) {
+    std::cerr << "__run_sequence Usage: -E __run_sequence "
+                 "-E <command> [args...] [-E <command> [args...]]...\n";
+    return 1;
+  }
+
+  // Stop at the first command that fails, like the shell would.
+  for (std::vector<std::string>& step : steps) {
+    int const ret = cmcmd::ExecuteCMakeCommand(step);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  return 0;
+}
+
+bool cmcmd::NeedsResources(std::vector<std::string> const& args)
+{
+  // Commands that work on files or print text need nothing else.
+  static const char* const commands[] = {
+    "cmake_depends_compiler",
+    "cmake_echo_color",
+    "cmake_progress_report",
+    "cmake_progress_start",
+    "cmake_symlink_executable",
+    "cmake_symlink_library",
+    "compare_files",
+    "copy",
+    "copy_directory",
+    "copy_if_different",
+    "create_symlink",
+    "echo",
+    "echo_append",
+    "make_directory",
+    "md5sum",
+    "remove",
+    "remove_directory",
+    "rename",
+    "sha1sum",
+    "sha224sum",
+    "sha256sum",
+    "sha384sum",
+    "sha512sum",
+    "touch",
+    "touch_nocreate"
+  };
+  if (args.size() < 2) {
+    return true;
+  }
+  if (args[1] == "__run_sequence") {
+    std::vector<std::vector<std::string>> steps;
+    if (!cmcmd::SplitSequence(args, steps)) {
+      return false;
+    }
+    for (std::vector<std::string> const& step : steps) {
+      if (cmcmd::NeedsResources(step)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  for (const char* command : commands) {
+    if (args[1] == command) {
+      return false;
+    }
+  }
+  return true;
+}
+
 int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
 {
   // IF YOU ADD A NEW COMMAND, DOCUMENT IT ABOVE and in cmakemain.cxx
@@ -582,6 +679,11 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
       return cmcmd::HandleCoCompileCommands(args);
     }
 
+    // Run a sequence of commands in one process.
+    if (args[1] == "__run_sequence") {
+      return cmcmd::RunSequence(args);
+    }
+
     // Echo string
     if (args[1] == "echo") {
       std::cout << cmJoin(cmMakeRange(args).advance(2), " ") << std::endl;
@@ -956,6 +1058,48 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
       return 1;
     }
 
+    // Internal CMake support for dependencies written by the compiler.
+    if (args[1] == "cmake_depends_compiler" && args.size() == 3) {
+      // Signature:
+      //
+      //   -E cmake_depends_compiler <target-dir>
+      return cmDependsCompiler::UpdateDependencies(args[2], isCMakeVerbose())
+        ? 0
+        : 2;
+    }
+
+#ifdef CMAKE_BUILD_WITH_CMAKE
+    // Internal CMake dependency scanning support for many targets.
+    if (args[1] == "cmake_depends_batch" && args.size() >= 5) {
+      const bool verbose = isCMakeVerbose();
+
+      // Signature:
+      //
+      //   -E cmake_depends_batch <generator>
+      //                          <home-src-dir> <home-out-dir>
+      //                          [--color=$(COLOR)]
+      bool color = false;
+      if (args.size() >= 6 && cmHasLiteralPrefix(args[5], "--color=")) {
+        // Enable or disable color based on the switch value.
+        color =
+          (args[5].size() == 8 || cmSystemTools::IsOn(args[5].substr(8)));
+      }
+
+      // Create a cmake object instance to process dependencies.
+      cmake cm(cmake::RoleScript); // All we need is the `set` command.
+      cm.SetHomeDirectory(cmSystemTools::CollapseFullPath(args[3]));
+      cm.SetHomeOutputDirectory(cmSystemTools::CollapseFullPath(args[4]));
+      cm.GetCurrentSnapshot().SetDefaultDefinitions();
+      if (cmGlobalGenerator* ggd = cm.CreateGlobalGenerator(args[2])) {
+        cm.SetGlobalGenerator(ggd);
+
+        // Actually scan dependencies.
+        return ggd->UpdateDependencies(verbose, color) ? 0 : 2;
+      }
+      return 1;
+    }
+#endif
+
     // Internal CMake link script support.
     if (args[1] == "cmake_link_script" && args.size() >= 3) {
       return cmcmd::ExecuteLinkScript(args);
@@ -1023,6 +1167,7 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
       std::vector<std::string> files;
       std::string mtime;
       std::string format;
+      int threads = 1;
       bool doing_options = true;
       for (std::string::size_type cc = 4; cc < args.size(); cc++) {
         std::string const& arg = args[cc];
@@ -1047,6 +1192,15 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
                                    format.c_str());
               return 1;
             }
+          } else if (cmHasLiteralPrefix(arg, "--threads=")) {
+            long n;
+            if (!cmSystemTools::StringToLong(arg.c_str() + 10, &n) || n < 0 ||
+                n > 1024) {
+              cmSystemTools::Error("Invalid -E tar --threads= argument: ",
+                                   arg.c_str() + 10);
+              return 1;
+            }
+            threads = static_cast<int>(n);
           } else {
             cmSystemTools::Error("Unknown option to -E tar: ", arg.c_str());
             return 1;
@@ -1092,7 +1246,7 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
         }
       } else if (flags.find_first_of('c') != std::string::npos) {
         if (!cmSystemTools::CreateTar(outFile.c_str(), files, compress,
-                                      verbose, mtime, format)) {
+                                      verbose, mtime, format, threads)) {
           cmSystemTools::Error("Problem creating tar: ", outFile.c_str());
           return 1;
         }
@@ -18,7 +18,16 @@ public:
    */
   static int ExecuteCMakeCommand(std::vector<std::string>&);
 
+  /**
+   * Return whether the command needs the location of the cmake
+   * resources, such as its modules and the other tools.
+   */
+  static bool NeedsResources(std::vector<std::string> const& args);
+
 protected:
+  static bool SplitSequence(std::vector<std::string> const& args,
+                            std::vector<std::vector<std::string>>& steps);
+  static int RunSequence(std::vector<std::string> const& args);
   static int HandleCoCompileCommands(std::vector<std::string>& args);
   static int HashSumFile(std::vector<std::string>& args,
                          cmCryptoHash::Algo algo);
@@ -128,6 +128,10 @@ static const char* cmDocumentationOptions[][2] = {
   { "--schedule-random", "Use a random order for scheduling tests" },
   { "--submit-index",
     "Submit individual dashboard tests with specific index" },
+  { "--shard <i>/<N>",
+    "Run only the i-th of N cost-balanced parts of the tests" },
+  { "--merge-results [<dir>...]",
+    "Merge the results of --shard runs into this build tree" },
   { "--timeout <seconds>", "Set a global timeout on all tests." },
   { "--stop-time <time>",
     "Set a time at which all tests should stop running." },
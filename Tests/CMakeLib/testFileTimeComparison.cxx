@@ -0,0 +1,85 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmFileTimeComparison.h"
+#include "cmSystemTools.h"
+
+#include "cmsys/FStream.hxx"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define cmFailed(m)                                                           \
+  std::cout << "FAILED: " << (m) << "\n";                                     \
+  failed = 1
+
+int testFileTimeComparison(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cout << "Usage: testFileTimeComparison <source-dir>\n";
+    return 1;
+  }
+  int failed = 0;
+  std::string const dir = cmSystemTools::GetCurrentWorkingDirectory();
+  std::string const older = dir + "/testFileTimeComparison-older.txt";
+  std::string const newer = dir + "/testFileTimeComparison-newer.txt";
+  std::string const missing = dir + "/testFileTimeComparison-missing.txt";
+  cmSystemTools::RemoveFile(missing);
+  {
+    cmsys::ofstream fout(older.c_str());
+    fout << "older\n";
+  }
+  {
+    cmsys::ofstream fout(newer.c_str());
+    fout << "newer\n";
+  }
+  // Give the older file the time stamp of a file in the source tree.
+  std::string const timeSource = std::string(argv[1]) + "/CMakeLists.txt";
+  cmSystemTools::CopyFileTime(timeSource.c_str(), older.c_str());
+
+  cmFileTimeComparison ftc;
+  cmFileTimeComparison::FilePairs pairs;
+  pairs.emplace_back(older, newer);
+  pairs.emplace_back(newer, older);
+  pairs.emplace_back(newer, newer);
+  pairs.emplace_back(missing, newer);
+  pairs.emplace_back(older, missing);
+  pairs.emplace_back(missing, missing);
+  std::vector<int> results;
+  ftc.FileTimeCompare(pairs, results);
+  std::vector<int> const expect = {
+    -1,
+    1,
+    0,
+    cmFileTimeComparison::FirstMissing,
+    cmFileTimeComparison::SecondMissing,
+    cmFileTimeComparison::FirstMissing,
+  };
+  if (results != expect) {
+    cmFailed("Batch comparison returned unexpected results.");
+  }
+
+  // Single comparisons agree with the batch and do not remember a
+  // missing file.
+  int result = 0;
+  if (!ftc.FileTimeCompare(older.c_str(), newer.c_str(), &result) ||
+      result != -1) {
+    cmFailed("FileTimeCompare disagrees with the batch.");
+  }
+  {
+    cmsys::ofstream fout(missing.c_str());
+    fout << "created\n";
+  }
+  if (!ftc.FileTimeCompare(missing.c_str(), missing.c_str(), &result) ||
+      result != 0) {
+    cmFailed("FileTimeCompare remembered a missing file.");
+  }
+  if (!ftc.FileTimesDiffer(older.c_str(), newer.c_str())) {
+    cmFailed("FileTimesDiffer did not see a difference.");
+  }
+
+  cmSystemTools::RemoveFile(older);
+  cmSystemTools::RemoveFile(newer);
+  cmSystemTools::RemoveFile(missing);
+  return failed;
+}
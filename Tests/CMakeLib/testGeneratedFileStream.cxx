@@ -3,13 +3,86 @@
 #include "cmGeneratedFileStream.h"
 #include "cmSystemTools.h"
 
+#include "cmsys/FStream.hxx"
 #include <iostream>
+#include <sstream>
 #include <string>
 
 #define cmFailed(m1, m2)                                                      \
   std::cout << "FAILED: " << (m1) << (m2) << "\n";                            \
   failed = 1
 
+static std::string readFile(std::string const& name)
+{
+  cmsys::ifstream fin(name.c_str());
+  std::ostringstream content;
+  content << fin.rdbuf();
+  return content.str();
+}
+
+static bool writeFile(std::string const& name, std::string const& content)
+{
+  cmGeneratedFileStream fout(name);
+  fout.SetCopyIfDifferent(true);
+  fout << content;
+  return fout.Close();
+}
+
+static int testDeferredCommit()
+{
+  int failed = 0;
+  std::string const file1 = "generatedDeferred1";
+  std::string const file2 = "generatedDeferred2";
+  if (!writeFile(file1, "old 1")) {
+    cmFailed("New file was not reported replaced: ", file1);
+  }
+  {
+    cmGeneratedFileStream::DeferredCommit deferredCommit(2);
+
+    // An explicit Close replaces the file before it returns.
+    if (writeFile(file1, "old 1")) {
+      cmFailed("Unchanged file was reported replaced: ", file1);
+    }
+    if (!writeFile(file1, "new 1")) {
+      cmFailed("Changed file was not reported replaced: ", file1);
+    }
+    if (readFile(file1) != "new 1") {
+      cmFailed("Close returned before replacing: ", file1);
+    }
+
+    // Streams destroyed without Close are queued.  A later stream for
+    // the same file waits for the queued commit.
+    for (int i = 0; i < 20; ++i) {
+      std::ostringstream content;
+      content << "generation " << i;
+      cmGeneratedFileStream fout(file2);
+      fout.SetCopyIfDifferent(true);
+      fout << content.str();
+    }
+    {
+      cmGeneratedFileStream fout(file1);
+      fout.SetCopyIfDifferent(true);
+      fout << "new 1";
+    }
+    if (writeFile(file2, "generation 19")) {
+      cmFailed("Queued commits were not done in order: ", file2);
+    }
+  }
+  if (readFile(file1) != "new 1") {
+    cmFailed("Queued commit changed unchanged file: ", file1);
+  }
+  if (readFile(file2) != "generation 19") {
+    cmFailed("Queued commits were not done in order: ", file2);
+  }
+  if (cmSystemTools::FileExists(file1 + ".tmp") ||
+      cmSystemTools::FileExists(file2 + ".tmp")) {
+    cmFailed("Queued commit left a temporary file: ", file2 + ".tmp");
+  }
+  cmSystemTools::RemoveFile(file1);
+  cmSystemTools::RemoveFile(file2);
+  return failed;
+}
+
 int testGeneratedFileStream(int /*unused*/, char* /*unused*/ [])
 {
   int failed = 0;
@@ -84,5 +157,9 @@ int testGeneratedFileStream(int /*unused*/, char* /*unused*/ [])
   cmSystemTools::RemoveFile(file3tmp);
   cmSystemTools::RemoveFile(file4tmp);
 
+  if (testDeferredCommit() != 0) {
+    failed = 1;
+  }
+
   return failed;
 }
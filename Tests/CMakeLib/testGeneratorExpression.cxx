@@ -0,0 +1,117 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmGeneratorExpression.h"
+#include "cmGeneratorTarget.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
+#include "cmStateDirectory.h"
+#include "cmStateSnapshot.h"
+#include "cmStateTypes.h"
+#include "cmSystemTools.h"
+#include "cmTarget.h"
+#include "cmake.h"
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#define cmFailed(m1, m2)                                                      \
+  std::cout << "FAILED: " << (m1) << (m2) << "\n";                            \
+  failed = 1
+
+// $<COMPILE_LANGUAGE> is evaluated only for the Makefile and IDE
+// generators.
+class cmTestGlobalGenerator : public cmGlobalGenerator
+{
+public:
+  cmTestGlobalGenerator(cmake* cm)
+    : cmGlobalGenerator(cm)
+  {
+  }
+  std::string GetName() const override { return "Test Makefiles"; }
+};
+
+static int testEvaluationCache(cmMakefile* mf, cmLocalGenerator* lg)
+{
+  int failed = 0;
+  cmTarget* t1 = mf->AddNewTarget(cmStateEnums::UTILITY, "target1");
+  t1->SetProperty("VALUE", "1");
+  cmGeneratorTarget gt1(t1, lg);
+
+  cmGeneratorExpression::SetEvaluationCacheEnabled(true);
+  cmGeneratorExpression::ResetEvaluationStatistics();
+
+  cmGeneratorExpression ge;
+  std::unique_ptr<cmCompiledGeneratorExpression> value =
+    ge.Parse("$<TARGET_PROPERTY:VALUE>");
+  std::string result = value->Evaluate(lg, "", false, &gt1);
+  if (result != "1") {
+    cmFailed("Expected '1' for target1 but got: ", result);
+  }
+  result = value->Evaluate(lg, "", false, &gt1);
+  if (cmGeneratorExpression::GetEvaluationStatistics().CacheHits != 1) {
+    cmFailed("Repeated evaluation was not cached: ", result);
+  }
+
+  // A property change between evaluations is seen.
+  t1->SetProperty("VALUE", "2");
+  result = value->Evaluate(lg, "", false, &gt1);
+  if (result != "2") {
+    cmFailed("Expected '2' after setting VALUE but got: ", result);
+  }
+  t1->AppendProperty("VALUE", "3");
+  result = value->Evaluate(lg, "", false, &gt1);
+  if (result != "2;3") {
+    cmFailed("Expected '2;3' after appending to VALUE but got: ", result);
+  }
+
+  // A target created after the first evaluation has its own result.
+  cmTarget* t2 = mf->AddNewTarget(cmStateEnums::UTILITY, "target2");
+  t2->SetProperty("VALUE", "4");
+  cmGeneratorTarget gt2(t2, lg);
+  result = value->Evaluate(lg, "", false, &gt2);
+  if (result != "4") {
+    cmFailed("Expected '4' for target2 but got: ", result);
+  }
+
+  // The configuration and language are part of the context.
+  std::unique_ptr<cmCompiledGeneratorExpression> context =
+    ge.Parse("$<CONFIG>-$<COMPILE_LANGUAGE>");
+  result = context->Evaluate(lg, "Debug", false, &gt1, nullptr, nullptr, "C");
+  if (result != "Debug-C") {
+    cmFailed("Expected 'Debug-C' but got: ", result);
+  }
+  result =
+    context->Evaluate(lg, "Release", false, &gt1, nullptr, nullptr, "C");
+  if (result != "Release-C") {
+    cmFailed("Expected 'Release-C' but got: ", result);
+  }
+  result =
+    context->Evaluate(lg, "Release", false, &gt1, nullptr, nullptr, "CXX");
+  if (result != "Release-CXX") {
+    cmFailed("Expected 'Release-CXX' but got: ", result);
+  }
+
+  cmGeneratorExpression::SetEvaluationCacheEnabled(false);
+  return failed;
+}
+
+int testGeneratorExpression(int /*unused*/, char* /*unused*/ [])
+{
+  cmake cm(cmake::RoleProject);
+  std::string const cwd = cmSystemTools::GetCurrentWorkingDirectory();
+  cm.SetHomeDirectory(cwd);
+  cm.SetHomeOutputDirectory(cwd);
+  cmGlobalGenerator* gg = new cmTestGlobalGenerator(&cm);
+  cm.SetGlobalGenerator(gg);
+
+  cmStateSnapshot snapshot = cm.GetCurrentSnapshot();
+  snapshot.GetDirectory().SetCurrentSource(cwd);
+  snapshot.GetDirectory().SetCurrentBinary(cwd);
+  snapshot.SetDefaultDefinitions();
+  std::unique_ptr<cmMakefile> mf(new cmMakefile(gg, snapshot));
+  std::unique_ptr<cmLocalGenerator> lg(gg->CreateLocalGenerator(mf.get()));
+
+  return testEvaluationCache(mf.get(), lg.get());
+}
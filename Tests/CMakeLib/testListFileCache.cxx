@@ -0,0 +1,124 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmListFileCache.h"
+#include "cmSystemTools.h"
+
+#include "cmsys/FStream.hxx"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define cmFailed(m)                                                           \
+  std::cout << "FAILED: " << (m) << "\n";                                     \
+  failed = 1
+
+static void writeListFile(std::string const& path, std::string const& content,
+                          std::string const& timeSource)
+{
+  {
+    cmsys::ofstream fout(path.c_str());
+    fout << content;
+  }
+  // Give the file a time stamp old enough to be cached.
+  cmSystemTools::CopyFileTime(timeSource.c_str(), path.c_str());
+}
+
+static bool sameFunctions(std::vector<cmListFileFunction> const& l,
+                          std::vector<cmListFileFunction> const& r)
+{
+  if (l.size() != r.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < l.size(); ++i) {
+    if (l[i].Name.Lower != r[i].Name.Lower ||
+        l[i].Name.Original != r[i].Name.Original || l[i].Line != r[i].Line ||
+        l[i].Arguments != r[i].Arguments) {
+      return false;
+    }
+    for (size_t j = 0; j < l[i].Arguments.size(); ++j) {
+      if (l[i].Arguments[j].Line != r[i].Arguments[j].Line) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int testListFileCache(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::cout << "Usage: testListFileCache <source-dir>\n";
+    return 1;
+  }
+  int failed = 0;
+  std::string const timeSource = std::string(argv[1]) + "/CMakeLists.txt";
+  std::string const listFile =
+    cmSystemTools::GetCurrentWorkingDirectory() + "/testListFileCache.cmake";
+  std::string const cacheFile =
+    cmSystemTools::GetCurrentWorkingDirectory() + "/testListFileCache.bin";
+  cmSystemTools::RemoveFile(cacheFile);
+
+  writeListFile(listFile, "set(a \"b c\")\n", timeSource);
+
+  std::vector<cmListFileFunction> functions(2);
+  functions[0].Name = "Set";
+  functions[0].Line = 1;
+  functions[0].Arguments.emplace_back("a", cmListFileArgument::Unquoted, 1);
+  functions[0].Arguments.emplace_back("b c", cmListFileArgument::Quoted, 1);
+  functions[1].Name = "message";
+  functions[1].Line = 3;
+  functions[1].Arguments.emplace_back("x\n;y", cmListFileArgument::Bracket,
+                                      4);
+
+  {
+    cmListFileCache cache;
+    if (cache.Load(cacheFile)) {
+      cmFailed("Load succeeded without a cache file.");
+    }
+    cache.Store(listFile, functions);
+    if (!cache.Save(cacheFile)) {
+      cmFailed("Save failed.");
+    }
+  }
+
+  {
+    cmListFileCache cache;
+    if (!cache.Load(cacheFile)) {
+      cmFailed("Load failed after Save.");
+    }
+    std::vector<cmListFileFunction> cached;
+    if (!cache.Lookup(listFile, cached)) {
+      cmFailed("Lookup of unchanged list file missed.");
+    } else if (!sameFunctions(functions, cached)) {
+      cmFailed("Lookup returned different functions.");
+    }
+    std::vector<cmListFileFunction> missing;
+    if (cache.Lookup(listFile + ".missing", missing)) {
+      cmFailed("Lookup of unknown list file hit.");
+    }
+
+    writeListFile(listFile, "set(a \"b c d\")\n", timeSource);
+    std::vector<cmListFileFunction> stale;
+    if (cache.Lookup(listFile, stale)) {
+      cmFailed("Lookup of modified list file hit.");
+    }
+  }
+
+  // A corrupt cache file must be rejected.
+  {
+    cmsys::ofstream fout(cacheFile.c_str());
+    fout << "garbage";
+  }
+  {
+    cmListFileCache cache;
+    std::vector<cmListFileFunction> cached;
+    if (cache.Load(cacheFile) || cache.Lookup(listFile, cached)) {
+      cmFailed("Corrupt cache file was accepted.");
+    }
+  }
+
+  cmSystemTools::RemoveFile(listFile);
+  cmSystemTools::RemoveFile(cacheFile);
+  return failed;
+}
@@ -10,6 +10,8 @@
 
 #include "cmSystemTools.h"
 
+#include "cmsys/FStream.hxx"
+
 #define cmPassed(m) std::cout << "Passed: " << (m) << "\n"
 #define cmFailed(m)                                                           \
   std::cout << "FAILED: " << (m) << "\n";                                     \
@@ -91,5 +93,43 @@ int testSystemTools(int /*unused*/, char* /*unused*/ [])
   if (!failed) {
     cmPassed("cmSystemTools::strverscmp working");
   }
+
+  // ----------------------------------------------------------------------
+  // Test the stat cache
+  std::string const dir =
+    cmSystemTools::GetCurrentWorkingDirectory() + "/testStatCache";
+  std::string const file = dir + "/file.txt";
+  std::string const subdir = dir + "/sub";
+  cmSystemTools::RemoveADirectory(dir);
+  cmSystemTools::MakeDirectory(dir);
+  cmSystemTools::SetStatCacheEnabled(true);
+  cmSystemTools::ResetStatCacheStatistics();
+  cmAssert(!cmSystemTools::FileExists(file), "stat cache missing file");
+  {
+    // Write behind the cache's back.
+    cmsys::ofstream fout(file.c_str());
+    fout << "content\n";
+  }
+  cmAssert(!cmSystemTools::FileExists(file), "stat cache remembers result");
+  cmAssert(cmSystemTools::GetStatCacheStatistics().Hits == 1,
+           "stat cache counts hits");
+  cmSystemTools::InvalidateStatCache(file);
+  cmAssert(cmSystemTools::FileExists(file, true),
+           "stat cache explicit invalidation");
+  cmAssert(!cmSystemTools::FileIsDirectory(subdir),
+           "stat cache missing directory");
+  cmSystemTools::MakeDirectory(subdir);
+  cmAssert(cmSystemTools::FileIsDirectory(subdir),
+           "stat cache MakeDirectory invalidation");
+  cmSystemTools::RemoveADirectory(dir);
+  cmAssert(!cmSystemTools::FileExists(file) &&
+             !cmSystemTools::FileIsDirectory(subdir),
+           "stat cache RemoveADirectory invalidation");
+  {
+    cmSystemTools::StatCacheBypass bypass;
+    cmAssert(!cmSystemTools::GetStatCacheEnabled(), "stat cache bypass");
+  }
+  cmAssert(cmSystemTools::GetStatCacheEnabled(), "stat cache bypass end");
+  cmSystemTools::SetStatCacheEnabled(false);
   return failed;
 }
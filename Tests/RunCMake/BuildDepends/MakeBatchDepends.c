@@ -0,0 +1,6 @@
+#include "MakeBatchDepends.h"
+
+int main(void)
+{
+  return MakeBatchDepends();
+}
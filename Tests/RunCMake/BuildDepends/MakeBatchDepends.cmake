@@ -0,0 +1,38 @@
+enable_language(C)
+set(CMAKE_DEPENDS_BATCH_SCAN 1)
+include_directories(${CMAKE_CURRENT_BINARY_DIR})
+
+# Scanned in the batch.
+add_executable(batched MakeBatchDepends.c)
+
+# Scanned by its own depend step after generating its header.
+add_custom_command(
+  OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/MakeBatchDependsGen.h
+  COMMAND ${CMAKE_COMMAND} -E copy
+          ${CMAKE_CURRENT_BINARY_DIR}/MakeBatchDependsGen.h.in
+          ${CMAKE_CURRENT_BINARY_DIR}/MakeBatchDependsGen.h
+  DEPENDS ${CMAKE_CURRENT_BINARY_DIR}/MakeBatchDependsGen.h.in
+  )
+add_executable(generated MakeBatchDependsGen.c
+  ${CMAKE_CURRENT_BINARY_DIR}/MakeBatchDependsGen.h)
+
+file(GENERATE OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/check-$<LOWER_CASE:$<CONFIG>>.cmake CONTENT "
+set(check_pairs
+  \"$<TARGET_FILE:batched>|${CMAKE_CURRENT_BINARY_DIR}/MakeBatchDepends.h\"
+  \"$<TARGET_FILE:generated>|${CMAKE_CURRENT_BINARY_DIR}/MakeBatchDependsGen.h\"
+  )
+set(check_exes
+  \"$<TARGET_FILE:batched>\"
+  \"$<TARGET_FILE:generated>\"
+  )
+file(STRINGS \"${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/batched.dir/build.make\"
+  batched_depend REGEX \"cmake_depends \")
+if(batched_depend)
+  set(RunCMake_TEST_FAILED \"Target 'batched' has its own depend step:\\n \${batched_depend}\")
+endif()
+file(STRINGS \"${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/generated.dir/build.make\"
+  generated_depend REGEX \"cmake_depends \")
+if(NOT generated_depend)
+  set(RunCMake_TEST_FAILED \"Target 'generated' has no depend step.\")
+endif()
+")
@@ -0,0 +1,6 @@
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeBatchDepends.h" [[
+static int MakeBatchDepends(void) { return 1; }
+]])
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeBatchDependsGen.h.in" [[
+static int MakeBatchDependsGen(void) { return 1; }
+]])
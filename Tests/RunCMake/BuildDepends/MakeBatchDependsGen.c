@@ -0,0 +1,6 @@
+#include "MakeBatchDependsGen.h"
+
+int main(void)
+{
+  return MakeBatchDependsGen();
+}
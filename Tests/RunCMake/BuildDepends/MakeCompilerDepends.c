@@ -0,0 +1,6 @@
+#include "MakeCompilerDepends.h"
+
+int main(void)
+{
+  return MakeCompilerDepends();
+}
@@ -0,0 +1,25 @@
+enable_language(C)
+set(CMAKE_DEPENDS_USE_COMPILER 1)
+include_directories(${CMAKE_CURRENT_BINARY_DIR})
+add_executable(main MakeCompilerDepends.c)
+
+# Sources are not scanned if the compiler writes the dependencies.
+set(check_depend "")
+if(CMAKE_C_DEPFILE_FORMAT STREQUAL "gcc")
+  set(check_depend "
+file(STRINGS \"${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/main.dir/build.make\"
+  main_depend REGEX \"cmake_depends \")
+if(main_depend)
+  set(RunCMake_TEST_FAILED \"Target 'main' scans its sources:\\n \${main_depend}\")
+endif()
+")
+endif()
+
+file(GENERATE OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/check-$<LOWER_CASE:$<CONFIG>>.cmake CONTENT "
+set(check_pairs
+  \"$<TARGET_FILE:main>|${CMAKE_CURRENT_BINARY_DIR}/MakeCompilerDepends.h\"
+  )
+set(check_exes
+  \"$<TARGET_FILE:main>\"
+  )
+${check_depend}")
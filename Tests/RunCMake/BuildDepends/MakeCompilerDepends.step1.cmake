@@ -0,0 +1,7 @@
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeCompilerDepends.h" [[
+#include "MakeCompilerDependsOld.h"
+static int MakeCompilerDepends(void) { return MakeCompilerDependsOld(); }
+]])
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeCompilerDependsOld.h" [[
+static int MakeCompilerDependsOld(void) { return 1; }
+]])
@@ -0,0 +1,5 @@
+# The build must not fail on the removed header.
+file(REMOVE "${RunCMake_TEST_BINARY_DIR}/MakeCompilerDependsOld.h")
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeCompilerDepends.h" [[
+static int MakeCompilerDepends(void) { return 2; }
+]])
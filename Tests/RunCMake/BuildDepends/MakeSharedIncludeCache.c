@@ -0,0 +1,6 @@
+#include "SharedInclude.h"
+
+int main(void)
+{
+  return SHARED_INCLUDE;
+}
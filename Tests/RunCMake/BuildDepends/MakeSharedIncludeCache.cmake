@@ -0,0 +1,25 @@
+enable_language(C)
+include_directories(${CMAKE_CURRENT_BINARY_DIR})
+add_executable(SharedInclude1 MakeSharedIncludeCache.c)
+add_executable(SharedInclude2 MakeSharedIncludeCache.c)
+add_dependencies(SharedInclude2 SharedInclude1)
+
+file(GENERATE OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/check-$<LOWER_CASE:$<CONFIG>>.cmake CONTENT "
+set(check_pairs
+  \"$<TARGET_FILE:SharedInclude1>|${CMAKE_CURRENT_BINARY_DIR}/SharedInclude.h\"
+  \"$<TARGET_FILE:SharedInclude2>|${CMAKE_CURRENT_BINARY_DIR}/SharedInclude.h\"
+  )
+set(check_exes
+  \"$<TARGET_FILE:SharedInclude1>\"
+  \"$<TARGET_FILE:SharedInclude2>\"
+  )
+
+# The edited header includes another header now.  Both targets
+# must have scanned it again rather than reuse the shared result.
+foreach(t SharedInclude1 SharedInclude2)
+  file(READ \"${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/\${t}.dir/depend.make\" depends)
+  if(NOT depends MATCHES \"SharedInclude\${check_step}.h\")
+    string(APPEND RunCMake_TEST_FAILED \"\${t} does not depend on SharedInclude\${check_step}.h:\\n\${depends}\\n\")
+  endif()
+endforeach()
+")
@@ -0,0 +1,11 @@
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/SharedInclude1.h" [[
+#define SHARED_INCLUDE 1
+]])
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/SharedInclude2.h" [[
+#define SHARED_INCLUDE 2
+]])
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/SharedInclude.h" [[
+#include "SharedInclude1.h"
+]])
+# Make the headers old enough to be recorded in the shared cache.
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep ${fs_delay})
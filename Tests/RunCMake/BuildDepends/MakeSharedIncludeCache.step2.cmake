@@ -0,0 +1,4 @@
+# Keep the size of the header so only its time stamp changes.
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/SharedInclude.h" [[
+#include "SharedInclude2.h"
+]])
@@ -46,6 +46,9 @@ run_BuildDepends(Custom-Always)
 
 if(RunCMake_GENERATOR MATCHES "Make")
   run_BuildDepends(MakeCustomIncludes)
+  run_BuildDepends(MakeBatchDepends)
+  run_BuildDepends(MakeCompilerDepends)
+  run_BuildDepends(MakeSharedIncludeCache)
   if(NOT "${RunCMake_BINARY_DIR}" STREQUAL "${RunCMake_SOURCE_DIR}")
     run_BuildDepends(MakeInProjectOnly)
   endif()
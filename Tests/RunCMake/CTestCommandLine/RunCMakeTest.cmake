@@ -93,6 +93,71 @@ add_test(Echo \"${CMAKE_COMMAND}\" -E echo \"EchoTest\")
 endfunction()
 run_SerialFailed()
 
+function(run_CriticalPath)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/CriticalPath)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  # Each test uses both slots so the tests run one at a time in the
+  # order chosen by the scheduler.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(Short \"${CMAKE_COMMAND}\" -E echo \"Short\")
+add_test(ChainA \"${CMAKE_COMMAND}\" -E echo \"ChainA\")
+add_test(ChainB \"${CMAKE_COMMAND}\" -E echo \"ChainB\")
+add_test(Long \"${CMAKE_COMMAND}\" -E echo \"Long\")
+add_test(ChainC \"${CMAKE_COMMAND}\" -E echo \"ChainC\")
+set_tests_properties(Short PROPERTIES COST 1 PROCESSORS 2)
+set_tests_properties(ChainA PROPERTIES COST 1 PROCESSORS 2)
+set_tests_properties(ChainB PROPERTIES COST 2 PROCESSORS 2 DEPENDS ChainA)
+set_tests_properties(ChainC PROPERTIES COST 5 PROCESSORS 2 DEPENDS ChainB)
+set_tests_properties(Long PROPERTIES COST 10 PROCESSORS 2)
+")
+  run_cmake_command(CriticalPath ${CMAKE_CTEST_COMMAND} -j2)
+endfunction()
+run_CriticalPath()
+
+function(run_DisabledSetup)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/DisabledSetup)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  # The setup test finishes without starting, which must still release
+  # the tests that require its fixture.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(Setup \"${CMAKE_COMMAND}\" -E echo \"Setup\")
+add_test(UseA \"${CMAKE_COMMAND}\" -E echo \"UseA\")
+add_test(UseB \"${CMAKE_COMMAND}\" -E echo \"UseB\")
+set_tests_properties(Setup PROPERTIES DISABLED 1 FIXTURES_SETUP Fix)
+set_tests_properties(UseA UseB PROPERTIES FIXTURES_REQUIRED Fix)
+")
+  run_cmake_command(DisabledSetup ${CMAKE_CTEST_COMMAND} -j2)
+endfunction()
+run_DisabledSetup()
+
+function(run_Shard)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Shard)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(Big \"${CMAKE_COMMAND}\" -E echo \"Big\")
+add_test(DepA \"${CMAKE_COMMAND}\" -E echo \"DepA\")
+add_test(DepB \"${CMAKE_COMMAND}\" -E echo \"DepB\")
+add_test(Small1 \"${CMAKE_COMMAND}\" -E echo \"Small1\")
+add_test(Small2 \"${CMAKE_COMMAND}\" -E echo \"Small2\")
+set_tests_properties(Big PROPERTIES COST 10)
+set_tests_properties(DepA PROPERTIES COST 3)
+set_tests_properties(DepB PROPERTIES COST 3 DEPENDS DepA)
+set_tests_properties(Small1 PROPERTIES COST 2)
+set_tests_properties(Small2 PROPERTIES COST 2)
+")
+  run_cmake_command(Shard-bad ${CMAKE_CTEST_COMMAND} --shard 3/2)
+  run_cmake_command(Shard-1 ${CMAKE_CTEST_COMMAND} --shard 1/2)
+  run_cmake_command(Shard-2 ${CMAKE_CTEST_COMMAND} --shard 2/2)
+  run_cmake_command(Shard-merge ${CMAKE_CTEST_COMMAND} --merge-results)
+endfunction()
+run_Shard()
+
 function(run_TestLoad name load)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestLoad)
   set(RunCMake_TEST_NO_CLEAN 1)
@@ -0,0 +1,10 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/LastTest.log" log)
+foreach(test Big DepA DepB Small1 Small2)
+  if(NOT log MATCHES "Test: ${test}\n")
+    string(APPEND RunCMake_TEST_FAILED "LastTest.log does not contain ${test}\n")
+  endif()
+endforeach()
+file(READ "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestCostData.txt" cost)
+if(NOT cost MATCHES "Big 1 [0-9.e-]+\n.*Small2 1 [0-9.e-]+\n---\n$")
+  string(APPEND RunCMake_TEST_FAILED "CTestCostData.txt not merged:\n${cost}")
+endif()
@@ -27,6 +27,11 @@ run_cmake_command(E___run_co_compile-bad-iwyu ${CMAKE_COMMAND} -E __run_co_compi
 run_cmake_command(E___run_co_compile-no--- ${CMAKE_COMMAND} -E __run_co_compile --iwyu=iwyu-does-not-exist command-does-not-exist)
 run_cmake_command(E___run_co_compile-no-cc ${CMAKE_COMMAND} -E __run_co_compile --iwyu=iwyu-does-not-exist --)
 
+run_cmake_command(E___run_sequence ${CMAKE_COMMAND} -E __run_sequence -E echo "hello  world" -E echo_append a -E echo b)
+run_cmake_command(E___run_sequence-fail ${CMAKE_COMMAND} -E __run_sequence -E echo a -E compare_files ${CMAKE_CURRENT_LIST_FILE} ${CMAKE_CURRENT_LIST_DIR}/CMakeLists.txt -E echo b)
+run_cmake_command(E___run_sequence-no-E ${CMAKE_COMMAND} -E __run_sequence echo a)
+run_cmake_command(E___run_sequence-nested ${CMAKE_COMMAND} -E __run_sequence -E __run_sequence -E echo a)
+
 run_cmake_command(G_no-arg ${CMAKE_COMMAND} -G)
 run_cmake_command(G_bad-arg ${CMAKE_COMMAND} -G NoSuchGenerator)
 run_cmake_command(P_no-arg ${CMAKE_COMMAND} -P)
@@ -347,6 +352,15 @@ set(RunCMake_TEST_OPTIONS --trace-source=trace-only-this-file.cmake)
 run_cmake(trace-source)
 unset(RunCMake_TEST_OPTIONS)
 
+set(RunCMake_TEST_OPTIONS
+  --profiling-output=${RunCMake_BINARY_DIR}/profiling.json
+  --profiling-summary=${RunCMake_BINARY_DIR}/profiling.txt
+  )
+run_cmake(profiling)
+unset(RunCMake_TEST_OPTIONS)
+
+run_cmake_command(profiling-bad-arg ${CMAKE_COMMAND} --profiling-output=)
+
 set(RunCMake_TEST_OPTIONS --debug-trycompile)
 run_cmake(debug-trycompile)
 unset(RunCMake_TEST_OPTIONS)
@@ -0,0 +1,44 @@
+set(trace_file ${RunCMake_BINARY_DIR}/profiling.json)
+set(summary_file ${RunCMake_BINARY_DIR}/profiling.txt)
+
+if(NOT EXISTS "${trace_file}")
+  set(RunCMake_TEST_FAILED "Profiling output not written:\n  ${trace_file}")
+  return()
+endif()
+file(READ "${trace_file}" trace)
+if(NOT trace MATCHES "^\\[.*\\]\n$")
+  set(RunCMake_TEST_FAILED "Profiling output is not a JSON array:\n${trace}")
+  return()
+endif()
+foreach(expect
+    [["name":"configure"]]
+    [["name":"generate"]]
+    [["name":"profiling_macro"]]
+    [["location":"[^"]*/profiling.cmake:7"]]
+    [["location":"[^"]*/profiling-include.cmake:1"]]
+    [["functionArgs":"[^"]*/profiling-include.cmake"]]
+    )
+  if(NOT trace MATCHES "${expect}")
+    set(RunCMake_TEST_FAILED
+      "Profiling output does not match\n  ${expect}\nin:\n${trace}")
+    return()
+  endif()
+endforeach()
+
+if(NOT EXISTS "${summary_file}")
+  set(RunCMake_TEST_FAILED "Profiling summary not written:\n  ${summary_file}")
+  return()
+endif()
+file(READ "${summary_file}" summary)
+foreach(expect
+    "\n +[0-9.]+ +[0-9.]+ +1  configure\n"
+    "\n +[0-9.]+ +[0-9.]+ +2  profiling_function\n"
+    "\n +[0-9.]+ +[0-9.]+ +1  profiling_macro\n"
+    "\n +[0-9.]+ +[0-9.]+ +[0-9]+  [^\n]*/profiling-include.cmake\n"
+    )
+  if(NOT summary MATCHES "${expect}")
+    set(RunCMake_TEST_FAILED
+      "Profiling summary does not match\n  ${expect}\nin:\n${summary}")
+    return()
+  endif()
+endforeach()
@@ -0,0 +1 @@
+profiling_function()
@@ -0,0 +1,8 @@
+function(profiling_function)
+  set(x 1)
+endfunction()
+macro(profiling_macro)
+  profiling_function()
+endmacro()
+profiling_macro()
+include(${CMAKE_CURRENT_LIST_DIR}/profiling-include.cmake)
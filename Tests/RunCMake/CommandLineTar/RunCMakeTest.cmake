@@ -15,6 +15,7 @@ external_command_test(end-opt1   tar cvf bad.tar -- --bad)
 external_command_test(end-opt2   tar cvf bad.tar --)
 external_command_test(mtime      tar cvf bad.tar "--mtime=1970-01-01 00:00:00 UTC")
 external_command_test(bad-format tar cvf bad.tar "--format=bad-format")
+external_command_test(bad-threads tar cvzf bad.tar --threads=bad .)
 external_command_test(zip-bz2    tar cvjf bad.tar "--format=zip")
 external_command_test(7zip-gz    tar cvzf bad.tar "--format=7zip")
 
@@ -25,4 +26,6 @@ run_cmake(pax)
 run_cmake(pax-xz)
 run_cmake(paxr)
 run_cmake(paxr-bz2)
+run_cmake(threads-gz)
+run_cmake(threads-xz)
 run_cmake(zip)
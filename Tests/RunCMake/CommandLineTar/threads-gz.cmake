@@ -0,0 +1,11 @@
+set(OUTPUT_NAME "test.tar.gz")
+
+set(COMPRESSION_FLAGS cvzf)
+set(COMPRESSION_OPTIONS --threads=4)
+set(DOUBLINGS 8)
+
+set(DECOMPRESSION_FLAGS xvzf)
+
+include(${CMAKE_CURRENT_LIST_DIR}/threads.cmake)
+
+check_magic("1f8b" LIMIT 2 HEX)
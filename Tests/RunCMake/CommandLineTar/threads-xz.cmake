@@ -0,0 +1,11 @@
+set(OUTPUT_NAME "test.tar.xz")
+
+set(COMPRESSION_FLAGS cvJf)
+set(COMPRESSION_OPTIONS --threads=4)
+set(DOUBLINGS 12)
+
+set(DECOMPRESSION_FLAGS xvJf)
+
+include(${CMAKE_CURRENT_LIST_DIR}/threads.cmake)
+
+check_magic("fd377a585a00" LIMIT 6 HEX)
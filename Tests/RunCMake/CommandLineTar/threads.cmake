@@ -0,0 +1,28 @@
+# Compress more than one block of data on several threads.  The blocks
+# are 1 MiB for gzip and 24 MiB for xz.  The content starts at about
+# 9 KB and is doubled DOUBLINGS times.
+set(content "")
+foreach(i RANGE 1 2000)
+  string(APPEND content "${i} ")
+endforeach()
+foreach(i RANGE 1 ${DOUBLINGS})
+  string(APPEND content "${content}")
+endforeach()
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/compress_dir/big.txt "${content}")
+
+include(${CMAKE_CURRENT_LIST_DIR}/roundtrip.cmake)
+
+file(MD5 ${FULL_COMPRESS_DIR}/big.txt input_md5)
+file(MD5 ${FULL_DECOMPRESS_DIR}/${COMPRESS_DIR}/big.txt output_md5)
+if(NOT input_md5 STREQUAL output_md5)
+  message(SEND_ERROR "Large file was not extracted correctly")
+endif()
+
+# The archive does not depend on the number of threads.
+run_tar(${CMAKE_CURRENT_BINARY_DIR} ${COMPRESSION_FLAGS}
+  ${FULL_OUTPUT_NAME}.2 --threads=2 ${COMPRESS_DIR})
+file(SHA256 ${FULL_OUTPUT_NAME} hash4)
+file(SHA256 ${FULL_OUTPUT_NAME}.2 hash2)
+if(NOT hash4 STREQUAL hash2)
+  message(SEND_ERROR "Archives compressed on 4 and 2 threads differ")
+endif()
@@ -0,0 +1,26 @@
+file(GLOB_RECURSE files RELATIVE "${RunCMake_TEST_BINARY_DIR}"
+  "${RunCMake_TEST_BINARY_DIR}/sub*/*")
+if(NOT files)
+  set(RunCMake_TEST_FAILED "No files were generated in subdirectories.")
+  return()
+endif()
+
+# Generating again gives the same content.  Files that are replaced only
+# if different keep their time stamps.  The rest are written every time.
+set(changed "")
+foreach(f IN LISTS files)
+  file(SHA256 "${RunCMake_TEST_BINARY_DIR}/${f}" hash)
+  set(state "${hash}")
+  if(NOT f MATCHES "/(progress\\.marks|progress\\.make|cmake_clean\\.cmake)$")
+    file(TIMESTAMP "${RunCMake_TEST_BINARY_DIR}/${f}" time "%s")
+    string(APPEND state " ${time}")
+  endif()
+  if(NOT DEFINED "RegenerateUnchanged_${f}")
+    set("RegenerateUnchanged_${f}" "${state}" PARENT_SCOPE)
+  elseif(NOT state STREQUAL "${RegenerateUnchanged_${f}}")
+    string(APPEND changed "\n  ${f}")
+  endif()
+endforeach()
+if(changed)
+  set(RunCMake_TEST_FAILED "Generating again changed:${changed}")
+endif()
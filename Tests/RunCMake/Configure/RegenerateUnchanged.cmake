@@ -0,0 +1,3 @@
+foreach(sub sub1 sub2 sub3)
+  add_subdirectory(RegenerateUnchanged ${sub})
+endforeach()
@@ -33,3 +33,14 @@ file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
 run_cmake(RemoveCache)
 file(REMOVE "${RunCMake_TEST_BINARY_DIR}/CMakeCache.txt")
 run_cmake(RemoveCache)
+
+# Generate twice into one build tree.  Nothing changes the second time.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/RegenerateUnchanged-build)
+set(RunCMake_TEST_NO_CLEAN 1)
+file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+run_cmake(RegenerateUnchanged)
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1) # handle 1s resolution
+run_cmake(RegenerateUnchanged)
+unset(RunCMake_TEST_BINARY_DIR)
+unset(RunCMake_TEST_NO_CLEAN)
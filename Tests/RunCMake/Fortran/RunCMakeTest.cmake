@@ -0,0 +1,48 @@
+include(RunCMake)
+
+# The scan cache is kept by the Makefile generators in fortran.scan and by
+# the Ninja generator in the .ddi files.  Only the former is checked here.
+if(RunCMake_GENERATOR MATCHES "Make")
+  function(run_ScanCache)
+    set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ScanCache-build)
+    set(scan ${RunCMake_TEST_BINARY_DIR}/CMakeFiles/main.dir/fortran.scan)
+    run_cmake(ScanCache)
+    set(RunCMake_TEST_NO_CLEAN 1)
+    set(RunCMake_TEST_OUTPUT_MERGE 1)
+    run_cmake_command(ScanCache-build ${CMAKE_COMMAND} --build .)
+
+    # Add a requirement to the cached result of main.f90.  It stays only
+    # as long as the result is reused instead of scanning the file again.
+    macro(mark_scan)
+      file(READ "${scan}" content)
+      string(REGEX REPLACE "(source [^\n]*/main.f90\n)"
+        "\\1 requires scan_cache_marker\n" content "${content}")
+      file(WRITE "${scan}" "${content}")
+      execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1.125)
+    endmacro()
+
+    # Touching the source scans the target again but its content and
+    # includes are unchanged.
+    mark_scan()
+    file(TOUCH ${RunCMake_TEST_BINARY_DIR}/main.f90)
+    set(expect_scan "requires scan_cache_marker")
+    run_cmake_command(ScanCache-reuse ${CMAKE_COMMAND} --build .)
+
+    # Editing the included file invalidates the result.
+    file(APPEND ${RunCMake_TEST_BINARY_DIR}/inc2/body.inc
+      "  print *, value_a\n")
+    set(expect_scan "requires mod_a")
+    set(reject_scan "scan_cache_marker")
+    run_cmake_command(ScanCache-edit ${CMAKE_COMMAND} --build .)
+
+    # A file of the same name in an earlier include directory shadows the
+    # one included before.
+    mark_scan()
+    file(WRITE ${RunCMake_TEST_BINARY_DIR}/inc1/body.inc
+      "  use mod_b\n  print *, value_b\n")
+    file(TOUCH ${RunCMake_TEST_BINARY_DIR}/main.f90)
+    set(expect_scan "requires mod_b")
+    run_cmake_command(ScanCache-shadow ${CMAKE_COMMAND} --build .)
+  endfunction()
+  run_ScanCache()
+endif()
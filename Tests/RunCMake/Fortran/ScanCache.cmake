@@ -0,0 +1,25 @@
+enable_language(Fortran)
+
+# The sources live in the build tree so the test can edit them.
+set(src ${CMAKE_CURRENT_BINARY_DIR})
+file(WRITE ${src}/main.f90 [[
+program main
+  include 'body.inc'
+end program
+]])
+file(WRITE ${src}/mods.f90 [[
+module mod_a
+  integer, parameter :: value_a = 1
+end module
+module mod_b
+  integer, parameter :: value_b = 2
+end module
+]])
+file(MAKE_DIRECTORY ${src}/inc1)
+file(WRITE ${src}/inc2/body.inc [[
+  use mod_a
+  print *, value_a
+]])
+
+include_directories(${src}/inc1 ${src}/inc2)
+add_executable(main ${src}/main.f90 ${src}/mods.f90)
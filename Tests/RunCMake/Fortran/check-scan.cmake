@@ -0,0 +1,21 @@
+set(scan ${RunCMake_TEST_BINARY_DIR}/CMakeFiles/main.dir/fortran.scan)
+if(NOT EXISTS "${scan}")
+  set(RunCMake_TEST_FAILED "Scan cache not found:\n  ${scan}")
+  return()
+endif()
+file(READ "${scan}" content)
+foreach(expect IN LISTS expect_scan)
+  if(NOT content MATCHES "${expect}")
+    string(APPEND RunCMake_TEST_FAILED
+      "Scan cache does not match:\n  ${expect}\n")
+  endif()
+endforeach()
+foreach(reject IN LISTS reject_scan)
+  if(content MATCHES "${reject}")
+    string(APPEND RunCMake_TEST_FAILED
+      "Scan cache unexpectedly matches:\n  ${reject}\n")
+  endif()
+endforeach()
+if(RunCMake_TEST_FAILED)
+  string(APPEND RunCMake_TEST_FAILED "Scan cache content:\n${content}")
+endif()
@@ -0,0 +1,10 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/EvaluationCache-generated.txt" content)
+
+set(expected "target1_value
+target2_value
+target1_value
+target3_value
+")
+if(NOT content STREQUAL expected)
+  set(RunCMake_TEST_FAILED "actual content:\n [[${content}]]\nbut expected:\n [[${expected}]]")
+endif()
@@ -0,0 +1,17 @@
+cmake_policy(VERSION 3.11)
+
+# The same expression evaluated for different targets gives each its
+# own result.
+set(value "$<TARGET_PROPERTY:VALUE>")
+foreach(t target1 target2 target3)
+  add_custom_target(${t})
+  set_property(TARGET ${t} PROPERTY VALUE "${t}_value")
+  set_property(TARGET ${t} PROPERTY EVAL "${value}")
+endforeach()
+
+file(GENERATE OUTPUT "EvaluationCache-generated.txt" CONTENT
+"$<TARGET_GENEX_EVAL:target1,$<TARGET_PROPERTY:target1,EVAL>>
+$<TARGET_GENEX_EVAL:target2,$<TARGET_PROPERTY:target2,EVAL>>
+$<TARGET_GENEX_EVAL:target1,$<TARGET_PROPERTY:target1,EVAL>>
+$<TARGET_GENEX_EVAL:target3,$<TARGET_PROPERTY:target3,EVAL>>
+")
@@ -0,0 +1,3 @@
+set(CMAKE_NINJA_DIRECTORY_BUILD_FILES ON)
+add_subdirectory(DirectoryBuildFiles)
+add_custom_target(top ALL COMMAND ${CMAKE_COMMAND} -E touch top.stamp)
@@ -173,6 +173,47 @@ function(touch path)
   endif()
 endfunction(touch)
 
+function(run_DirectoryBuildFiles)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/DirectoryBuildFiles-build)
+  run_cmake(DirectoryBuildFiles)
+  file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" build_ninja)
+  if(NOT build_ninja MATCHES "\nsubninja CMakeFiles[/\\]directory\\.ninja\n# Content hash: [0-9a-f]+\nsubninja DirectoryBuildFiles[/\\]CMakeFiles[/\\]directory\\.ninja\n")
+    message(FATAL_ERROR
+      "build.ninja does not include the directory build files.")
+  endif()
+  run_ninja("${RunCMake_TEST_BINARY_DIR}")
+  foreach(stamp top.stamp DirectoryBuildFiles/sub.stamp)
+    if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/${stamp}")
+      message(FATAL_ERROR "Building did not create ${stamp}.")
+    endif()
+  endforeach()
+
+  # Regenerating without changes must not replace the directory files.
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(DirectoryBuildFiles-regenerate1 ${CMAKE_COMMAND} .)
+  set(files "${RunCMake_TEST_BINARY_DIR}/DirectoryBuildFiles/CMakeFiles/directory.ninja")
+  if(NOT ninja_version VERSION_LESS 1.8)
+    # The main build files are kept too when Ninja supports restat on them.
+    list(APPEND files
+      "${RunCMake_TEST_BINARY_DIR}/build.ninja"
+      "${RunCMake_TEST_BINARY_DIR}/rules.ninja"
+      )
+  endif()
+  foreach(f IN LISTS files)
+    file(TIMESTAMP "${f}" "before_${f}" "%Y-%m-%dT%H:%M:%S" UTC)
+  endforeach()
+  sleep(1)
+  run_cmake_command(DirectoryBuildFiles-regenerate2 ${CMAKE_COMMAND} .)
+  foreach(f IN LISTS files)
+    file(TIMESTAMP "${f}" after "%Y-%m-%dT%H:%M:%S" UTC)
+    if(NOT after STREQUAL "${before_${f}}")
+      message(FATAL_ERROR
+        "Regeneration replaced the unchanged file\n  ${f}")
+    endif()
+  endforeach()
+endfunction()
+run_DirectoryBuildFiles()
+
 macro(ninja_escape_path path out)
   string(REPLACE "\$ " "\$\$" "${out}" "${path}")
   string(REPLACE " " "\$ " "${out}" "${${out}}")
@@ -21,3 +21,10 @@ set(RunCMake_TEST_NO_CLEAN 1)
 run_cmake_command(AssigningMultipleTargets-build ${CMAKE_COMMAND} --build .)
 unset(RunCMake_TEST_BINARY_DIR)
 unset(RunCMake_TEST_NO_CLEAN)
+
+run_cmake(ShellOperator)
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ShellOperator-build)
+set(RunCMake_TEST_NO_CLEAN 1)
+run_cmake_command(ShellOperator-build ${CMAKE_COMMAND} --build .)
+unset(RunCMake_TEST_BINARY_DIR)
+unset(RunCMake_TEST_NO_CLEAN)
@@ -0,0 +1,6 @@
+foreach(f a b c d f)
+  if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/${f}.txt")
+    set(RunCMake_TEST_FAILED "${f}.txt was not created by the custom commands")
+    return()
+  endif()
+endforeach()
@@ -0,0 +1,12 @@
+# Adjacent "cmake -E" steps are merged into one process, but not when a
+# step uses a shell operator, which would then apply to the merged steps.
+add_custom_target(ShellOperator ALL
+  COMMAND ${CMAKE_COMMAND} -E touch a.txt || echo failed
+  COMMAND ${CMAKE_COMMAND} -E touch b.txt
+  COMMAND ${CMAKE_COMMAND} -E touch c.txt
+  VERBATIM
+  )
+add_custom_target(ShellOperatorOldStyle ALL
+  COMMAND ${CMAKE_COMMAND} -E touch d.txt && echo done
+  COMMAND ${CMAKE_COMMAND} -E touch f.txt
+  )
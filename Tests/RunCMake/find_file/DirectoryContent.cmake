@@ -0,0 +1,42 @@
+set(dir "${CMAKE_CURRENT_BINARY_DIR}/dc")
+file(MAKE_DIRECTORY "${dir}")
+file(WRITE "${dir}/old.h" "")
+if(EXISTS "${dir}/new.h")
+  set(expect "${dir}/new.h")
+else()
+  set(expect "NEW_FILE-NOTFOUND")
+endif()
+
+# Look up names in the directory, then create one of the files that
+# was missing.  Lookups must not be answered from a stale listing.
+unset(OLD_FILE CACHE)
+unset(NEW_FILE CACHE)
+find_file(OLD_FILE NAMES old.h PATHS "${dir}" NO_DEFAULT_PATH)
+find_file(NEW_FILE NAMES new.h PATHS "${dir}" NO_DEFAULT_PATH)
+if(NOT OLD_FILE STREQUAL "${dir}/old.h")
+  message(FATAL_ERROR "old.h not found: ${OLD_FILE}")
+endif()
+if(NOT NEW_FILE STREQUAL "${expect}")
+  message(FATAL_ERROR "new.h expected '${expect}' but got '${NEW_FILE}'")
+endif()
+
+unset(ADDED_FILE CACHE)
+file(REMOVE "${dir}/added.h")
+find_file(ADDED_FILE NAMES added.h PATHS "${dir}" NO_DEFAULT_PATH)
+file(WRITE "${dir}/added.h" "")
+unset(ADDED_FILE CACHE)
+find_file(ADDED_FILE NAMES added.h PATHS "${dir}" NO_DEFAULT_PATH)
+if(NOT ADDED_FILE STREQUAL "${dir}/added.h")
+  message(FATAL_ERROR "added.h not found: ${ADDED_FILE}")
+endif()
+
+# Files created by other processes are seen too.
+unset(CHILD_FILE CACHE)
+file(REMOVE "${dir}/child.h")
+find_file(CHILD_FILE NAMES child.h PATHS "${dir}" NO_DEFAULT_PATH)
+execute_process(COMMAND ${CMAKE_COMMAND} -E touch "${dir}/child.h")
+unset(CHILD_FILE CACHE)
+find_file(CHILD_FILE NAMES child.h PATHS "${dir}" NO_DEFAULT_PATH)
+if(NOT CHILD_FILE STREQUAL "${dir}/child.h")
+  message(FATAL_ERROR "child.h not found: ${CHILD_FILE}")
+endif()
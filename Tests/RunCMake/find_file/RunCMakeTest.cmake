@@ -3,3 +3,12 @@ include(RunCMake)
 if(WIN32 OR CYGWIN)
   run_cmake(PrefixInPATH)
 endif()
+
+# Configure again after adding a file to a directory listed before.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/DirectoryContent-build)
+run_cmake(DirectoryContent)
+set(RunCMake_TEST_NO_CLEAN 1)
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/dc/new.h" "")
+run_cmake_command(DirectoryContent-rerun ${CMAKE_COMMAND} .)
+unset(RunCMake_TEST_NO_CLEAN)
+unset(RunCMake_TEST_BINARY_DIR)
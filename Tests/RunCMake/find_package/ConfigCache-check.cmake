@@ -0,0 +1,7 @@
+set(prefix "${RunCMake_BINARY_DIR}/ConfigCache-prefix")
+file(STRINGS "${RunCMake_BINARY_DIR}/ConfigCache.txt" configs
+  REGEX "^config ")
+list(FIND configs "config ${prefix}/lib/cmake/Foo-1.0/FooConfig.cmake" i)
+if(i EQUAL -1)
+  set(RunCMake_TEST_FAILED "Cache file does not list Foo-1.0:\n${configs}")
+endif()
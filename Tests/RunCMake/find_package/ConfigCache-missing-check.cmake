@@ -0,0 +1,5 @@
+file(STRINGS "${RunCMake_BINARY_DIR}/ConfigCache.txt" keys REGEX "^key ")
+list(FILTER keys INCLUDE REGEX " 0$")
+if(NOT keys)
+  set(RunCMake_TEST_FAILED "Cache file does not store the failed search")
+endif()
@@ -0,0 +1,5 @@
+file(TIMESTAMP ${cache_file} cache_file_after "%Y-%m-%dT%H:%M:%S" UTC)
+if(NOT cache_file_after STREQUAL cache_file_before)
+  set(RunCMake_TEST_FAILED
+    "Configuring without changed searches rewrote\n  ${cache_file}")
+endif()
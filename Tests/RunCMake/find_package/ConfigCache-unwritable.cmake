@@ -0,0 +1 @@
+include(ConfigCache.cmake)
@@ -0,0 +1,6 @@
+# Search again even though Foo_DIR is in the cache of the last run.
+unset(Foo_DIR CACHE)
+find_package(Foo ${Foo_REQUEST} EXACT CONFIG QUIET
+  PATHS "${ConfigCache_PREFIX}" NO_DEFAULT_PATH)
+string(REPLACE "${ConfigCache_PREFIX}" "<prefix>" config "${Foo_CONFIG}")
+message(STATUS "Foo_CONFIG='${config}' Foo_VERSION='${Foo_VERSION}'")
@@ -23,3 +23,66 @@ run_cmake(PolicyPop)
 run_cmake(SetFoundFALSE)
 run_cmake(WrongVersion)
 run_cmake(WrongVersionConfig)
+
+function(write_foo_config version)
+  set(dir ${RunCMake_BINARY_DIR}/ConfigCache-prefix/lib/cmake/Foo-${version})
+  if(ARGN)
+    set(dir ${ARGN})
+  endif()
+  file(WRITE ${dir}/FooConfig.cmake "")
+  file(WRITE ${dir}/FooConfigVersion.cmake "
+set(PACKAGE_VERSION ${version})
+if(PACKAGE_FIND_VERSION VERSION_EQUAL PACKAGE_VERSION)
+  set(PACKAGE_VERSION_EXACT 1)
+endif()
+")
+endfunction()
+
+# Searches for configuration files are reused in later runs.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ConfigCache-build)
+set(RunCMake_TEST_OPTIONS
+  -DCMAKE_FIND_PACKAGE_CACHE_FILE=${RunCMake_BINARY_DIR}/ConfigCache.txt
+  -DConfigCache_PREFIX=${RunCMake_BINARY_DIR}/ConfigCache-prefix
+  -DFoo_REQUEST=1.0
+  )
+file(REMOVE_RECURSE ${RunCMake_BINARY_DIR}/ConfigCache-prefix)
+file(REMOVE ${RunCMake_BINARY_DIR}/ConfigCache.txt)
+write_foo_config(1.0)
+write_foo_config(0.9)
+# Results are not stored for directories modified in the same second.
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1.125)
+run_cmake(ConfigCache)
+unset(RunCMake_TEST_OPTIONS)
+set(RunCMake_TEST_NO_CLEAN 1)
+run_cmake_command(ConfigCache-warm ${CMAKE_COMMAND} .)
+# A stored search is replayed: point its result at a file that a search
+# would not find, without touching the searched directories.
+set(cache_file ${RunCMake_BINARY_DIR}/ConfigCache.txt)
+set(elsewhere ${RunCMake_BINARY_DIR}/ConfigCache-prefix-elsewhere)
+write_foo_config(1.0 ${elsewhere})
+file(READ ${cache_file} content)
+string(REPLACE
+  "${RunCMake_BINARY_DIR}/ConfigCache-prefix/lib/cmake/Foo-1.0/FooConfig.cmake"
+  "${elsewhere}/FooConfig.cmake" content "${content}")
+file(WRITE ${cache_file} "${content}")
+# The file is not written again when no search changed.
+file(TIMESTAMP ${cache_file} cache_file_before "%Y-%m-%dT%H:%M:%S" UTC)
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1.125)
+run_cmake_command(ConfigCache-replay ${CMAKE_COMMAND} .)
+# A search that found nothing is searched again once a directory it
+# looked into changes, with the same request.
+run_cmake_command(ConfigCache-missing ${CMAKE_COMMAND} -DFoo_REQUEST=2.0 .)
+write_foo_config(2.0)
+run_cmake_command(ConfigCache-new ${CMAKE_COMMAND} .)
+unset(RunCMake_TEST_NO_CLEAN)
+unset(RunCMake_TEST_BINARY_DIR)
+
+# A cache file that cannot be written is skipped quietly.
+file(WRITE ${RunCMake_BINARY_DIR}/ConfigCache-not-a-directory "")
+set(RunCMake_TEST_OPTIONS
+  -DCMAKE_FIND_PACKAGE_CACHE_FILE=${RunCMake_BINARY_DIR}/ConfigCache-not-a-directory/ConfigCache.txt
+  -DConfigCache_PREFIX=${RunCMake_BINARY_DIR}/ConfigCache-prefix
+  -DFoo_REQUEST=1.0
+  )
+run_cmake(ConfigCache-unwritable)
+unset(RunCMake_TEST_OPTIONS)
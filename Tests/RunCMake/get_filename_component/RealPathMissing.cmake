@@ -0,0 +1,12 @@
+# The real path of a file that does not exist is the path itself.
+set(missing "${CMAKE_CURRENT_BINARY_DIR}/does-not-exist/file.txt")
+get_filename_component(real "${missing}" REALPATH)
+if(NOT real STREQUAL missing)
+  message(SEND_ERROR "REALPATH of missing file: got \"${real}\", not \"${missing}\"")
+endif()
+
+# A second query of the same path gives the same result.
+get_filename_component(real "${missing}" REALPATH)
+if(NOT real STREQUAL missing)
+  message(SEND_ERROR "REALPATH of missing file again: got \"${real}\"")
+endif()
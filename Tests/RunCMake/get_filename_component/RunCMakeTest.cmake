@@ -1,4 +1,5 @@
 include(RunCMake)
 
 run_cmake(KnownComponents)
+run_cmake(RealPathMissing)
 run_cmake(UnknownComponent)
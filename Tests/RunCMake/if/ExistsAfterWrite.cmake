@@ -0,0 +1,32 @@
+set(dir "${CMAKE_CURRENT_BINARY_DIR}/ExistsAfterWrite")
+file(REMOVE_RECURSE "${dir}")
+file(MAKE_DIRECTORY "${dir}")
+
+function(check_exists name)
+  if(NOT EXISTS "${dir}/${name}")
+    message(SEND_ERROR "${name} was written but does not exist")
+  endif()
+endfunction()
+
+# Query each path while it is missing, then write it in a way that does
+# not name file() directly.
+function(write_through_function name)
+  file(WRITE "${dir}/${name}" "")
+endfunction()
+macro(write_through_macro name)
+  configure_file("${CMAKE_CURRENT_LIST_FILE}" "${dir}/${name}" COPYONLY)
+endmacro()
+
+foreach(name function.txt macro.txt child.txt)
+  if(EXISTS "${dir}/${name}")
+    message(FATAL_ERROR "${name} exists before it was written")
+  endif()
+endforeach()
+file(READ "${CMAKE_CURRENT_LIST_FILE}" content LIMIT 1)
+
+write_through_function(function.txt)
+check_exists(function.txt)
+write_through_macro(macro.txt)
+check_exists(macro.txt)
+execute_process(COMMAND ${CMAKE_COMMAND} -E touch "${dir}/child.txt")
+check_exists(child.txt)
@@ -3,6 +3,7 @@ include(RunCMake)
 run_cmake(InvalidArgument1)
 run_cmake(IsDirectory)
 run_cmake(IsDirectoryLong)
+run_cmake(ExistsAfterWrite)
 run_cmake(duplicate-deep-else)
 run_cmake(duplicate-else)
 run_cmake(duplicate-else-after-elseif)
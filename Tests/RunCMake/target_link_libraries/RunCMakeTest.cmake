@@ -18,4 +18,7 @@ run_cmake(Separate-PRIVATE-LINK_PRIVATE-uses)
 run_cmake(SharedDepNotTarget)
 run_cmake(StaticPrivateDepNotExported)
 run_cmake(StaticPrivateDepNotTarget)
+if(RunCMake_GENERATOR MATCHES "Make")
+  run_cmake(StaticDiamondCycle)
+endif()
 run_cmake(UNKNOWN-IMPORTED-GLOBAL)
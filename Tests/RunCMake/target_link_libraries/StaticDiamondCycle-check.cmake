@@ -0,0 +1,16 @@
+# The link lines are those computed before interfaces were shared
+# between consumers.
+set(expect_main1 "A B C D E D E D E F")
+set(expect_main2 "C B F D E D E D E")
+set(expect_main3 "E F A B C F E D E D E D")
+
+foreach(exe main1 main2 main3)
+  file(READ "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/${exe}.dir/link.txt" link)
+  string(REGEX MATCHALL "lib[A-F]\\.a" libs "${link}")
+  string(REGEX REPLACE "lib([A-F])\\.a" "\\1" libs "${libs}")
+  string(REPLACE ";" " " libs "${libs}")
+  if(NOT libs STREQUAL "${expect_${exe}}")
+    string(APPEND RunCMake_TEST_FAILED
+      "${exe} links\n  ${libs}\nbut expected\n  ${expect_${exe}}\n")
+  endif()
+endforeach()
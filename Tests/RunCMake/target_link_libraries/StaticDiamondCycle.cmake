@@ -0,0 +1,25 @@
+enable_language(C)
+
+foreach(lib A B C D E F)
+  add_library(${lib} STATIC IMPORTED)
+  set_property(TARGET ${lib} PROPERTY
+    IMPORTED_LOCATION "${CMAKE_CURRENT_BINARY_DIR}/lib${lib}.a")
+endforeach()
+
+# A diamond: A needs B and C, which both need D.
+set_property(TARGET A PROPERTY INTERFACE_LINK_LIBRARIES B C)
+set_property(TARGET B PROPERTY INTERFACE_LINK_LIBRARIES D)
+set_property(TARGET C PROPERTY INTERFACE_LINK_LIBRARIES D F)
+
+# A cycle: D and E need each other.
+set_property(TARGET D PROPERTY INTERFACE_LINK_LIBRARIES E)
+set_property(TARGET E PROPERTY INTERFACE_LINK_LIBRARIES D)
+set_property(TARGET E PROPERTY IMPORTED_LINK_INTERFACE_MULTIPLICITY 3)
+
+# Several consumers share the link interfaces of the libraries.
+add_executable(main1 empty.c)
+target_link_libraries(main1 A)
+add_executable(main2 empty.c)
+target_link_libraries(main2 C B)
+add_executable(main3 empty.c)
+target_link_libraries(main3 E F A)
@@ -0,0 +1,65 @@
+enable_language(C)
+cmake_policy(SET CMP0056 NEW)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/bad.c "does-not-compile\n")
+
+# Simple probes are built directly by the compiler and linker rules
+# where these are known to be supported.
+set(direct 0)
+if(CMAKE_GENERATOR MATCHES "Makefiles|Ninja" AND NOT APPLE AND NOT WIN32 AND
+    CMAKE_C_COMPILER_ID MATCHES "^(GNU|Clang)$")
+  set(direct 1)
+endif()
+
+macro(check_probe name expect_result expect_direct)
+  if(${expect_result} AND NOT ${name})
+    message(SEND_ERROR "try_compile ${name} failed:\n${out}")
+  elseif(NOT ${expect_result} AND ${name})
+    message(SEND_ERROR "try_compile ${name} passed but should have failed")
+  endif()
+  if(direct AND ${expect_direct} AND out MATCHES "Run Build Command")
+    message(SEND_ERROR "try_compile ${name} generated a build system:\n${out}")
+  elseif(NOT ${expect_direct} AND NOT out MATCHES "Run Build Command")
+    message(SEND_ERROR "try_compile ${name} was built directly:\n${out}")
+  endif()
+endmacro()
+
+try_compile(exe ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  COMPILE_DEFINITIONS -DDIRECT=1
+  CMAKE_FLAGS -DINCLUDE_DIRECTORIES=${CMAKE_CURRENT_SOURCE_DIR}
+  OUTPUT_VARIABLE out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy
+  )
+check_probe(exe 1 1)
+if(direct AND NOT out MATCHES "-DDIRECT=1")
+  message(SEND_ERROR "try_compile did not pass the definition:\n${out}")
+endif()
+
+try_compile(bad ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_BINARY_DIR}/bad.c
+  OUTPUT_VARIABLE out
+  )
+check_probe(bad 0 1)
+
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+try_compile(static ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/other.c
+  OUTPUT_VARIABLE out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy_static
+  )
+check_probe(static 1 1)
+unset(CMAKE_TRY_COMPILE_TARGET_TYPE)
+
+# Probes the rules cannot reproduce keep the generated build system.
+try_compile(config ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  CMAKE_FLAGS -DCMAKE_BUILD_TYPE=Release
+  OUTPUT_VARIABLE out
+  )
+check_probe(config 1 0)
+
+try_compile(two ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c ${CMAKE_CURRENT_SOURCE_DIR}/other.c
+  OUTPUT_VARIABLE out
+  )
+check_probe(two 1 0)
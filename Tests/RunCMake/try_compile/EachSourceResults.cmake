@@ -0,0 +1,28 @@
+enable_language(C)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/bad.c "does-not-compile\n")
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/good.c "int main(void) { return 1; }\n")
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES
+    ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+    ${CMAKE_CURRENT_BINARY_DIR}/bad.c
+    ${CMAKE_CURRENT_BINARY_DIR}/good.c
+  EACH_SOURCE_RESULTS src_result bad_result good_result
+  OUTPUT_VARIABLE out
+  )
+if(result)
+  message(FATAL_ERROR "try_compile succeeded although bad.c does not compile")
+endif()
+if(NOT src_result OR NOT good_result)
+  message(FATAL_ERROR "try_compile failed for a valid source:\n${out}")
+endif()
+if(bad_result)
+  message(FATAL_ERROR "try_compile succeeded for bad.c:\n${out}")
+endif()
+
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c ${CMAKE_CURRENT_BINARY_DIR}/good.c
+  EACH_SOURCE_RESULTS src_result good_result
+  )
+if(NOT result OR NOT src_result OR NOT good_result)
+  message(FATAL_ERROR "try_compile failed for valid sources")
+endif()
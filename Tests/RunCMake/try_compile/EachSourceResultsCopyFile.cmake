@@ -0,0 +1,6 @@
+enable_language(C)
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  EACH_SOURCE_RESULTS src_result
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy
+  )
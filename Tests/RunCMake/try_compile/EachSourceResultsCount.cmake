@@ -0,0 +1,5 @@
+enable_language(C)
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c ${CMAKE_CURRENT_SOURCE_DIR}/other.c
+  EACH_SOURCE_RESULTS src_result
+  )
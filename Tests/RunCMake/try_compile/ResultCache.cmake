@@ -0,0 +1,66 @@
+enable_language(C)
+set(CMAKE_TRY_COMPILE_CACHE_DIR ${CMAKE_CURRENT_BINARY_DIR}/tc-cache)
+file(REMOVE_RECURSE ${CMAKE_TRY_COMPILE_CACHE_DIR})
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/bad.c "does-not-compile\n")
+
+foreach(pass first second)
+  try_compile(src_${pass} ${CMAKE_CURRENT_BINARY_DIR}
+    SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+    OUTPUT_VARIABLE src_out_${pass}
+    )
+  try_compile(bad_${pass} ${CMAKE_CURRENT_BINARY_DIR}
+    SOURCES ${CMAKE_CURRENT_BINARY_DIR}/bad.c
+    OUTPUT_VARIABLE bad_out_${pass}
+    )
+endforeach()
+if(NOT src_first OR NOT src_second OR bad_first OR bad_second)
+  message(FATAL_ERROR "try_compile results differ from the expected ones")
+endif()
+if(src_out_first MATCHES "Loaded try_compile result")
+  message(FATAL_ERROR "try_compile loaded a result from an empty cache")
+endif()
+if(NOT src_out_second MATCHES "Loaded try_compile result")
+  message(FATAL_ERROR "try_compile did not load its cached result:\n"
+    "${src_out_second}")
+endif()
+if(bad_out_second MATCHES "Loaded try_compile result")
+  message(FATAL_ERROR "try_compile loaded a cached failure:\n"
+    "${bad_out_second}")
+endif()
+
+# Probes of a batch share cache entries with equal single probes, and
+# failures are checked again.
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c ${CMAKE_CURRENT_BINARY_DIR}/bad.c
+  EACH_SOURCE_RESULTS src_result bad_result
+  OUTPUT_VARIABLE out
+  )
+if(result OR NOT src_result OR bad_result)
+  message(FATAL_ERROR "try_compile EACH_SOURCE_RESULTS results differ")
+endif()
+string(REGEX MATCHALL "Loaded try_compile result" loaded "${out}")
+list(LENGTH loaded loaded_count)
+if(NOT loaded_count EQUAL 1)
+  message(FATAL_ERROR "try_compile EACH_SOURCE_RESULTS did not load only "
+    "the successful result from the cache:\n${out}")
+endif()
+
+# A changed source gets a new entry.
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/bad.c "int main(void) { return 0; }\n")
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_BINARY_DIR}/bad.c
+  OUTPUT_VARIABLE out
+  )
+if(NOT result OR out MATCHES "Loaded try_compile result")
+  message(FATAL_ERROR "try_compile used the result of a changed source")
+endif()
+
+# Defining the variable empty disables the cache.
+set(CMAKE_TRY_COMPILE_CACHE_DIR "")
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out
+  )
+if(NOT result OR out MATCHES "Loaded try_compile result")
+  message(FATAL_ERROR "try_compile used a disabled cache")
+endif()
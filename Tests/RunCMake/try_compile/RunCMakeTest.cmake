@@ -25,6 +25,12 @@ run_cmake(TargetTypeExe)
 run_cmake(TargetTypeInvalid)
 run_cmake(TargetTypeStatic)
 
+run_cmake(EachSourceResults)
+run_cmake(EachSourceResultsCount)
+run_cmake(EachSourceResultsCopyFile)
+run_cmake(ResultCache)
+run_cmake(DirectCompile)
+
 if(CMAKE_C_STANDARD_DEFAULT)
   run_cmake(CStandard)
 elseif(DEFINED CMAKE_C_STANDARD_DEFAULT)
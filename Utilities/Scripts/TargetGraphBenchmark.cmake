@@ -0,0 +1,102 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+# Generate a project with a large synthetic target dependency graph to
+# measure the cost of computing inter-target and link dependencies
+# during the generate step.
+#
+# Invoke in script mode, defining these variables:
+#
+# DIR - the directory in which to write the project (required)
+# TARGETS - the number of libraries (default 1000)
+# DEPS - the number of libraries each library links (default 10)
+# EXECUTABLES - the number of executables (default TARGETS / 10)
+# SHARED_EVERY - make every N-th library shared, or 0 for none (default 0)
+# SEED - seed of the pseudo-random edge choice (default 1)
+#
+# Each library links DEPS libraries chosen among the ones before it,
+# half of them privately, so the graph is acyclic with dense transitive
+# closures.  Each executable links DEPS libraries chosen among all of
+# them.  Then time the generate step, for example:
+#
+#   cmake -DDIR=/tmp/graph -DTARGETS=12000 -P TargetGraphBenchmark.cmake
+#   cmake -S /tmp/graph -B /tmp/graph/build --profiling-summary=summary.txt
+
+if(NOT DIR)
+  message(FATAL_ERROR "Define DIR to the directory of the project.")
+endif()
+if(NOT DEFINED TARGETS)
+  set(TARGETS 1000)
+endif()
+if(NOT DEFINED DEPS)
+  set(DEPS 10)
+endif()
+if(NOT DEFINED EXECUTABLES)
+  math(EXPR EXECUTABLES "${TARGETS} / 10")
+endif()
+if(NOT DEFINED SHARED_EVERY)
+  set(SHARED_EVERY 0)
+endif()
+if(NOT DEFINED SEED)
+  set(SEED 1)
+endif()
+
+# Linear congruential generator with the constants used by many C
+# runtime libraries.  Sets the variable named by _out to a number in
+# [0, _bound).
+set(_state ${SEED})
+macro(_next_random _bound _out)
+  math(EXPR _state "(${_state} * 1103515245 + 12345) % 2147483648")
+  math(EXPR ${_out} "(${_state} / 65536) % ${_bound}")
+endmacro()
+
+file(WRITE "${DIR}/empty.c" "int empty(void) { return 0; }\n")
+file(WRITE "${DIR}/main.c" "int main(void) { return 0; }\n")
+
+set(_code "cmake_minimum_required(VERSION 3.12)
+project(TargetGraphBenchmark C)
+")
+
+math(EXPR _last "${TARGETS} - 1")
+foreach(i RANGE 0 ${_last})
+  set(_type STATIC)
+  if(SHARED_EVERY GREATER 0)
+    math(EXPR _rem "${i} % ${SHARED_EVERY}")
+    if(_rem EQUAL 0)
+      set(_type SHARED)
+    endif()
+  endif()
+  string(APPEND _code "add_library(lib${i} ${_type} empty.c)\n")
+  if(i GREATER 0)
+    set(_public "")
+    set(_private "")
+    foreach(d RANGE 1 ${DEPS})
+      _next_random(${i} _dep)
+      math(EXPR _half "${d} % 2")
+      if(_half)
+        string(APPEND _public " lib${_dep}")
+      else()
+        string(APPEND _private " lib${_dep}")
+      endif()
+    endforeach()
+    string(APPEND _code
+      "target_link_libraries(lib${i} PUBLIC${_public} PRIVATE${_private})\n")
+  endif()
+endforeach()
+
+if(EXECUTABLES GREATER 0)
+  math(EXPR _last "${EXECUTABLES} - 1")
+  foreach(i RANGE 0 ${_last})
+    set(_libs "")
+    foreach(d RANGE 1 ${DEPS})
+      _next_random(${TARGETS} _dep)
+      string(APPEND _libs " lib${_dep}")
+    endforeach()
+    string(APPEND _code "add_executable(exe${i} main.c)\n"
+      "target_link_libraries(exe${i}${_libs})\n")
+  endforeach()
+endif()
+
+file(WRITE "${DIR}/CMakeLists.txt" "${_code}")
+message(STATUS "Wrote ${TARGETS} libraries and ${EXECUTABLES} executables "
+  "to ${DIR}")